@@ -0,0 +1,87 @@
+#include <benchmark.hpp>
+
+#include <eosio/chain/abi_serializer.hpp>
+#include <eosio/chain/contract_types.hpp>
+#include <eosio/testing/tester.hpp>
+#include <contracts.hpp>
+
+#include <fc/io/json.hpp>
+
+namespace eosio::benchmark {
+
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+namespace {
+
+struct transfer_args {
+   name        from;
+   name        to;
+   asset       quantity;
+   std::string memo;
+};
+
+struct voteproducer_args {
+   name              voter;
+   name              proxy;
+   std::vector<name> producers;
+};
+
+} // namespace
+
+} // eosio::benchmark
+
+FC_REFLECT( eosio::benchmark::transfer_args, (from)(to)(quantity)(memo) )
+FC_REFLECT( eosio::benchmark::voteproducer_args, (voter)(proxy)(producers) )
+
+namespace eosio::benchmark {
+
+namespace {
+
+const fc::microseconds max_serialization_time = fc::seconds( 10 );
+
+abi_def parse_abi( const std::vector<char>& json ) {
+   return fc::json::from_string( std::string( json.begin(), json.end() ) ).as<abi_def>();
+}
+
+void abi_benchmarking( const std::string& label, const abi_serializer& abis, const std::string& type, const bytes& data ) {
+   const auto yield = abi_serializer::create_yield_function( max_serialization_time );
+   const fc::variant var = abis.binary_to_variant( type, data, yield );
+
+   benchmarking( label + " binary_to_variant", [&]() {
+      abis.binary_to_variant( type, data, yield );
+   } );
+   benchmarking( label + " variant_to_binary", [&]() {
+      abis.variant_to_binary( type, var, yield );
+   } );
+}
+
+} // namespace
+
+void abi_serializer_benchmarking() {
+   const auto yield = abi_serializer::create_yield_function( max_serialization_time );
+   const abi_def token_abi = parse_abi( contracts::eosio_token_abi() );
+   const abi_def system_abi = parse_abi( contracts::eosio_system_abi() );
+
+   benchmarking( "eosio.system abi_serializer", [&]() {
+      abi_serializer abis( system_abi, yield );
+   } );
+
+   const abi_serializer token( token_abi, yield );
+   const abi_serializer system( system_abi, yield );
+
+   abi_benchmarking( "eosio.token::transfer", token, token.get_action_type( "transfer"_n ),
+                     fc::raw::pack( transfer_args{ "alice"_n, "bob"_n, asset::from_string( "1.0000 TOK" ), "memo" } ) );
+
+   const authority auth( base_tester::get_public_key( "alice"_n, "active" ) );
+   abi_benchmarking( "eosio::newaccount", system, system.get_action_type( "newaccount"_n ),
+                     fc::raw::pack( newaccount{ "alice"_n, "bob"_n, auth, auth } ) );
+
+   std::vector<name> producers;
+   for( uint64_t i = 0; i < 30; ++i )
+      producers.emplace_back( "producer"_n.to_uint64_t() + i );
+   abi_benchmarking( "eosio::voteproducer", system, system.get_action_type( "voteproducer"_n ),
+                     fc::raw::pack( voteproducer_args{ "alice"_n, name(), producers } ) );
+}
+
+} // eosio::benchmark
@@ -0,0 +1,51 @@
+#include <benchmark.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace eosio::benchmark {
+
+static uint32_t runs = 1000;
+
+void set_num_runs( uint32_t n ) {
+   runs = std::max<uint32_t>( n, 1 );
+}
+
+uint32_t num_runs() {
+   return runs;
+}
+
+void print_header() {
+   std::cout << std::left << std::setw( 40 ) << "function"
+             << std::right << std::setw( 12 ) << "runs"
+             << std::setw( 16 ) << "min ns/op"
+             << std::setw( 16 ) << "avg ns/op"
+             << std::setw( 16 ) << "max ns/op" << std::endl;
+}
+
+void benchmarking( const std::string& name, const std::function<void()>& func, uint64_t ops,
+                   const std::function<void()>& untimed ) {
+   using clock = std::chrono::steady_clock;
+   double min_ns = std::numeric_limits<double>::max(), max_ns = 0, total_ns = 0;
+
+   for( uint32_t i = 0; i < runs; ++i ) {
+      const auto start = clock::now();
+      func();
+      const double ns = std::chrono::duration<double, std::nano>( clock::now() - start ).count() / ops;
+      min_ns = std::min( min_ns, ns );
+      max_ns = std::max( max_ns, ns );
+      total_ns += ns;
+      if( untimed ) untimed();
+   }
+
+   std::cout << std::left << std::setw( 40 ) << name
+             << std::right << std::setw( 12 ) << runs
+             << std::fixed << std::setprecision( 1 )
+             << std::setw( 16 ) << min_ns
+             << std::setw( 16 ) << total_ns / runs
+             << std::setw( 16 ) << max_ns << std::endl;
+}
+
+} // eosio::benchmark
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace eosio::benchmark {
+
+void set_num_runs( uint32_t runs );
+uint32_t num_runs();
+
+void print_header();
+
+/**
+ * Runs func num_runs() times and prints the minimum, average and maximum time of a run. ops is the number of
+ * operations a single run performs, results are reported per operation. untimed, if set, runs after each run of
+ * func without being measured.
+ */
+void benchmarking( const std::string& name, const std::function<void()>& func, uint64_t ops = 1,
+                   const std::function<void()>& untimed = {} );
+
+void abi_serializer_benchmarking();
+void eosvmoc_memory_benchmarking();
+void sha256_batch_benchmarking();
+void token_transfer_benchmarking();
+
+} // eosio::benchmark
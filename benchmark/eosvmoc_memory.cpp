@@ -0,0 +1,40 @@
+#include <benchmark.hpp>
+
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+
+#include <eosio/chain/webassembly/eos-vm-oc/memory.hpp>
+
+namespace eosio::benchmark {
+
+using namespace eosio::chain;
+
+void eosvmoc_memory_benchmarking() {
+   eosvmoc::memory mem( wasm_constraints::maximum_linear_memory / wasm_constraints::wasm_page_size );
+   uint8_t* const base = mem.full_page_memory_base();
+
+   // an execution touches some of the 4KiB pages of its footprint, the reset after it and the page faults of the next
+   // execution touching them again are timed together
+   for( uint64_t pages : { 1, 4, 16, 32, 64, 128 } ) {
+      for( uint64_t stride : { 4096, 64 * 1024 } ) {
+         auto touch = [&]() {
+            for( uint64_t offset = 0; offset < pages * wasm_constraints::wasm_page_size; offset += stride )
+               base[offset] = 1;
+         };
+         const std::string what = std::to_string( pages ) + " pages, every " + std::to_string( stride / 1024 ) + "KiB";
+         mem.release_linear_memory( pages );
+         benchmarking( "memset " + what, [&]() {
+            touch();
+            mem.zero_linear_memory( pages );
+         } );
+         mem.release_linear_memory( pages );
+         benchmarking( "punch hole " + what, [&]() {
+            touch();
+            mem.release_linear_memory( pages );
+         } );
+      }
+   }
+}
+
+} // eosio::benchmark
+
+#endif
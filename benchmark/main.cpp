@@ -0,0 +1,70 @@
+#include <benchmark.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <map>
+
+namespace bpo = boost::program_options;
+using bpo::options_description;
+using bpo::variables_map;
+
+std::map<std::string, std::function<void()>> features {
+   { "abi_serializer", eosio::benchmark::abi_serializer_benchmarking },
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+   { "eosvmoc_memory", eosio::benchmark::eosvmoc_memory_benchmarking },
+#endif
+   { "sha256_batch", eosio::benchmark::sha256_batch_benchmarking },
+   { "token_transfer", eosio::benchmark::token_transfer_benchmarking },
+};
+
+int main( int argc, char* argv[] ) {
+   uint32_t num_runs = 1;
+   std::string feature_name;
+
+   auto features_str = std::string{};
+   for( const auto& [name, f] : features ) {
+      features_str += "  " + name + "\n";
+   }
+
+   options_description cli( "benchmark command line options" );
+   cli.add_options()
+      ( "feature,f", bpo::value<std::string>(), ( "feature to be benchmarked, all features when not set. Available:\n" + features_str ).c_str() )
+      ( "runs,r", bpo::value<uint32_t>()->default_value( 1000 ), "the number of times running a function during benchmarking" )
+      ( "help,h", "benchmark functions, and report the minimum, average and maximum time per operation" );
+
+   variables_map vmap;
+   try {
+      bpo::store( bpo::parse_command_line( argc, argv, cli ), vmap );
+      bpo::notify( vmap );
+
+      if( vmap.count( "help" ) ) {
+         cli.print( std::cout );
+         return 0;
+      }
+      if( vmap.count( "feature" ) ) {
+         feature_name = vmap["feature"].as<std::string>();
+         if( features.find( feature_name ) == features.end() ) {
+            std::cerr << "unknown feature: " << feature_name << std::endl;
+            return 1;
+         }
+      }
+      num_runs = vmap["runs"].as<uint32_t>();
+   } catch( const bpo::error& e ) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+   }
+
+   eosio::benchmark::set_num_runs( num_runs );
+   eosio::benchmark::print_header();
+
+   for( const auto& [name, f] : features ) {
+      if( feature_name.empty() || feature_name == name ) {
+         std::cout << name << ":" << std::endl;
+         f();
+         std::cout << std::endl;
+      }
+   }
+
+   return 0;
+}
@@ -0,0 +1,49 @@
+#include <benchmark.hpp>
+
+#include <eosio/chain/merkle.hpp>
+#include <eosio/chain/sha256_batch.hpp>
+
+#include <vector>
+
+namespace eosio::benchmark {
+
+using namespace eosio::chain;
+
+void sha256_batch_benchmarking() {
+   constexpr size_t num_msgs = 4096;
+
+   // 64 bytes is a merkle node, ~42 bytes a transaction receipt, larger sizes approach transaction ids
+   for( size_t msg_size : { 42, 64, 256, 1024 } ) {
+      std::vector<char> data( num_msgs * msg_size );
+      for( size_t i = 0; i < data.size(); ++i ) data[i] = char( i * 31 );
+      std::vector<sha256_batch_input> inputs( num_msgs );
+      for( size_t i = 0; i < num_msgs; ++i ) inputs[i] = { data.data() + i * msg_size, msg_size };
+      std::vector<fc::sha256> out( num_msgs );
+
+      for( auto impl : { sha256_batch_impl::scalar, sha256_batch_impl::avx2, sha256_batch_impl::sha_ni } ) {
+         if( !sha256_batch_supported( impl ) ) continue;
+         benchmarking( std::string( "sha256 " ) + to_string( impl ) + " " + std::to_string( msg_size ) + " bytes",
+                       [&]() { sha256_batch( inputs.data(), num_msgs, out.data(), impl ); },
+                       num_msgs );
+      }
+   }
+
+   std::vector<digest_type> leaves( num_msgs );
+   for( size_t i = 0; i < num_msgs; ++i ) leaves[i] = digest_type::hash( i );
+
+   benchmarking( "merkle " + std::to_string( num_msgs ) + " leaves (" + to_string( sha256_batch_best_impl() ) + ")",
+                 [&]() { merkle( leaves ); },
+                 num_msgs );
+
+   benchmarking( "merkle " + std::to_string( num_msgs ) + " leaves (scalar)", [&]() {
+      std::vector<digest_type> level = leaves;
+      while( level.size() > 1 ) {
+         if( level.size() % 2 ) level.push_back( level.back() );
+         for( size_t i = 0; i < level.size() / 2; ++i )
+            level[i] = digest_type::hash( make_canonical_pair( level[2 * i], level[2 * i + 1] ) );
+         level.resize( level.size() / 2 );
+      }
+   }, num_msgs );
+}
+
+} // eosio::benchmark
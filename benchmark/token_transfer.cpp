@@ -0,0 +1,104 @@
+#include <benchmark.hpp>
+
+#include <eosio/testing/tester.hpp>
+#include <contracts.hpp>
+
+#include <vector>
+
+namespace eosio::benchmark {
+
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+namespace {
+
+struct transfer_args {
+   name        from;
+   name        to;
+   asset       quantity;
+   std::string memo;
+};
+
+} // namespace
+
+} // eosio::benchmark
+
+FC_REFLECT( eosio::benchmark::transfer_args, (from)(to)(quantity)(memo) )
+
+namespace eosio::benchmark {
+
+namespace {
+
+// transfers per transaction, enough that the per-transaction overhead is small compared to the actions
+constexpr uint32_t transfers_per_trx = 100;
+// a block is produced after this many transactions, keeps blocks under their cpu limit
+constexpr uint32_t trxs_per_block = 50;
+
+void transfer_benchmarking( wasm_interface::vm_type runtime ) {
+   fc::temp_directory tempdir;
+   controller::config cfg;
+   cfg.blocks_dir = tempdir.path() / config::default_blocks_dir_name;
+   cfg.state_dir = tempdir.path() / config::default_state_dir_name;
+   cfg.state_size = 1024*1024*64;
+   cfg.state_guard_size = 0;
+   cfg.eosvmoc_config.cache_size = 1024*1024*8;
+   cfg.wasm_runtime = runtime;
+
+   tester chain( cfg, base_tester::default_genesis() );
+   chain.execute_setup_policy( setup_policy::full );
+
+   const name token = "eosio.token"_n;
+   const name alice = "alice"_n;
+   const name bob = "bob"_n;
+   chain.create_accounts( { token, alice, bob } );
+   chain.set_code( token, contracts::eosio_token_wasm() );
+   chain.set_abi( token, contracts::eosio_token_abi().data() );
+   chain.push_action( token, "create"_n, token, mutable_variant_object()
+                      ( "issuer", alice )
+                      ( "maximum_supply", asset::from_string( "1000000000.0000 TOK" ) ) );
+   chain.push_action( token, "issue"_n, alice, mutable_variant_object()
+                      ( "to", alice )
+                      ( "quantity", asset::from_string( "1000000000.0000 TOK" ) )
+                      ( "memo", "" ) );
+   chain.produce_block();
+
+   // prepared up front so that only execution is measured; the memo makes every transaction unique
+   const auto key = base_tester::get_private_key( alice, "active" );
+   const auto chain_id = chain.control->get_chain_id();
+   std::vector<signed_transaction> trxs( num_runs() + 1 );
+   for( uint32_t i = 0; i < trxs.size(); ++i ) {
+      signed_transaction& trx = trxs[i];
+      const bytes data = fc::raw::pack( transfer_args{ alice, bob, asset::from_string( "0.0001 TOK" ), std::to_string( i ) } );
+      for( uint32_t t = 0; t < transfers_per_trx; ++t ) {
+         trx.actions.emplace_back( vector<permission_level>{ { alice, config::active_name } }, token, "transfer"_n, data );
+      }
+      chain.set_transaction_headers( trx, 30*60 );
+      trx.sign( key, chain_id );
+   }
+
+   // not measured, the first action of a contract instantiates it and, for EOS VM OC, compiles it
+   chain.push_transaction( trxs[0] );
+
+   uint32_t next = 1;
+   benchmarking( "eosio.token::transfer " + wasm_interface::vm_type_string( runtime ), [&]() {
+      chain.push_transaction( trxs[next] );
+   }, transfers_per_trx, [&]() {
+      if( next++ % trxs_per_block == 0 ) chain.produce_block();
+   } );
+}
+
+} // namespace
+
+void token_transfer_benchmarking() {
+#ifdef EOSIO_EOS_VM_RUNTIME_ENABLED
+   transfer_benchmarking( wasm_interface::vm_type::eos_vm );
+#endif
+#ifdef EOSIO_EOS_VM_JIT_RUNTIME_ENABLED
+   transfer_benchmarking( wasm_interface::vm_type::eos_vm_jit );
+#endif
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+   transfer_benchmarking( wasm_interface::vm_type::eos_vm_oc );
+#endif
+}
+
+} // eosio::benchmark
@@ -4,6 +4,9 @@
 #include <fc/io/raw.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <fc/io/varint.hpp>
+#include <fc/io/json.hpp>
+
+#include <algorithm>
 
 namespace eosio { namespace chain {
 
@@ -70,11 +73,57 @@ namespace eosio { namespace chain {
       );
    }
 
+   template <typename T>
+   inline void json_from_stream( fc::datastream<const char*>& stream, std::string& out ) {
+      T temp;
+      fc::raw::unpack( stream, temp );
+      if constexpr( std::is_same_v<T, name> ) {
+         // only [.1-5a-z], nothing to escape
+         out += '"';
+         out += temp.to_string();
+         out += '"';
+      } else if constexpr( std::is_same_v<T, fc::signed_int> || std::is_same_v<T, fc::unsigned_int> ) {
+         out += std::to_string( temp.value );
+      } else {
+         out += std::to_string( temp );
+      }
+   }
+
+   /// same as fc::json::to_string of a string variant
+   static void append_json_string( std::string& out, const std::string_view& str ) {
+      bool plain = std::all_of( str.begin(), str.end(), []( char c ) { return c >= 0x20 && c <= 0x7e && c != '"' && c != '\\'; } );
+      if( plain ) {
+         out += '"';
+         out += str;
+         out += '"';
+      } else {
+         out += fc::json::to_string( fc::variant( std::string( str ) ), fc::time_point::maximum() );
+      }
+   }
+
    abi_serializer::abi_serializer( const abi_def& abi, const yield_function_t& yield ) {
       configure_built_in_types();
       set_abi(abi, yield);
    }
 
+   abi_serializer::abi_serializer( const abi_serializer& other )
+   : typedefs(other.typedefs), structs(other.structs), actions(other.actions), tables(other.tables),
+     error_messages(other.error_messages), variants(other.variants), action_results(other.action_results),
+     built_in_types(other.built_in_types), specialized_types(other.specialized_types)
+   {
+      // other was already compiled within its limits
+      impl::abi_traverse_context ctx( create_yield_function(fc::microseconds::maximum()) );
+      compile_types(ctx);
+   }
+
+   abi_serializer& abi_serializer::operator=( const abi_serializer& other ) {
+      if( this != &other ) {
+         abi_serializer copy( other );
+         *this = std::move( copy );
+      }
+      return *this;
+   }
+
    abi_serializer::abi_serializer( const abi_def& abi, const fc::microseconds& max_serialization_time) {
       configure_built_in_types();
       set_abi(abi, max_serialization_time);
@@ -83,6 +132,9 @@ namespace eosio { namespace chain {
    void abi_serializer::add_specialized_unpack_pack( const string& name,
                                                      std::pair<abi_serializer::unpack_function, abi_serializer::pack_function> unpack_pack ) {
       built_in_types[name] = std::move( unpack_pack );
+      specialized_types.insert( name );
+      impl::abi_traverse_context ctx( create_yield_function(fc::microseconds::maximum()) );
+      compile_types(ctx);
    }
 
    void abi_serializer::configure_built_in_types() {
@@ -140,6 +192,7 @@ namespace eosio { namespace chain {
       error_messages.clear();
       variants.clear();
       action_results.clear();
+      compiled = compiled_types();
 
       for( const auto& st : abi.structs )
          structs[st.name] = st;
@@ -178,6 +231,7 @@ namespace eosio { namespace chain {
       EOS_ASSERT( action_results.size() == abi.action_results.value.size(), duplicate_abi_action_results_def_exception, "duplicate action results definition detected" );
 
       validate(ctx);
+      compile_types(ctx);
    }
 
    void abi_serializer::set_abi(const abi_def& abi, const fc::microseconds& max_serialization_time) {
@@ -338,24 +392,139 @@ namespace eosio { namespace chain {
       return type;
    }
 
-   void abi_serializer::_binary_to_variant( const std::string_view& type, fc::datastream<const char *>& stream,
+   void abi_serializer::compile_types( impl::abi_traverse_context& ctx ) {
+      compiled = compiled_types();
+      for( const auto& t : typedefs )
+         _compile_type(compiled, t.first, ctx);
+      for( const auto& s : structs )
+         _compile_type(compiled, s.first, ctx);
+      for( const auto& v : variants )
+         _compile_type(compiled, v.first, ctx);
+      for( const auto& a : actions )
+         _compile_type(compiled, a.second, ctx);
+      for( const auto& t : tables )
+         _compile_type(compiled, t.second, ctx);
+      for( const auto& r : action_results )
+         _compile_type(compiled, r.second, ctx);
+   }
+
+   uint32_t abi_serializer::_compile_type( compiled_types& ct, const std::string_view& type, impl::abi_traverse_context& ctx )const {
+      vector<uint32_t> pending;
+      auto plan_of = [&]( const std::string_view& t ) -> uint32_t {
+         auto rtype = resolve_type(t);
+         auto itr = ct.ids.find(rtype);
+         if( itr == ct.ids.end() ) {
+            itr = ct.ids.emplace( type_name(rtype), ct.plans.size() ).first;
+            ct.plans.emplace_back().type = itr->first;
+            pending.push_back( itr->second );
+         }
+         return itr->second;
+      };
+
+      const uint32_t result = plan_of(type);
+      // iterative, a deeply nested ABI must not exhaust the stack; same classification order as packing and unpacking
+      while( !pending.empty() ) {
+         ctx.check_deadline();
+         const uint32_t id = pending.back();
+         pending.pop_back();
+
+         type_plan plan;
+         plan.type        = ct.plans[id].type;
+         plan.fundamental = fundamental_type(plan.type);
+         plan.is_array    = is_array(plan.type);
+         plan.is_optional = is_optional(plan.type);
+
+         auto v_itr = variants.end();
+         if( auto btype = built_in_types.find(plan.fundamental); btype != built_in_types.end() ) {
+            plan.kind = type_plan::kind_t::built_in;
+            plan.built_in = &btype->second;
+            if( !plan.is_array && !plan.is_optional && specialized_types.count(plan.fundamental) == 0 ) {
+               static const map<std::string_view, type_plan::json_t> json_types = {
+                  { "bool", type_plan::json_t::boolean }, { "int8", type_plan::json_t::int8 }, { "uint8", type_plan::json_t::uint8 },
+                  { "int16", type_plan::json_t::int16 }, { "uint16", type_plan::json_t::uint16 }, { "int32", type_plan::json_t::int32 },
+                  { "uint32", type_plan::json_t::uint32 }, { "varint32", type_plan::json_t::varint32 },
+                  { "varuint32", type_plan::json_t::varuint32 }, { "name", type_plan::json_t::name }
+               };
+               if( auto j = json_types.find(plan.fundamental); j != json_types.end() )
+                  plan.json = j->second;
+               plan.length_prefixed = plan.fundamental == "bytes" || plan.fundamental == "string";
+            }
+            if( specialized_types.count(plan.fundamental) == 0 ) {
+               static const map<std::string_view, uint32_t> packed_sizes = {
+                  { "bool", 1 }, { "int8", 1 }, { "uint8", 1 }, { "int16", 2 }, { "uint16", 2 }, { "int32", 4 }, { "uint32", 4 },
+                  { "int64", 8 }, { "uint64", 8 }, { "int128", 16 }, { "uint128", 16 }, { "float32", 4 }, { "float64", 8 },
+                  { "float128", 16 }, { "time_point", 8 }, { "time_point_sec", 4 }, { "block_timestamp_type", 4 }, { "name", 8 },
+                  { "checksum160", 20 }, { "checksum256", 32 }, { "checksum512", 64 }, { "symbol", 8 }, { "symbol_code", 8 },
+                  { "asset", 16 }, { "extended_asset", 24 }
+               };
+               if( auto z = packed_sizes.find(plan.fundamental); z != packed_sizes.end() )
+                  plan.packed_size = z->second;
+            }
+         } else if( plan.is_array || plan.is_optional ) {
+            plan.kind = plan.is_array ? type_plan::kind_t::array : type_plan::kind_t::optional;
+            plan.element = plan_of(plan.fundamental);
+            plan.element_name = plan.fundamental;
+         } else if( (v_itr = variants.find(plan.type)) != variants.end() ) {
+            plan.kind = type_plan::kind_t::variant;
+            plan.variant_itr = v_itr;
+            plan.variant_types.reserve( v_itr->second.types.size() );
+            for( const auto& t : v_itr->second.types )
+               plan.variant_types.push_back( plan_of(t) );
+         }
+
+         if( auto s_itr = structs.find(plan.type); s_itr != structs.end() ) {
+            if( plan.kind == type_plan::kind_t::unknown )
+               plan.kind = type_plan::kind_t::structure;
+            plan.has_struct = true;
+            plan.struct_itr = s_itr;
+            const auto& st = s_itr->second;
+            if( st.base != type_name() ) {
+               plan.base_name = resolve_type(st.base);
+               plan.base = plan_of(plan.base_name);
+            }
+            plan.fields.reserve( st.fields.size() );
+            for( const auto& field : st.fields ) {
+               auto& f = plan.fields.emplace_back();
+               f.extension = ends_with(field.type, "$");
+               f.unresolved_type = _remove_bin_extension(field.type);
+               f.type = plan_of(f.unresolved_type);
+               f.bytes = resolve_type(f.unresolved_type) == "bytes";
+            }
+            // the variant form keeps a single entry for a field name repeated in a derived struct
+            vector<std::string_view> names;
+            const struct_def* current = &st;
+            for( auto i = structs.size(); current && i > 0; --i ) {
+               for( const auto& field : current->fields )
+                  names.emplace_back( field.name );
+               auto base = current->base != type_name() ? structs.find(resolve_type(current->base)) : structs.end();
+               current = base != structs.end() ? &base->second : nullptr;
+            }
+            std::sort( names.begin(), names.end() );
+            plan.json_object = std::adjacent_find( names.begin(), names.end() ) == names.end();
+         }
+
+         ct.plans[id] = std::move(plan);
+      }
+      return result;
+   }
+
+   void abi_serializer::_binary_to_variant( const compiled_types& ct, const type_plan& plan, fc::datastream<const char *>& stream,
                                             fc::mutable_variant_object& obj, impl::binary_to_variant_context& ctx )const
    {
       auto h = ctx.enter_scope();
-      auto s_itr = structs.find(type);
-      EOS_ASSERT( s_itr != structs.end(), invalid_type_inside_abi, "Unknown type ${type}", ("type",ctx.maybe_shorten(type)) );
-      ctx.hint_struct_type_if_in_array( s_itr );
-      const auto& st = s_itr->second;
-      if( st.base != type_name() ) {
-         _binary_to_variant(resolve_type(st.base), stream, obj, ctx);
+      EOS_ASSERT( plan.has_struct, invalid_type_inside_abi, "Unknown type ${type}", ("type",ctx.maybe_shorten(plan.type)) );
+      ctx.hint_struct_type_if_in_array( plan.struct_itr );
+      const auto& st = plan.struct_itr->second;
+      if( plan.base ) {
+         _binary_to_variant(ct, ct.plans[*plan.base], stream, obj, ctx);
       }
       bool encountered_extension = false;
       for( uint32_t i = 0; i < st.fields.size(); ++i ) {
          const auto& field = st.fields[i];
-         bool extension = ends_with(field.type, "$");
-         encountered_extension |= extension;
+         const auto& fplan = plan.fields[i];
+         encountered_extension |= fplan.extension;
          if( !stream.remaining() ) {
-            if( extension ) {
+            if( fplan.extension ) {
                continue;
             }
             if( encountered_extension ) {
@@ -366,10 +535,9 @@ namespace eosio { namespace chain {
                        ("f", ctx.maybe_shorten(field.name))("p", ctx.get_path_string()) );
 
          }
-         auto h1 = ctx.push_to_path( impl::field_path_item{ .parent_struct_itr = s_itr, .field_ordinal = i } );
-         auto field_type = resolve_type( extension ? _remove_bin_extension(field.type) : field.type );
-         auto v = _binary_to_variant(field_type, stream, ctx);
-         if( ctx.is_logging() && v.is_string() && field_type == "bytes" ) {
+         auto h1 = ctx.push_to_path( impl::field_path_item{ .parent_struct_itr = plan.struct_itr, .field_ordinal = i } );
+         auto v = _binary_to_variant(ct, fplan.type, stream, ctx);
+         if( ctx.is_logging() && v.is_string() && fplan.bytes ) {
             fc::mutable_variant_object sub_obj;
             auto size = v.get_string().size() / 2; // half because it is in hex
             sub_obj( "size", size );
@@ -385,69 +553,83 @@ namespace eosio { namespace chain {
       }
    }
 
-   fc::variant abi_serializer::_binary_to_variant( const std::string_view& type, fc::datastream<const char *>& stream,
+   fc::variant abi_serializer::_binary_to_variant( const compiled_types& ct, uint32_t type, fc::datastream<const char *>& stream,
                                                    impl::binary_to_variant_context& ctx )const
    {
       auto h = ctx.enter_scope();
-      auto rtype = resolve_type(type);
-      auto ftype = fundamental_type(rtype);
-      auto btype = built_in_types.find(ftype );
-      if( btype != built_in_types.end() ) {
-         try {
-            return btype->second.first(stream, is_array(rtype), is_optional(rtype), ctx.get_yield_function());
-         } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack ${class} type '${type}' while processing '${p}'",
-                                   ("class", is_array(rtype) ? "array of built-in" : is_optional(rtype) ? "optional of built-in" : "built-in")
-                                   ("type", impl::limit_size(ftype))("p", ctx.get_path_string()) )
-      }
-      if ( is_array(rtype) ) {
-         ctx.hint_array_type_if_in_array();
-         fc::unsigned_int size;
-         try {
-            fc::raw::unpack(stream, size);
-         } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack size of array '${p}'", ("p", ctx.get_path_string()) )
-         vector<fc::variant> vars;
-         auto h1 = ctx.push_to_path( impl::array_index_path_item{} );
-         for( decltype(size.value) i = 0; i < size; ++i ) {
-            ctx.set_array_index_of_path_back(i);
-            auto v = _binary_to_variant(ftype, stream, ctx);
-            // The exception below is commented out to allow array of optional as input data
-            //EOS_ASSERT( !v.is_null(), unpack_exception, "Invalid packed array '${p}'", ("p", ctx.get_path_string()) );
-            vars.emplace_back(std::move(v));
-         }
-         // QUESTION: Why would the assert below ever fail?
-         EOS_ASSERT( vars.size() == size.value,
-                     unpack_exception,
-                     "packed size does not match unpacked array size, packed size ${p} actual size ${a}",
-                     ("p", size)("a", vars.size()) );
-         return fc::variant( std::move(vars) );
-      } else if ( is_optional(rtype) ) {
-         char flag;
-         try {
-            fc::raw::unpack(stream, flag);
-         } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack presence flag of optional '${p}'", ("p", ctx.get_path_string()) )
-         return flag ? _binary_to_variant(ftype, stream, ctx) : fc::variant();
-      } else {
-         auto v_itr = variants.find(rtype);
-         if( v_itr != variants.end() ) {
-            ctx.hint_variant_type_if_in_array( v_itr );
+      const type_plan& plan = ct.plans[type];
+      switch( plan.kind ) {
+         case type_plan::kind_t::built_in:
+            try {
+               return plan.built_in->first(stream, plan.is_array, plan.is_optional, ctx.get_yield_function());
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack ${class} type '${type}' while processing '${p}'",
+                                      ("class", plan.is_array ? "array of built-in" : plan.is_optional ? "optional of built-in" : "built-in")
+                                      ("type", impl::limit_size(plan.fundamental))("p", ctx.get_path_string()) )
+         case type_plan::kind_t::array: {
+            ctx.hint_array_type_if_in_array();
+            fc::unsigned_int size;
+            try {
+               fc::raw::unpack(stream, size);
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack size of array '${p}'", ("p", ctx.get_path_string()) )
+            vector<fc::variant> vars;
+            auto h1 = ctx.push_to_path( impl::array_index_path_item{} );
+            for( decltype(size.value) i = 0; i < size; ++i ) {
+               ctx.set_array_index_of_path_back(i);
+               auto v = _binary_to_variant(ct, plan.element, stream, ctx);
+               // The exception below is commented out to allow array of optional as input data
+               //EOS_ASSERT( !v.is_null(), unpack_exception, "Invalid packed array '${p}'", ("p", ctx.get_path_string()) );
+               vars.emplace_back(std::move(v));
+            }
+            // QUESTION: Why would the assert below ever fail?
+            EOS_ASSERT( vars.size() == size.value,
+                        unpack_exception,
+                        "packed size does not match unpacked array size, packed size ${p} actual size ${a}",
+                        ("p", size)("a", vars.size()) );
+            return fc::variant( std::move(vars) );
+         }
+         case type_plan::kind_t::optional: {
+            char flag;
+            try {
+               fc::raw::unpack(stream, flag);
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack presence flag of optional '${p}'", ("p", ctx.get_path_string()) )
+            return flag ? _binary_to_variant(ct, plan.element, stream, ctx) : fc::variant();
+         }
+         case type_plan::kind_t::variant: {
+            ctx.hint_variant_type_if_in_array( plan.variant_itr );
             fc::unsigned_int select;
             try {
                fc::raw::unpack(stream, select);
             } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack tag of variant '${p}'", ("p", ctx.get_path_string()) )
-            EOS_ASSERT( (size_t)select < v_itr->second.types.size(), unpack_exception,
+            const auto& v = plan.variant_itr->second;
+            EOS_ASSERT( (size_t)select < v.types.size(), unpack_exception,
                         "Unpacked invalid tag (${select}) for variant '${p}'", ("select", select.value)("p",ctx.get_path_string()) );
-            auto h1 = ctx.push_to_path( impl::variant_path_item{ .variant_itr = v_itr, .variant_ordinal = static_cast<uint32_t>(select) } );
-            return vector<fc::variant>{v_itr->second.types[select], _binary_to_variant(v_itr->second.types[select], stream, ctx)};
+            auto h1 = ctx.push_to_path( impl::variant_path_item{ .variant_itr = plan.variant_itr, .variant_ordinal = static_cast<uint32_t>(select) } );
+            return vector<fc::variant>{v.types[select], _binary_to_variant(ct, plan.variant_types[select], stream, ctx)};
          }
+         default:
+            break;
       }
 
       fc::mutable_variant_object mvo;
-      _binary_to_variant(rtype, stream, mvo, ctx);
+      _binary_to_variant(ct, plan, stream, mvo, ctx);
       // QUESTION: Is this assert actually desired? It disallows unpacking empty structs from datastream.
       EOS_ASSERT( mvo.size() > 0, unpack_exception, "Unable to unpack '${p}' from stream", ("p", ctx.get_path_string()) );
       return fc::variant( std::move(mvo) );
    }
 
+   fc::variant abi_serializer::_binary_to_variant( const std::string_view& type, fc::datastream<const char *>& stream,
+                                                   impl::binary_to_variant_context& ctx )const
+   {
+      auto itr = compiled.ids.find(resolve_type(type));
+      if( itr != compiled.ids.end() ) {
+         return _binary_to_variant(compiled, itr->second, stream, ctx);
+      }
+      // not used by the ABI, e.g. an array of a built-in type
+      compiled_types ct;
+      const uint32_t id = _compile_type(ct, type, ctx);
+      return _binary_to_variant(ct, id, stream, ctx);
+   }
+
    fc::variant abi_serializer::_binary_to_variant( const std::string_view& type, const bytes& binary, impl::binary_to_variant_context& ctx )const
    {
       auto h = ctx.enter_scope();
@@ -475,111 +657,424 @@ namespace eosio { namespace chain {
       return binary_to_variant( type, binary, create_yield_function(max_serialization_time), short_path );
    }
 
-   void abi_serializer::_variant_to_binary( const std::string_view& type, const fc::variant& var, fc::datastream<char *>& ds, impl::variant_to_binary_context& ctx )const
-   { try {
+   void abi_serializer::_binary_to_json( const compiled_types& ct, const type_plan& plan, fc::datastream<const char *>& stream,
+                                         std::string& out, bool& empty, impl::binary_to_variant_context& ctx,
+                                         field_selection* selection )const
+   {
       auto h = ctx.enter_scope();
-      auto rtype = resolve_type(type);
-
-      auto v_itr = variants.end();
-      auto s_itr = structs.end();
-
-      auto btype = built_in_types.find(fundamental_type(rtype));
-      if( btype != built_in_types.end() ) {
-         btype->second.second(var, ds, is_array(rtype), is_optional(rtype), ctx.get_yield_function());
-      } else if ( is_array(rtype) ) {
-         ctx.hint_array_type_if_in_array();
-         vector<fc::variant> vars = var.get_array();
-         fc::raw::pack(ds, (fc::unsigned_int)vars.size());
-
-         auto h1 = ctx.push_to_path( impl::array_index_path_item{} );
-         auto h2 = ctx.disallow_extensions_unless(false);
-
-         int64_t i = 0;
-         for (const auto& var : vars) {
-            ctx.set_array_index_of_path_back(i);
-           _variant_to_binary(fundamental_type(rtype), var, ds, ctx);
-           ++i;
-         }
-      } else if( is_optional(rtype) ) {
-         char flag = !var.is_null();
-         fc::raw::pack(ds, flag);
-         if( flag ) {
-            _variant_to_binary(fundamental_type(rtype), var, ds, ctx);
-         }
-      } else if( (v_itr = variants.find(rtype)) != variants.end() ) {
-         ctx.hint_variant_type_if_in_array( v_itr );
-         auto& v = v_itr->second;
-         EOS_ASSERT( var.is_array() && var.size() == 2, pack_exception,
-                    "Expected input to be an array of two items while processing variant '${p}'", ("p", ctx.get_path_string()) );
-         EOS_ASSERT( var[size_t(0)].is_string(), pack_exception,
-                    "Encountered non-string as first item of input array while processing variant '${p}'", ("p", ctx.get_path_string()) );
-         auto variant_type_str = var[size_t(0)].get_string();
-         auto it = find(v.types.begin(), v.types.end(), variant_type_str);
-         EOS_ASSERT( it != v.types.end(), pack_exception,
-                     "Specified type '${t}' in input array is not valid within the variant '${p}'",
-                     ("t", ctx.maybe_shorten(variant_type_str))("p", ctx.get_path_string()) );
-         fc::raw::pack(ds, fc::unsigned_int(it - v.types.begin()));
-         auto h1 = ctx.push_to_path( impl::variant_path_item{ .variant_itr = v_itr, .variant_ordinal = static_cast<uint32_t>(it - v.types.begin()) } );
-         _variant_to_binary( *it, var[size_t(1)], ds, ctx );
-      } else if( (s_itr = structs.find(rtype)) != structs.end() ) {
-         ctx.hint_struct_type_if_in_array( s_itr );
-         const auto& st = s_itr->second;
-
-         if( var.is_object() ) {
-            const auto& vo = var.get_object();
+      EOS_ASSERT( plan.has_struct, invalid_type_inside_abi, "Unknown type ${type}", ("type",ctx.maybe_shorten(plan.type)) );
+      ctx.hint_struct_type_if_in_array( plan.struct_itr );
+      const auto& st = plan.struct_itr->second;
+      if( plan.base ) {
+         _binary_to_json(ct, ct.plans[*plan.base], stream, out, empty, ctx, selection);
+      }
+      bool encountered_extension = false;
+      for( uint32_t i = 0; i < st.fields.size(); ++i ) {
+         if( selection && selection->remaining == 0 )
+            return;
+         const auto& field = st.fields[i];
+         const auto& fplan = plan.fields[i];
+         encountered_extension |= fplan.extension;
+         if( !stream.remaining() ) {
+            if( fplan.extension ) {
+               continue;
+            }
+            if( encountered_extension ) {
+               EOS_THROW( abi_exception, "Encountered field '${f}' without binary extension designation while processing struct '${p}'",
+                          ("f", ctx.maybe_shorten(field.name))("p", ctx.get_path_string()) );
+            }
+            EOS_THROW( unpack_exception, "Stream unexpectedly ended; unable to unpack field '${f}' of struct '${p}'",
+                       ("f", ctx.maybe_shorten(field.name))("p", ctx.get_path_string()) );
 
-            if( st.base != type_name() ) {
-               auto h2 = ctx.disallow_extensions_unless(false);
-               _variant_to_binary(resolve_type(st.base), var, ds, ctx);
+         }
+         auto h1 = ctx.push_to_path( impl::field_path_item{ .parent_struct_itr = plan.struct_itr, .field_ordinal = i } );
+         if( selection ) {
+            if( std::find( selection->fields.begin(), selection->fields.end(), field.name ) == selection->fields.end() ) {
+               _skip_binary(ct, fplan.type, stream, ctx);
+               continue;
             }
-            bool disallow_additional_fields = false;
-            for( uint32_t i = 0; i < st.fields.size(); ++i ) {
-               const auto& field = st.fields[i];
-               if( vo.contains( string(field.name).c_str() ) ) {
-                  if( disallow_additional_fields )
-                     EOS_THROW( pack_exception, "Unexpected field '${f}' found in input object while processing struct '${p}'",
-                                ("f", ctx.maybe_shorten(field.name))("p", ctx.get_path_string()) );
-                  {
-                     auto h1 = ctx.push_to_path( impl::field_path_item{ .parent_struct_itr = s_itr, .field_ordinal = i } );
-                     auto h2 = ctx.disallow_extensions_unless( &field == &st.fields.back() );
-                     _variant_to_binary(_remove_bin_extension(field.type), vo[field.name], ds, ctx);
-                  }
-               } else if( ends_with(field.type, "$") && ctx.extensions_allowed() ) {
-                  disallow_additional_fields = true;
-               } else if( disallow_additional_fields ) {
-                  EOS_THROW( abi_exception, "Encountered field '${f}' without binary extension designation while processing struct '${p}'",
-                             ("f", ctx.maybe_shorten(field.name))("p", ctx.get_path_string()) );
-               } else {
-                  EOS_THROW( pack_exception, "Missing field '${f}' in input object while processing struct '${p}'",
-                             ("f", ctx.maybe_shorten(field.name))("p", ctx.get_path_string()) );
+            --selection->remaining;
+         }
+         if( !empty )
+            out += ',';
+         empty = false;
+         append_json_string(out, field.name);
+         out += ':';
+         _binary_to_json(ct, fplan.type, stream, out, ctx);
+      }
+   }
+
+   void abi_serializer::_binary_to_json( const compiled_types& ct, uint32_t type, fc::datastream<const char *>& stream,
+                                         std::string& out, impl::binary_to_variant_context& ctx )const
+   {
+      auto h = ctx.enter_scope();
+      const type_plan& plan = ct.plans[type];
+      switch( plan.kind ) {
+         case type_plan::kind_t::built_in:
+            try {
+               switch( plan.json ) {
+                  case type_plan::json_t::boolean:   json_from_stream<uint8_t>(stream, out); break;
+                  case type_plan::json_t::int8:      json_from_stream<int8_t>(stream, out); break;
+                  case type_plan::json_t::uint8:     json_from_stream<uint8_t>(stream, out); break;
+                  case type_plan::json_t::int16:     json_from_stream<int16_t>(stream, out); break;
+                  case type_plan::json_t::uint16:    json_from_stream<uint16_t>(stream, out); break;
+                  case type_plan::json_t::int32:     json_from_stream<int32_t>(stream, out); break;
+                  case type_plan::json_t::uint32:    json_from_stream<uint32_t>(stream, out); break;
+                  case type_plan::json_t::varint32:  json_from_stream<fc::signed_int>(stream, out); break;
+                  case type_plan::json_t::varuint32: json_from_stream<fc::unsigned_int>(stream, out); break;
+                  case type_plan::json_t::name:      json_from_stream<name>(stream, out); break;
+                  default:
+                     out += fc::json::to_string( plan.built_in->first(stream, plan.is_array, plan.is_optional, ctx.get_yield_function()),
+                                                 fc::time_point::maximum() );
                }
+               return;
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack ${class} type '${type}' while processing '${p}'",
+                                      ("class", plan.is_array ? "array of built-in" : plan.is_optional ? "optional of built-in" : "built-in")
+                                      ("type", impl::limit_size(plan.fundamental))("p", ctx.get_path_string()) )
+         case type_plan::kind_t::array: {
+            ctx.hint_array_type_if_in_array();
+            fc::unsigned_int size;
+            try {
+               fc::raw::unpack(stream, size);
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack size of array '${p}'", ("p", ctx.get_path_string()) )
+            auto h1 = ctx.push_to_path( impl::array_index_path_item{} );
+            out += '[';
+            for( decltype(size.value) i = 0; i < size; ++i ) {
+               ctx.set_array_index_of_path_back(i);
+               if( i > 0 )
+                  out += ',';
+               _binary_to_json(ct, plan.element, stream, out, ctx);
             }
-         } else if( var.is_array() ) {
-            const auto& va = var.get_array();
-            EOS_ASSERT( st.base == type_name(), invalid_type_inside_abi,
-                        "Using input array to specify the fields of the derived struct '${p}'; input arrays are currently only allowed for structs without a base",
-                        ("p",ctx.get_path_string()) );
-            for( uint32_t i = 0; i < st.fields.size(); ++i ) {
-               const auto& field = st.fields[i];
-               if( va.size() > i ) {
-                  auto h1 = ctx.push_to_path( impl::field_path_item{ .parent_struct_itr = s_itr, .field_ordinal = i } );
-                  auto h2 = ctx.disallow_extensions_unless( &field == &st.fields.back() );
-                  _variant_to_binary(_remove_bin_extension(field.type), va[i], ds, ctx);
-               } else if( ends_with(field.type, "$") && ctx.extensions_allowed() ) {
-                  break;
+            out += ']';
+            return;
+         }
+         case type_plan::kind_t::optional: {
+            char flag;
+            try {
+               fc::raw::unpack(stream, flag);
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack presence flag of optional '${p}'", ("p", ctx.get_path_string()) )
+            if( flag )
+               _binary_to_json(ct, plan.element, stream, out, ctx);
+            else
+               out += "null";
+            return;
+         }
+         case type_plan::kind_t::variant: {
+            ctx.hint_variant_type_if_in_array( plan.variant_itr );
+            fc::unsigned_int select;
+            try {
+               fc::raw::unpack(stream, select);
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack tag of variant '${p}'", ("p", ctx.get_path_string()) )
+            const auto& v = plan.variant_itr->second;
+            EOS_ASSERT( (size_t)select < v.types.size(), unpack_exception,
+                        "Unpacked invalid tag (${select}) for variant '${p}'", ("select", select.value)("p",ctx.get_path_string()) );
+            auto h1 = ctx.push_to_path( impl::variant_path_item{ .variant_itr = plan.variant_itr, .variant_ordinal = static_cast<uint32_t>(select) } );
+            out += '[';
+            append_json_string(out, v.types[select]);
+            out += ',';
+            _binary_to_json(ct, plan.variant_types[select], stream, out, ctx);
+            out += ']';
+            return;
+         }
+         default:
+            break;
+      }
+
+      if( !plan.json_object ) {
+         fc::mutable_variant_object mvo;
+         _binary_to_variant(ct, plan, stream, mvo, ctx);
+         EOS_ASSERT( mvo.size() > 0, unpack_exception, "Unable to unpack '${p}' from stream", ("p", ctx.get_path_string()) );
+         out += fc::json::to_string( fc::variant( std::move(mvo) ), fc::time_point::maximum() );
+         return;
+      }
+      bool empty = true;
+      out += '{';
+      _binary_to_json(ct, plan, stream, out, empty, ctx);
+      EOS_ASSERT( !empty, unpack_exception, "Unable to unpack '${p}' from stream", ("p", ctx.get_path_string()) );
+      out += '}';
+   }
+
+   void abi_serializer::_skip_binary( const compiled_types& ct, const type_plan& plan, fc::datastream<const char *>& stream,
+                                      impl::binary_to_variant_context& ctx )const
+   {
+      auto h = ctx.enter_scope();
+      EOS_ASSERT( plan.has_struct, invalid_type_inside_abi, "Unknown type ${type}", ("type",ctx.maybe_shorten(plan.type)) );
+      if( plan.base ) {
+         _skip_binary(ct, ct.plans[*plan.base], stream, ctx);
+      }
+      const auto& st = plan.struct_itr->second;
+      bool encountered_extension = false;
+      for( uint32_t i = 0; i < st.fields.size(); ++i ) {
+         const auto& fplan = plan.fields[i];
+         encountered_extension |= fplan.extension;
+         if( !stream.remaining() ) {
+            if( fplan.extension ) {
+               continue;
+            }
+            if( encountered_extension ) {
+               EOS_THROW( abi_exception, "Encountered field '${f}' without binary extension designation while processing struct '${p}'",
+                          ("f", ctx.maybe_shorten(st.fields[i].name))("p", ctx.get_path_string()) );
+            }
+            EOS_THROW( unpack_exception, "Stream unexpectedly ended; unable to unpack field '${f}' of struct '${p}'",
+                       ("f", ctx.maybe_shorten(st.fields[i].name))("p", ctx.get_path_string()) );
+         }
+         auto h1 = ctx.push_to_path( impl::field_path_item{ .parent_struct_itr = plan.struct_itr, .field_ordinal = i } );
+         _skip_binary(ct, fplan.type, stream, ctx);
+      }
+   }
+
+   void abi_serializer::_skip_binary( const compiled_types& ct, uint32_t type, fc::datastream<const char *>& stream,
+                                      impl::binary_to_variant_context& ctx )const
+   {
+      auto h = ctx.enter_scope();
+      const type_plan& plan = ct.plans[type];
+      const auto skip = [&]( uint64_t size ) {
+         EOS_ASSERT( stream.remaining() >= size, unpack_exception, "Stream unexpectedly ended; unable to unpack '${p}'",
+                     ("p", ctx.get_path_string()) );
+         stream.skip( size );
+      };
+      switch( plan.kind ) {
+         case type_plan::kind_t::built_in: {
+            fc::unsigned_int size;
+            try {
+               if( plan.packed_size && plan.is_array ) {
+                  fc::raw::unpack(stream, size);
+                  skip( uint64_t(size.value) * plan.packed_size );
+               } else if( plan.packed_size && plan.is_optional ) {
+                  char flag;
+                  fc::raw::unpack(stream, flag);
+                  if( flag )
+                     skip( plan.packed_size );
+               } else if( plan.packed_size ) {
+                  skip( plan.packed_size );
+               } else if( plan.length_prefixed ) {
+                  fc::raw::unpack(stream, size);
+                  skip( size.value );
+               } else if( plan.json == type_plan::json_t::varint32 || plan.json == type_plan::json_t::varuint32 ) {
+                  fc::raw::unpack(stream, size); // same encoded length
                } else {
-                  EOS_THROW( pack_exception, "Early end to input array specifying the fields of struct '${p}'; require input for field '${f}'",
-                             ("p", ctx.get_path_string())("f", ctx.maybe_shorten(field.name)) );
+                  plan.built_in->first(stream, plan.is_array, plan.is_optional, ctx.get_yield_function());
                }
+               return;
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack ${class} type '${type}' while processing '${p}'",
+                                      ("class", plan.is_array ? "array of built-in" : plan.is_optional ? "optional of built-in" : "built-in")
+                                      ("type", impl::limit_size(plan.fundamental))("p", ctx.get_path_string()) )
+         }
+         case type_plan::kind_t::array: {
+            fc::unsigned_int size;
+            try {
+               fc::raw::unpack(stream, size);
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack size of array '${p}'", ("p", ctx.get_path_string()) )
+            auto h1 = ctx.push_to_path( impl::array_index_path_item{} );
+            for( decltype(size.value) i = 0; i < size; ++i ) {
+               ctx.set_array_index_of_path_back(i);
+               _skip_binary(ct, plan.element, stream, ctx);
             }
-         } else {
-            EOS_THROW( pack_exception, "Unexpected input encountered while processing struct '${p}'", ("p",ctx.get_path_string()) );
+            return;
          }
-      } else {
-         EOS_THROW( invalid_type_inside_abi, "Unknown type ${type}", ("type",ctx.maybe_shorten(type)) );
+         case type_plan::kind_t::optional: {
+            char flag;
+            try {
+               fc::raw::unpack(stream, flag);
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack presence flag of optional '${p}'", ("p", ctx.get_path_string()) )
+            if( flag )
+               _skip_binary(ct, plan.element, stream, ctx);
+            return;
+         }
+         case type_plan::kind_t::variant: {
+            fc::unsigned_int select;
+            try {
+               fc::raw::unpack(stream, select);
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack tag of variant '${p}'", ("p", ctx.get_path_string()) )
+            const auto& v = plan.variant_itr->second;
+            EOS_ASSERT( (size_t)select < v.types.size(), unpack_exception,
+                        "Unpacked invalid tag (${select}) for variant '${p}'", ("select", select.value)("p",ctx.get_path_string()) );
+            auto h1 = ctx.push_to_path( impl::variant_path_item{ .variant_itr = plan.variant_itr, .variant_ordinal = static_cast<uint32_t>(select) } );
+            _skip_binary(ct, plan.variant_types[select], stream, ctx);
+            return;
+         }
+         default:
+            break;
+      }
+      _skip_binary(ct, plan, stream, ctx);
+   }
+
+   void abi_serializer::_binary_to_json( const std::string_view& type, fc::datastream<const char *>& stream, std::string& out,
+                                         impl::binary_to_variant_context& ctx )const
+   {
+      auto itr = compiled.ids.find(resolve_type(type));
+      if( itr != compiled.ids.end() ) {
+         _binary_to_json(compiled, itr->second, stream, out, ctx);
+         return;
+      }
+      compiled_types ct;
+      const uint32_t id = _compile_type(ct, type, ctx);
+      _binary_to_json(ct, id, stream, out, ctx);
+   }
+
+   void abi_serializer::binary_to_json( const std::string_view& type, fc::datastream<const char*>& binary, std::string& out,
+                                        const yield_function_t& yield, bool short_path )const {
+      impl::binary_to_variant_context ctx(*this, yield, type);
+      ctx.short_path = short_path;
+      _binary_to_json(type, binary, out, ctx);
+   }
+
+   void abi_serializer::binary_to_json( const std::string_view& type, fc::datastream<const char*>& binary, std::string& out,
+                                        const vector<string>& fields, const yield_function_t& yield, bool short_path )const {
+      impl::binary_to_variant_context ctx(*this, yield, type);
+      ctx.short_path = short_path;
+      auto h = ctx.enter_scope();
+      auto itr = compiled.ids.find(resolve_type(type));
+      EOS_ASSERT( itr != compiled.ids.end(), invalid_type_inside_abi, "Unknown type ${type}", ("type",ctx.maybe_shorten(type)) );
+      const type_plan& plan = compiled.plans[itr->second];
+      EOS_ASSERT( plan.kind == type_plan::kind_t::structure && plan.json_object, abi_exception,
+                  "Fields can only be selected from a struct, not from '${type}'", ("type",ctx.maybe_shorten(type)) );
+      field_selection selection{ fields, fields.size() };
+      bool empty = true;
+      out += '{';
+      _binary_to_json(compiled, plan, binary, out, empty, ctx, &selection);
+      out += '}';
+   }
+
+   std::string abi_serializer::binary_to_json( const std::string_view& type, const bytes& binary, const yield_function_t& yield, bool short_path )const {
+      impl::binary_to_variant_context ctx(*this, yield, type);
+      ctx.short_path = short_path;
+      auto h = ctx.enter_scope();
+      fc::datastream<const char*> ds( binary.data(), binary.size() );
+      std::string out;
+      _binary_to_json(type, ds, out, ctx);
+      return out;
+   }
+
+   void abi_serializer::_variant_to_binary( const compiled_types& ct, uint32_t type, const std::string_view& unresolved_type,
+                                            const fc::variant& var, fc::datastream<char *>& ds, impl::variant_to_binary_context& ctx )const
+   { try {
+      auto h = ctx.enter_scope();
+      const type_plan& plan = ct.plans[type];
+
+      switch( plan.kind ) {
+         case type_plan::kind_t::built_in:
+            plan.built_in->second(var, ds, plan.is_array, plan.is_optional, ctx.get_yield_function());
+            break;
+         case type_plan::kind_t::array: {
+            ctx.hint_array_type_if_in_array();
+            const auto& vars = var.get_array();
+            fc::raw::pack(ds, (fc::unsigned_int)vars.size());
+
+            auto h1 = ctx.push_to_path( impl::array_index_path_item{} );
+            auto h2 = ctx.disallow_extensions_unless(false);
+
+            int64_t i = 0;
+            for (const auto& var : vars) {
+               ctx.set_array_index_of_path_back(i);
+               _variant_to_binary(ct, plan.element, plan.element_name, var, ds, ctx);
+               ++i;
+            }
+            break;
+         }
+         case type_plan::kind_t::optional: {
+            char flag = !var.is_null();
+            fc::raw::pack(ds, flag);
+            if( flag ) {
+               _variant_to_binary(ct, plan.element, plan.element_name, var, ds, ctx);
+            }
+            break;
+         }
+         case type_plan::kind_t::variant: {
+            ctx.hint_variant_type_if_in_array( plan.variant_itr );
+            auto& v = plan.variant_itr->second;
+            EOS_ASSERT( var.is_array() && var.size() == 2, pack_exception,
+                       "Expected input to be an array of two items while processing variant '${p}'", ("p", ctx.get_path_string()) );
+            EOS_ASSERT( var[size_t(0)].is_string(), pack_exception,
+                       "Encountered non-string as first item of input array while processing variant '${p}'", ("p", ctx.get_path_string()) );
+            auto variant_type_str = var[size_t(0)].get_string();
+            auto it = find(v.types.begin(), v.types.end(), variant_type_str);
+            EOS_ASSERT( it != v.types.end(), pack_exception,
+                        "Specified type '${t}' in input array is not valid within the variant '${p}'",
+                        ("t", ctx.maybe_shorten(variant_type_str))("p", ctx.get_path_string()) );
+            const auto ordinal = static_cast<uint32_t>(it - v.types.begin());
+            fc::raw::pack(ds, fc::unsigned_int(ordinal));
+            auto h1 = ctx.push_to_path( impl::variant_path_item{ .variant_itr = plan.variant_itr, .variant_ordinal = ordinal } );
+            _variant_to_binary( ct, plan.variant_types[ordinal], *it, var[size_t(1)], ds, ctx );
+            break;
+         }
+         case type_plan::kind_t::structure: {
+            ctx.hint_struct_type_if_in_array( plan.struct_itr );
+            const auto& st = plan.struct_itr->second;
+
+            if( var.is_object() ) {
+               const auto& vo = var.get_object();
+
+               if( plan.base ) {
+                  auto h2 = ctx.disallow_extensions_unless(false);
+                  _variant_to_binary(ct, *plan.base, plan.base_name, var, ds, ctx);
+               }
+               bool disallow_additional_fields = false;
+               for( uint32_t i = 0; i < st.fields.size(); ++i ) {
+                  const auto& field = st.fields[i];
+                  const auto& fplan = plan.fields[i];
+                  auto vitr = vo.find( field.name.c_str() );
+                  if( vitr != vo.end() ) {
+                     if( disallow_additional_fields )
+                        EOS_THROW( pack_exception, "Unexpected field '${f}' found in input object while processing struct '${p}'",
+                                   ("f", ctx.maybe_shorten(field.name))("p", ctx.get_path_string()) );
+                     {
+                        auto h1 = ctx.push_to_path( impl::field_path_item{ .parent_struct_itr = plan.struct_itr, .field_ordinal = i } );
+                        auto h2 = ctx.disallow_extensions_unless( &field == &st.fields.back() );
+                        _variant_to_binary(ct, fplan.type, fplan.unresolved_type, vitr->value(), ds, ctx);
+                     }
+                  } else if( fplan.extension && ctx.extensions_allowed() ) {
+                     disallow_additional_fields = true;
+                  } else if( disallow_additional_fields ) {
+                     EOS_THROW( abi_exception, "Encountered field '${f}' without binary extension designation while processing struct '${p}'",
+                                ("f", ctx.maybe_shorten(field.name))("p", ctx.get_path_string()) );
+                  } else {
+                     EOS_THROW( pack_exception, "Missing field '${f}' in input object while processing struct '${p}'",
+                                ("f", ctx.maybe_shorten(field.name))("p", ctx.get_path_string()) );
+                  }
+               }
+            } else if( var.is_array() ) {
+               const auto& va = var.get_array();
+               EOS_ASSERT( st.base == type_name(), invalid_type_inside_abi,
+                           "Using input array to specify the fields of the derived struct '${p}'; input arrays are currently only allowed for structs without a base",
+                           ("p",ctx.get_path_string()) );
+               for( uint32_t i = 0; i < st.fields.size(); ++i ) {
+                  const auto& field = st.fields[i];
+                  const auto& fplan = plan.fields[i];
+                  if( va.size() > i ) {
+                     auto h1 = ctx.push_to_path( impl::field_path_item{ .parent_struct_itr = plan.struct_itr, .field_ordinal = i } );
+                     auto h2 = ctx.disallow_extensions_unless( &field == &st.fields.back() );
+                     _variant_to_binary(ct, fplan.type, fplan.unresolved_type, va[i], ds, ctx);
+                  } else if( fplan.extension && ctx.extensions_allowed() ) {
+                     break;
+                  } else {
+                     EOS_THROW( pack_exception, "Early end to input array specifying the fields of struct '${p}'; require input for field '${f}'",
+                                ("p", ctx.get_path_string())("f", ctx.maybe_shorten(field.name)) );
+                  }
+               }
+            } else {
+               EOS_THROW( pack_exception, "Unexpected input encountered while processing struct '${p}'", ("p",ctx.get_path_string()) );
+            }
+            break;
+         }
+         default:
+            EOS_THROW( invalid_type_inside_abi, "Unknown type ${type}", ("type",ctx.maybe_shorten(unresolved_type)) );
       }
    } FC_CAPTURE_AND_RETHROW() }
 
+   void abi_serializer::_variant_to_binary( const std::string_view& type, const fc::variant& var, fc::datastream<char *>& ds, impl::variant_to_binary_context& ctx )const
+   {
+      auto itr = compiled.ids.find(resolve_type(type));
+      if( itr != compiled.ids.end() ) {
+         _variant_to_binary(compiled, itr->second, type, var, ds, ctx);
+         return;
+      }
+      // not used by the ABI, e.g. an array of a built-in type
+      compiled_types ct;
+      const uint32_t id = _compile_type(ct, type, ctx);
+      _variant_to_binary(ct, id, type, var, ds, ctx);
+   }
+
    bytes abi_serializer::_variant_to_binary( const std::string_view& type, const fc::variant& var, impl::variant_to_binary_context& ctx )const
    { try {
       auto h = ctx.enter_scope();
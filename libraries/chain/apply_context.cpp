@@ -365,7 +365,8 @@ void apply_context::execute_inline( action&& a ) {
                                       std::bind(&transaction_context::checktime, &this->trx_context),
                                       false,
                                       trx_context.is_read_only,
-                                      inherited_authorizations
+                                      inherited_authorizations,
+                                      &trx_context.auth_check_cache
                                     );
 
          //QUESTION: Is it smart to allow a deferred transaction that has been delayed for some time to get away
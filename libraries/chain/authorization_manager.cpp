@@ -110,7 +110,23 @@ namespace eosio { namespace chain {
       });
    }
 
+   void authorization_manager::state_changed() {
+      ++_version;
+      _minimum_permissions.clear();
+      _minimum_permissions_size = 0;
+   }
+
+   void authorization_manager::state_changed( account_name account ) {
+      ++_version;
+      auto itr = _minimum_permissions.find( account );
+      if( itr != _minimum_permissions.end() ) {
+         _minimum_permissions_size -= itr->second.size();
+         _minimum_permissions.erase( itr );
+      }
+   }
+
    void authorization_manager::read_from_snapshot( const snapshot_reader_ptr& snapshot ) {
+      state_changed();
       authorization_index_set::walk_indices([this, &snapshot]( auto utils ){
          using section_t = typename decltype(utils)::index_t::value_type;
 
@@ -146,6 +162,7 @@ namespace eosio { namespace chain {
          creation_time = _control.pending_block_time();
       }
 
+      ++_version;
       const auto& perm_usage = _db.create<permission_usage_object>([&](auto& p) {
          p.last_used = creation_time;
       });
@@ -181,6 +198,7 @@ namespace eosio { namespace chain {
          creation_time = _control.pending_block_time();
       }
 
+      ++_version;
       const auto& perm_usage = _db.create<permission_usage_object>([&](auto& p) {
          p.last_used = creation_time;
       });
@@ -205,6 +223,7 @@ namespace eosio { namespace chain {
          EOS_ASSERT(k.key.which() < _db.get<protocol_state_object>().num_supported_key_types, unactivated_key_type,
            "Unactivated key type used when modifying permission");
 
+      ++_version;
       _db.modify( permission, [&](permission_object& po) {
          auto dm_logger = _control.get_deep_mind_logger();
 
@@ -228,6 +247,7 @@ namespace eosio { namespace chain {
       EOS_ASSERT( range.first == range.second, action_validate_exception,
                   "Cannot remove a permission which has children. Remove the children first.");
 
+      state_changed( permission.owner );
       _db.get_mutable_index<permission_usage_index>().remove_object( permission.usage_id._id );
 
       if (auto dm_logger = _control.get_deep_mind_logger()) {
@@ -311,6 +331,40 @@ namespace eosio { namespace chain {
       } FC_CAPTURE_AND_RETHROW((authorizer_account)(scope)(act_name))
    }
 
+   const authorization_manager::minimum_permission&
+   authorization_manager::get_minimum_permission( account_name authorizer_account,
+                                                  scope_name code_account,
+                                                  action_name type
+                                                )const
+   {
+      if( _minimum_permissions_size >= max_minimum_permissions ) {
+         _minimum_permissions.clear();
+         _minimum_permissions_size = 0;
+      }
+
+      auto& of_account = _minimum_permissions[authorizer_account];
+      const auto key = std::make_pair( code_account, type );
+      auto itr = of_account.find( key );
+      if( itr != of_account.end() )
+         return itr->second;
+
+      minimum_permission result;
+      auto min_permission_name = lookup_minimum_permission( authorizer_account, code_account, type );
+      if( min_permission_name ) {
+         const permission_object* perm = &get_permission( {authorizer_account, *min_permission_name} );
+         result.name = perm->name;
+         result.satisfied_by.insert( perm->name );
+         while( perm->parent._id != 0 ) {
+            perm = &_db.get<permission_object, by_id>( perm->parent );
+            result.satisfied_by.insert( perm->name );
+         }
+      } else {
+         result.any = true;
+      }
+      ++_minimum_permissions_size;
+      return of_account.emplace( key, std::move(result) ).first->second;
+   }
+
    void authorization_manager::check_updateauth_authorization( const updateauth& update,
                                                                const vector<permission_level>& auths
                                                              )const
@@ -468,17 +522,36 @@ namespace eosio { namespace chain {
                                                const std::function<void()>&         _checktime,
                                                bool                                 allow_unused_keys,
                                                bool                                 check_but_dont_fail,
-                                               const flat_set<permission_level>&    satisfied_authorizations
+                                               const flat_set<permission_level>&    satisfied_authorizations,
+                                               check_cache*                         cache
                                              )const
    {
       const auto& checktime = ( static_cast<bool>(_checktime) ? _checktime : _noop_checktime );
 
-      auto delay_max_limit = fc::seconds( _control.get_global_properties().configuration.max_transaction_delay );
+      const auto& configuration = _control.get_global_properties().configuration;
+
+      auto delay_max_limit = fc::seconds( configuration.max_transaction_delay );
 
       auto effective_provided_delay =  (provided_delay >= delay_max_limit) ? fc::microseconds::maximum() : provided_delay;
 
+      // keys are only tracked by the checker, skipping it would report them as unused
+      if( cache && !provided_keys.empty() ) {
+         cache = nullptr;
+      }
+      if( cache && ( cache->version != _version
+                     || cache->max_authority_depth != configuration.max_authority_depth
+                     || cache->provided_delay != effective_provided_delay
+                     || cache->provided_permissions != provided_permissions ) ) {
+         cache->version = _version;
+         cache->max_authority_depth = configuration.max_authority_depth;
+         cache->provided_delay = effective_provided_delay;
+         cache->provided_permissions = provided_permissions;
+         cache->relevant.clear();
+         cache->satisfied.clear();
+      }
+
       auto checker = make_auth_checker( [&](const permission_level& p){ return get_permission(p).auth; },
-                                        _control.get_global_properties().configuration.max_authority_depth,
+                                        configuration.max_authority_depth,
                                         provided_keys,
                                         provided_permissions,
                                         effective_provided_delay,
@@ -513,15 +586,17 @@ namespace eosio { namespace chain {
 
             checktime();
 
-            if( !special_case ) {
-               auto min_permission_name = lookup_minimum_permission(declared_auth.actor, act.account, act.name);
-               if( min_permission_name ) { // since special cases were already handled, it should only be false if the permission is eosio.any
-                  const auto& min_permission = get_permission({declared_auth.actor, *min_permission_name});
-                  EOS_ASSERT( get_permission(declared_auth).satisfies( min_permission,
-                                                                       _db.get_index<permission_index>().indices() ),
-                              irrelevant_auth_exception,
-                              "action declares irrelevant authority '${auth}'; minimum authority is ${min}",
-                              ("auth", declared_auth)("min", permission_level{min_permission.owner, min_permission.name}) );
+            if( !special_case && !( cache && cache->relevant.count( {declared_auth, act.account, act.name} ) ) ) {
+               // since special cases were already handled, any is only set if the permission is eosio.any
+               const auto& min_permission = get_minimum_permission( declared_auth.actor, act.account, act.name );
+               if( !min_permission.any && !min_permission.satisfied_by.count( declared_auth.permission ) ) {
+                  get_permission( declared_auth ); // an unknown permission is reported as such
+                  EOS_THROW( irrelevant_auth_exception,
+                             "action declares irrelevant authority '${auth}'; minimum authority is ${min}",
+                             ("auth", declared_auth)("min", permission_level{declared_auth.actor, min_permission.name}) );
+               }
+               if( cache ) {
+                  cache->relevant.emplace( declared_auth, act.account, act.name );
                }
             }
 
@@ -543,7 +618,18 @@ namespace eosio { namespace chain {
       // ascending order of the actor name with ties broken by ascending order of the permission name.
       for( const auto& p : permissions_to_satisfy ) {
          checktime(); // TODO: this should eventually move into authority_checker instead
-         EOS_ASSERT( checker.satisfied( p.first, p.second ) || check_but_dont_fail, unsatisfied_authorization,
+         if( cache ) {
+            // a permission satisfied with some delay is also satisfied with any larger delay
+            auto itr = cache->satisfied.find( p.first );
+            if( itr != cache->satisfied.end() && itr->second <= p.second ) {
+               continue;
+            }
+         }
+         bool satisfied = checker.satisfied( p.first, p.second );
+         if( satisfied && cache ) {
+            cache->satisfied[p.first] = p.second;
+         }
+         EOS_ASSERT( satisfied || check_but_dont_fail, unsatisfied_authorization,
                      "transaction declares authority '${auth}', "
                      "but does not have signatures for it under a provided delay of ${provided_delay} ms, "
                      "provided permissions ${provided_permissions}, provided keys ${provided_keys}, "
@@ -3,6 +3,7 @@
 #include <fc/bitutil.hpp>
 #include <fc/io/cfile.hpp>
 #include <fc/io/raw.hpp>
+#include <mutex>
 
 
 #define LOG_READ  (std::ios::in | std::ios::binary)
@@ -49,6 +50,7 @@ namespace eosio { namespace chain {
             uint32_t                 index_first_block_num = 0; //the first number in index & the log had it not been pruned
             std::optional<block_log_prune_config> prune_config;
             bool                     not_generate_block_log = false;
+            std::mutex               read_mtx; // reads by number may come from several API threads, they share the file positions
 
             explicit block_log_impl(std::optional<block_log_prune_config> prune_conf) :
               prune_config(prune_conf) {
@@ -682,6 +684,7 @@ namespace eosio { namespace chain {
 
    signed_block_ptr block_log::read_block_by_num(uint32_t block_num)const {
       try {
+         std::lock_guard<std::mutex> g(my->read_mtx);
          signed_block_ptr b;
 
          if (my->not_generate_block_log) {
@@ -701,6 +704,7 @@ namespace eosio { namespace chain {
 
    block_id_type block_log::read_block_id_by_num(uint32_t block_num)const {
       try {
+         std::lock_guard<std::mutex> g(my->read_mtx);
          if (my->not_generate_block_log) {
             return {};
          }
@@ -23,6 +23,7 @@
 #include <eosio/chain/resource_limits.hpp>
 #include <eosio/chain/chain_snapshot.hpp>
 #include <eosio/chain/thread_utils.hpp>
+#include <eosio/chain/sha256_batch.hpp>
 #include <eosio/chain/platform_timer.hpp>
 #include <eosio/chain/deep_mind.hpp>
 
@@ -115,7 +116,7 @@ struct building_block {
                    const vector<digest_type>& new_protocol_feature_activations )
    :_pending_block_header_state( prev.next( when, num_prev_blocks_to_confirm ) )
    ,_new_protocol_feature_activations( new_protocol_feature_activations )
-   ,_trx_mroot_or_receipt_digests( digests_t{} )
+   ,_trx_mroot_or_receipt_digests( merkle_builder{} )
    {}
 
    pending_block_header_state                 _pending_block_header_state;
@@ -124,8 +125,8 @@ struct building_block {
    size_t                                     _num_new_protocol_features_that_have_activated = 0;
    deque<transaction_metadata_ptr>            _pending_trx_metas;
    deque<transaction_receipt>                 _pending_trx_receipts; // boost deque in 1.71 with 1024 elements performs better
-   std::variant<checksum256_type, digests_t>  _trx_mroot_or_receipt_digests;
-   digests_t                                  _action_receipt_digests;
+   std::variant<checksum256_type, merkle_builder> _trx_mroot_or_receipt_digests; // merkle built as receipts are pushed
+   merkle_builder                             _action_receipt_digests;
 };
 
 struct assembled_block {
@@ -218,6 +219,7 @@ struct controller_impl {
    reset_new_handler               rnh; // placed here to allow for this to be set before constructing the other fields
    controller&                     self;
    std::function<void()>           shutdown;
+   writer_priority_mutex           state_mutex; ///< see controller::get_state_mutex
    chainbase::database             db;
    block_log                       blog;
    std::optional<pending_state>    pending;
@@ -226,6 +228,7 @@ struct controller_impl {
    wasm_interface                  wasmif;
    resource_limits_manager         resource_limits;
    authorization_manager           authorization;
+   uint64_t                        pending_auth_state_version = 0; ///< authorization version when pending was started or pushed
    protocol_feature_manager        protocol_features;
    controller::config              conf;
    const chain_id_type             chain_id; // read by thread_pool threads, value will not be changed
@@ -262,6 +265,7 @@ struct controller_impl {
       head = prev;
 
       db.undo();
+      authorization.state_changed();
 
       protocol_features.popped_blocks_to( prev->block_num );
    }
@@ -714,6 +718,9 @@ struct controller_impl {
          ilog( "chain database started with hash: ${hash}", ("hash", calculate_integrity_hash()) );
       okay_to_print_integrity_hash_on_stop = true;
 
+      wasmif.eosvmoc_warmup( check_shutdown );
+      if( check_shutdown() ) return;
+
       replay( check_shutdown ); // replay any irreversible and reversible blocks ahead of current head
 
       if( check_shutdown() ) return;
@@ -1095,13 +1102,20 @@ struct controller_impl {
                                                                              genesis.initial_timestamp );
    }
 
+   void append_action_receipt_digests( const transaction_context& trx_context ) {
+      auto& bb = std::get<building_block>(pending->_block_stage);
+      for( const auto& d : trx_context.executed_action_receipt_digests ) {
+         bb._action_receipt_digests.append( d );
+      }
+   }
+
    // The returned scoped_exit should not exceed the lifetime of the pending which existed when make_block_restore_point was called.
    fc::scoped_exit<std::function<void()>> make_block_restore_point() {
       auto& bb = std::get<building_block>(pending->_block_stage);
       auto orig_trx_receipts_size           = bb._pending_trx_receipts.size();
       auto orig_trx_metas_size              = bb._pending_trx_metas.size();
-      auto orig_trx_receipt_digests_size    = std::holds_alternative<digests_t>(bb._trx_mroot_or_receipt_digests) ?
-                                              std::get<digests_t>(bb._trx_mroot_or_receipt_digests).size() : 0;
+      auto orig_trx_receipt_digests_size    = std::holds_alternative<merkle_builder>(bb._trx_mroot_or_receipt_digests) ?
+                                              std::get<merkle_builder>(bb._trx_mroot_or_receipt_digests).size() : 0;
       auto orig_action_receipt_digests_size = bb._action_receipt_digests.size();
       std::function<void()> callback = [this,
             orig_trx_receipts_size,
@@ -1112,9 +1126,9 @@ struct controller_impl {
          auto& bb = std::get<building_block>(pending->_block_stage);
          bb._pending_trx_receipts.resize(orig_trx_receipts_size);
          bb._pending_trx_metas.resize(orig_trx_metas_size);
-         if( std::holds_alternative<digests_t>(bb._trx_mroot_or_receipt_digests) )
-            std::get<digests_t>(bb._trx_mroot_or_receipt_digests).resize(orig_trx_receipt_digests_size);
-         bb._action_receipt_digests.resize(orig_action_receipt_digests_size);
+         if( std::holds_alternative<merkle_builder>(bb._trx_mroot_or_receipt_digests) )
+            std::get<merkle_builder>(bb._trx_mroot_or_receipt_digests).truncate(orig_trx_receipt_digests_size);
+         bb._action_receipt_digests.truncate(orig_action_receipt_digests_size);
       };
 
       return fc::make_scoped_exit( std::move(callback) );
@@ -1175,8 +1189,7 @@ struct controller_impl {
          auto restore = make_block_restore_point();
          trace->receipt = push_receipt( gtrx.trx_id, transaction_receipt::soft_fail,
                                         trx_context.billed_cpu_time_us, trace->net_usage );
-         fc::move_append( std::get<building_block>(pending->_block_stage)._action_receipt_digests,
-                          std::move(trx_context.executed_action_receipt_digests) );
+         append_action_receipt_digests( trx_context );
 
          trx_context.squash();
          restore.cancel();
@@ -1350,8 +1363,7 @@ struct controller_impl {
                                         trx_context.billed_cpu_time_us,
                                         trace->net_usage );
 
-         fc::move_append( std::get<building_block>(pending->_block_stage)._action_receipt_digests,
-                          std::move(trx_context.executed_action_receipt_digests) );
+         append_action_receipt_digests( trx_context );
 
          trace->account_ram_delta = account_delta( gtrx.payer, trx_removal_ram_delta );
 
@@ -1466,8 +1478,8 @@ struct controller_impl {
       r.net_usage_words      = net_usage_words;
       r.status               = status;
       auto& bb = std::get<building_block>(pending->_block_stage);
-      if( std::holds_alternative<digests_t>(bb._trx_mroot_or_receipt_digests) )
-         std::get<digests_t>(bb._trx_mroot_or_receipt_digests).emplace_back( r.digest() );
+      if( std::holds_alternative<merkle_builder>(bb._trx_mroot_or_receipt_digests) )
+         std::get<merkle_builder>(bb._trx_mroot_or_receipt_digests).append( r.digest() );
       return r;
    }
 
@@ -1566,8 +1578,7 @@ struct controller_impl {
                trace->receipt = r;
             }
 
-            fc::move_append( std::get<building_block>(pending->_block_stage)._action_receipt_digests,
-                             std::move(trx_context.executed_action_receipt_digests) );
+            append_action_receipt_digests( trx_context );
 
             // call the accept signal but only once for this transaction
             if (!trx->read_only) {
@@ -1634,8 +1645,11 @@ struct controller_impl {
       auto guard_pending = fc::make_scoped_exit([this, head_block_num=head->block_num](){
          protocol_features.popped_blocks_to( head_block_num );
          pending.reset();
+         check_undone_auth_state();
       });
 
+      pending_auth_state_version = authorization.version();
+
       if (!self.skip_db_sessions(s)) {
          EOS_ASSERT( db.revision() == head->block_num, database_exception, "db revision is not on par with head block",
                      ("db.revision()", db.revision())("controller_head_block", head->block_num)("fork_db_head_block", fork_db.head()->block_num) );
@@ -1793,18 +1807,6 @@ struct controller_impl {
 
       auto& bb = std::get<building_block>(pending->_block_stage);
 
-      auto action_merkle_fut = async_thread_pool( thread_pool.get_executor(),
-                                                  [ids{std::move( bb._action_receipt_digests )}]() mutable {
-                                                     return merkle( std::move( ids ) );
-                                                  } );
-      const bool calc_trx_merkle = !std::holds_alternative<checksum256_type>(bb._trx_mroot_or_receipt_digests);
-      std::future<checksum256_type> trx_merkle_fut;
-      if( calc_trx_merkle ) {
-         trx_merkle_fut = async_thread_pool( thread_pool.get_executor(),
-                                             [ids{std::move( std::get<digests_t>(bb._trx_mroot_or_receipt_digests) )}]() mutable {
-                                                return merkle( std::move( ids ) );
-                                             } );
-      }
 
       // Update resource limits:
       resource_limits.process_account_limit_updates();
@@ -1818,8 +1820,10 @@ struct controller_impl {
 
       // Create (unsigned) block:
       auto block_ptr = std::make_shared<signed_block>( pbhs.make_block_header(
-         calc_trx_merkle ? trx_merkle_fut.get() : std::get<checksum256_type>(bb._trx_mroot_or_receipt_digests),
-         action_merkle_fut.get(),
+         std::holds_alternative<checksum256_type>(bb._trx_mroot_or_receipt_digests) ?
+            std::get<checksum256_type>(bb._trx_mroot_or_receipt_digests) :
+            std::get<merkle_builder>(bb._trx_mroot_or_receipt_digests).root(),
+         bb._action_receipt_digests.root(),
          bb._new_pending_producer_schedule,
          std::move( bb._new_protocol_feature_activations ),
          protocol_features.get_protocol_feature_set()
@@ -1895,6 +1899,7 @@ struct controller_impl {
 
       // push the state for pending.
       pending->push();
+      pending_auth_state_version = authorization.version();
    }
 
    /**
@@ -2002,6 +2007,8 @@ struct controller_impl {
             use_bsp_cached = true;
          } else {
             trx_metas.reserve( b->transactions.size() );
+            std::vector<size_t> to_recover; // indexes in to trx_metas
+            std::vector<packed_transaction_ptr> to_recover_trxs;
             for( const auto& receipt : b->transactions ) {
                if( std::holds_alternative<packed_transaction>(receipt.trx)) {
                   const auto& pt = std::get<packed_transaction>(receipt.trx);
@@ -2016,12 +2023,18 @@ struct controller_impl {
                            recover_keys_future{} );
                   } else {
                      packed_transaction_ptr ptrx( b, &pt ); // alias signed_block_ptr
-                     auto fut = transaction_metadata::start_recover_keys(
-                           std::move( ptrx ), thread_pool.get_executor(), chain_id, microseconds::maximum(), transaction_metadata::trx_type::input  );
-                     trx_metas.emplace_back( transaction_metadata_ptr{}, std::move( fut ) );
+                     to_recover.emplace_back( trx_metas.size() );
+                     to_recover_trxs.emplace_back( std::move( ptrx ) );
+                     trx_metas.emplace_back( transaction_metadata_ptr{}, recover_keys_future{} );
                   }
                }
             }
+            // recovered together, one task per thread rather than per transaction
+            auto futs = transaction_metadata::start_recover_keys( to_recover_trxs, thread_pool.get_executor(), conf.thread_pool_size,
+                                                                  chain_id, microseconds::maximum(), transaction_metadata::trx_type::input );
+            for( size_t i = 0; i < futs.size(); ++i ) {
+               std::get<1>( trx_metas[to_recover[i]] ) = std::move( futs[i] );
+            }
          }
 
          transaction_trace_ptr trace;
@@ -2332,14 +2345,33 @@ struct controller_impl {
          applied_trxs = pending->extract_trx_metas();
          pending.reset();
          protocol_features.popped_blocks_to( head->block_num );
+         check_undone_auth_state();
       }
       return applied_trxs;
    }
 
+   void check_undone_auth_state() {
+      // permission changes of the discarded pending block are undone, which authorization_manager is not aware of
+      if( authorization.version() != pending_auth_state_version ) {
+         authorization.state_changed();
+         pending_auth_state_version = authorization.version();
+      }
+   }
+
    static checksum256_type calculate_trx_merkle( const deque<transaction_receipt>& trxs ) {
-      deque<digest_type> trx_digests;
-      for( const auto& a : trxs )
-         trx_digests.emplace_back( a.digest() );
+      // receipt digests are hashes of tiny messages, serialize them all and hash as one batch
+      using digest_input = std::array<char, transaction_receipt::max_digest_input_size>;
+      vector<digest_input> bufs( trxs.size() );
+      vector<sha256_batch_input> inputs( trxs.size() );
+      size_t i = 0;
+      for( const auto& a : trxs ) {
+         fc::datastream<char*> ds( bufs[i].data(), bufs[i].size() );
+         a.pack_digest_input( ds );
+         inputs[i] = { bufs[i].data(), size_t( ds.tellp() ) };
+         ++i;
+      }
+      vector<digest_type> trx_digests( trxs.size() );
+      sha256_batch( inputs.data(), inputs.size(), trx_digests.data() );
 
       return merkle( move(trx_digests) );
    }
@@ -2417,102 +2449,11 @@ struct controller_impl {
    }
 
    void check_actor_list( const flat_set<account_name>& actors )const {
-      if( actors.size() == 0 ) return;
-
-      if( conf.actor_whitelist.size() > 0 ) {
-         // throw if actors is not a subset of whitelist
-         const auto& whitelist = conf.actor_whitelist;
-         bool is_subset = true;
-
-         // quick extents check, then brute force the check actors
-         if (*actors.cbegin() >= *whitelist.cbegin() && *actors.crbegin() <= *whitelist.crbegin() ) {
-            auto lower_bound = whitelist.cbegin();
-            for (const auto& actor: actors) {
-               lower_bound = std::lower_bound(lower_bound, whitelist.cend(), actor);
-
-               // if the actor is not found, this is not a subset
-               if (lower_bound == whitelist.cend() || *lower_bound != actor ) {
-                  is_subset = false;
-                  break;
-               }
-
-               // if the actor was found, we are guaranteed that other actors are either not present in the whitelist
-               // or will be present in the range defined as [next actor,end)
-               lower_bound = std::next(lower_bound);
-            }
-         } else {
-            is_subset = false;
-         }
-
-         // helper lambda to lazily calculate the actors for error messaging
-         static auto generate_missing_actors = [](const flat_set<account_name>& actors, const flat_set<account_name>& whitelist) -> vector<account_name> {
-            vector<account_name> excluded;
-            excluded.reserve( actors.size() );
-            set_difference( actors.begin(), actors.end(),
-                            whitelist.begin(), whitelist.end(),
-                            std::back_inserter(excluded) );
-            return excluded;
-         };
-
-         EOS_ASSERT( is_subset,  actor_whitelist_exception,
-                     "authorizing actor(s) in transaction are not on the actor whitelist: ${actors}",
-                     ("actors", generate_missing_actors(actors, whitelist))
-                   );
-      } else if( conf.actor_blacklist.size() > 0 ) {
-         // throw if actors intersects blacklist
-         const auto& blacklist = conf.actor_blacklist;
-         bool intersects = false;
-
-         // quick extents check then brute force check actors
-         if( *actors.cbegin() <= *blacklist.crbegin() && *actors.crbegin() >= *blacklist.cbegin() ) {
-            auto lower_bound = blacklist.cbegin();
-            for (const auto& actor: actors) {
-               lower_bound = std::lower_bound(lower_bound, blacklist.cend(), actor);
-
-               // if the lower bound in the blacklist is at the end, all other actors are guaranteed to
-               // not exist in the blacklist
-               if (lower_bound == blacklist.cend()) {
-                  break;
-               }
-
-               // if the lower bound of an actor IS the actor, then we have an intersection
-               if (*lower_bound == actor) {
-                  intersects = true;
-                  break;
-               }
-            }
-         }
-
-         // helper lambda to lazily calculate the actors for error messaging
-         static auto generate_blacklisted_actors = [](const flat_set<account_name>& actors, const flat_set<account_name>& blacklist) -> vector<account_name> {
-            vector<account_name> blacklisted;
-            blacklisted.reserve( actors.size() );
-            set_intersection( actors.begin(), actors.end(),
-                              blacklist.begin(), blacklist.end(),
-                              std::back_inserter(blacklisted)
-                            );
-            return blacklisted;
-         };
-
-         EOS_ASSERT( !intersects, actor_blacklist_exception,
-                     "authorizing actor(s) in transaction are on the actor blacklist: ${actors}",
-                     ("actors", generate_blacklisted_actors(actors, blacklist))
-                   );
-      }
+      controller::check_actor_list( actors, conf.actor_whitelist, conf.actor_blacklist );
    }
 
    void check_contract_list( account_name code )const {
-      if( conf.contract_whitelist.size() > 0 ) {
-         EOS_ASSERT( conf.contract_whitelist.find( code ) != conf.contract_whitelist.end(),
-                     contract_whitelist_exception,
-                     "account '${code}' is not on the contract whitelist", ("code", code)
-                   );
-      } else if( conf.contract_blacklist.size() > 0 ) {
-         EOS_ASSERT( conf.contract_blacklist.find( code ) == conf.contract_blacklist.end(),
-                     contract_blacklist_exception,
-                     "account '${code}' is on the contract blacklist", ("code", code)
-                   );
-      }
+      controller::check_contract_list( code, conf.contract_whitelist, conf.contract_blacklist );
    }
 
    void check_action_list( account_name code, action_name action )const {
@@ -2630,6 +2571,7 @@ controller::controller( const config& cfg, protocol_feature_set&& pfs, const cha
 }
 
 controller::~controller() {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    my->abort_block();
    /* Shouldn't be needed anymore.
    //close fork_db here, because it can generate "irreversible" signal to this controller,
@@ -2644,24 +2586,30 @@ void controller::add_indices() {
 }
 
 void controller::startup( std::function<void()> shutdown, std::function<bool()> check_shutdown, const snapshot_reader_ptr& snapshot ) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    my->startup(shutdown, check_shutdown, snapshot);
 }
 
 void controller::startup( std::function<void()> shutdown, std::function<bool()> check_shutdown, const genesis_state& genesis ) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    my->startup(shutdown, check_shutdown, genesis);
 }
 
 void controller::startup(std::function<void()> shutdown, std::function<bool()> check_shutdown) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    my->startup(shutdown, check_shutdown);
 }
 
 const chainbase::database& controller::db()const { return my->db; }
 
+writer_priority_mutex& controller::get_state_mutex()const { return my->state_mutex; }
+
 chainbase::database& controller::mutable_db()const { return my->db; }
 
 const fork_database& controller::fork_db()const { return my->fork_db; }
 
 void controller::preactivate_feature( const digest_type& feature_digest ) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    const auto& pfs = my->protocol_features.get_protocol_feature_set();
    auto cur_time = pending_block_time();
 
@@ -2791,6 +2739,7 @@ void controller::validate_protocol_features( const vector<digest_type>& features
 
 void controller::start_block( block_timestamp_type when, uint16_t confirm_block_count )
 {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    validate_db_available_size();
 
    EOS_ASSERT( !my->pending, block_validate_exception, "pending block already exists" );
@@ -2817,6 +2766,7 @@ void controller::start_block( block_timestamp_type when,
                               const vector<digest_type>& new_protocol_feature_activations,
                               const fc::time_point& deadline )
 {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    validate_db_available_size();
 
    if( new_protocol_feature_activations.size() > 0 ) {
@@ -2828,6 +2778,7 @@ void controller::start_block( block_timestamp_type when,
 }
 
 block_state_ptr controller::finalize_block( const signer_callback_type& signer_callback ) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    validate_db_available_size();
 
    my->finalize_block();
@@ -2852,11 +2803,13 @@ block_state_ptr controller::finalize_block( const signer_callback_type& signer_c
 }
 
 void controller::commit_block() {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    validate_db_available_size();
    my->commit_block(true);
 }
 
 deque<transaction_metadata_ptr> controller::abort_block() {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    return my->abort_block();
 }
 
@@ -2872,6 +2825,7 @@ void controller::push_block( controller::block_report& br,
                              std::future<block_state_ptr>& block_state_future,
                              const forked_branch_callback& forked_branch_cb, const trx_meta_cache_lookup& trx_lookup )
 {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    validate_db_available_size();
    my->push_block( br, block_state_future, forked_branch_cb, trx_lookup );
 }
@@ -2880,6 +2834,7 @@ transaction_trace_ptr controller::push_transaction( const transaction_metadata_p
                                                     fc::time_point block_deadline, fc::microseconds max_transaction_time,
                                                     uint32_t billed_cpu_time_us, bool explicit_billed_cpu_time,
                                                     uint32_t subjective_cpu_bill_us ) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    validate_db_available_size();
    EOS_ASSERT( get_read_mode() != db_read_mode::IRREVERSIBLE, transaction_type_exception, "push transaction not allowed in irreversible mode" );
    EOS_ASSERT( trx && !trx->implicit && !trx->scheduled, transaction_type_exception, "Implicit/Scheduled transaction not allowed" );
@@ -2890,6 +2845,7 @@ transaction_trace_ptr controller::push_scheduled_transaction( const transaction_
                                                               fc::time_point block_deadline, fc::microseconds max_transaction_time,
                                                               uint32_t billed_cpu_time_us, bool explicit_billed_cpu_time )
 {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    EOS_ASSERT( get_read_mode() != db_read_mode::IRREVERSIBLE, transaction_type_exception, "push scheduled transaction not allowed in irreversible mode" );
    validate_db_available_size();
    return my->push_scheduled_transaction( trxid, block_deadline, max_transaction_time, billed_cpu_time_us, explicit_billed_cpu_time );
@@ -3112,6 +3068,7 @@ void controller::write_snapshot( const snapshot_writer_ptr& snapshot ) const {
 }
 
 int64_t controller::set_proposed_producers( vector<producer_authority> producers ) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    const auto& gpo = get_global_properties();
    auto cur_block_num = head_block_num() + 1;
 
@@ -3303,6 +3260,105 @@ void controller::check_contract_list( account_name code )const {
    my->check_contract_list( code );
 }
 
+void controller::check_actor_list( const flat_set<account_name>& actors,
+                                   const flat_set<account_name>& whitelist, const flat_set<account_name>& blacklist ) {
+   if( actors.size() == 0 ) return;
+
+   if( whitelist.size() > 0 ) {
+      // throw if actors is not a subset of whitelist
+      bool is_subset = true;
+
+      // quick extents check, then brute force the check actors
+      if (*actors.cbegin() >= *whitelist.cbegin() && *actors.crbegin() <= *whitelist.crbegin() ) {
+         auto lower_bound = whitelist.cbegin();
+         for (const auto& actor: actors) {
+            lower_bound = std::lower_bound(lower_bound, whitelist.cend(), actor);
+
+            // if the actor is not found, this is not a subset
+            if (lower_bound == whitelist.cend() || *lower_bound != actor ) {
+               is_subset = false;
+               break;
+            }
+
+            // if the actor was found, we are guaranteed that other actors are either not present in the whitelist
+            // or will be present in the range defined as [next actor,end)
+            lower_bound = std::next(lower_bound);
+         }
+      } else {
+         is_subset = false;
+      }
+
+      // helper lambda to lazily calculate the actors for error messaging
+      static auto generate_missing_actors = [](const flat_set<account_name>& actors, const flat_set<account_name>& whitelist) -> vector<account_name> {
+         vector<account_name> excluded;
+         excluded.reserve( actors.size() );
+         set_difference( actors.begin(), actors.end(),
+                         whitelist.begin(), whitelist.end(),
+                         std::back_inserter(excluded) );
+         return excluded;
+      };
+
+      EOS_ASSERT( is_subset,  actor_whitelist_exception,
+                  "authorizing actor(s) in transaction are not on the actor whitelist: ${actors}",
+                  ("actors", generate_missing_actors(actors, whitelist))
+                );
+   } else if( blacklist.size() > 0 ) {
+      // throw if actors intersects blacklist
+      bool intersects = false;
+
+      // quick extents check then brute force check actors
+      if( *actors.cbegin() <= *blacklist.crbegin() && *actors.crbegin() >= *blacklist.cbegin() ) {
+         auto lower_bound = blacklist.cbegin();
+         for (const auto& actor: actors) {
+            lower_bound = std::lower_bound(lower_bound, blacklist.cend(), actor);
+
+            // if the lower bound in the blacklist is at the end, all other actors are guaranteed to
+            // not exist in the blacklist
+            if (lower_bound == blacklist.cend()) {
+               break;
+            }
+
+            // if the lower bound of an actor IS the actor, then we have an intersection
+            if (*lower_bound == actor) {
+               intersects = true;
+               break;
+            }
+         }
+      }
+
+      // helper lambda to lazily calculate the actors for error messaging
+      static auto generate_blacklisted_actors = [](const flat_set<account_name>& actors, const flat_set<account_name>& blacklist) -> vector<account_name> {
+         vector<account_name> blacklisted;
+         blacklisted.reserve( actors.size() );
+         set_intersection( actors.begin(), actors.end(),
+                           blacklist.begin(), blacklist.end(),
+                           std::back_inserter(blacklisted)
+                         );
+         return blacklisted;
+      };
+
+      EOS_ASSERT( !intersects, actor_blacklist_exception,
+                  "authorizing actor(s) in transaction are on the actor blacklist: ${actors}",
+                  ("actors", generate_blacklisted_actors(actors, blacklist))
+                );
+   }
+}
+
+void controller::check_contract_list( account_name code,
+                                      const flat_set<account_name>& whitelist, const flat_set<account_name>& blacklist ) {
+   if( whitelist.size() > 0 ) {
+      EOS_ASSERT( whitelist.find( code ) != whitelist.end(),
+                  contract_whitelist_exception,
+                  "account '${code}' is not on the contract whitelist", ("code", code)
+                );
+   } else if( blacklist.size() > 0 ) {
+      EOS_ASSERT( blacklist.find( code ) == blacklist.end(),
+                  contract_blacklist_exception,
+                  "account '${code}' is on the contract blacklist", ("code", code)
+                );
+   }
+}
+
 void controller::check_action_list( account_name code, action_name action )const {
    my->check_action_list( code, action );
 }
@@ -3405,10 +3461,12 @@ uint32_t controller::get_greylist_limit()const {
 }
 
 void controller::add_resource_greylist(const account_name &name) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    my->conf.resource_greylist.insert(name);
 }
 
 void controller::remove_resource_greylist(const account_name &name) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    my->conf.resource_greylist.erase(name);
 }
 
@@ -3422,6 +3480,7 @@ const flat_set<account_name> &controller::get_resource_greylist() const {
 
 
 void controller::add_to_ram_correction( account_name account, uint64_t ram_bytes ) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    auto ptr = my->db.find<account_ram_correction_object, by_name>( account );
    if( ptr ) {
       my->db.modify<account_ram_correction_object>( *ptr, [&]( auto& rco ) {
@@ -3526,6 +3585,7 @@ std::optional<chain_id_type> controller::extract_chain_id_from_db( const path& s
 }
 
 void controller::replace_producer_keys( const public_key_type& key ) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    ilog("Replace producer keys with ${k}", ("k", key));
    mutable_db().modify( db().get<global_property_object>(), [&]( auto& gp ) {
       gp.proposed_schedule_block_num = {};
@@ -3545,6 +3605,7 @@ void controller::replace_producer_keys( const public_key_type& key ) {
 }
 
 void controller::replace_account_keys( name account, name permission, const public_key_type& key ) {
+   std::lock_guard<writer_priority_mutex> g( my->state_mutex );
    auto& rlm = get_mutable_resource_limits_manager();
    auto* perm = db().find<permission_object, by_owner>(boost::make_tuple(account, permission));
    if (!perm)
@@ -3553,6 +3614,7 @@ void controller::replace_account_keys( name account, name permission, const publ
    mutable_db().modify(*perm, [&](auto& p) {
       p.auth = authority(key);
    });
+   my->authorization.state_changed( account );
    int64_t new_size = (int64_t)(chain::config::billable_size_v<permission_object> + perm->auth.get_billable_size());
    rlm.add_pending_ram_usage(account, new_size - old_size);
    rlm.verify_account_ram_usage(account);
@@ -389,6 +389,8 @@ void apply_eosio_linkauth(apply_context& context) {
       auto link_key = boost::make_tuple(requirement.account, requirement.code, requirement.type);
       auto link = db.find<permission_link_object, by_action_name>(link_key);
 
+      context.control.get_mutable_authorization_manager().state_changed( requirement.account );
+
       if( link ) {
          EOS_ASSERT(link->required_permission != requirement.requirement, action_validate_exception,
                     "Attempting to update required authority, but new requirement is same as old");
@@ -438,6 +440,7 @@ void apply_eosio_unlinkauth(apply_context& context) {
    );
 
    db.remove(*link);
+   context.control.get_mutable_authorization_manager().state_changed( unlink.account );
 }
 
 void apply_eosio_canceldelay(apply_context& context) {
@@ -4,6 +4,7 @@
 #include <eosio/chain/contract_types.hpp>
 #include <eosio/chain/exceptions.hpp>
 #include <utility>
+#include <set>
 #include <fc/variant_object.hpp>
 #include <fc/scoped_exit.hpp>
 
@@ -36,6 +37,10 @@ struct abi_serializer {
 
    abi_serializer(){ configure_built_in_types(); }
    abi_serializer( const abi_def& abi, const yield_function_t& yield );
+   abi_serializer( const abi_serializer& other );
+   abi_serializer( abi_serializer&& ) = default;
+   abi_serializer& operator=( const abi_serializer& other );
+   abi_serializer& operator=( abi_serializer&& ) = default;
    [[deprecated("use the overload with yield_function_t[=create_yield_function(max_serialization_time)]")]]
    abi_serializer( const abi_def& abi, const fc::microseconds& max_serialization_time );
    void set_abi( const abi_def& abi, const yield_function_t& yield );
@@ -73,6 +78,20 @@ struct abi_serializer {
    [[deprecated("use the overload with yield_function_t[=create_yield_function(max_serialization_time)]")]]
    fc::variant binary_to_variant( const std::string_view& type, fc::datastream<const char*>& binary, const fc::microseconds& max_serialization_time, bool short_path = false )const;
 
+   /**
+    * Same output as fc::json::to_string of binary_to_variant, written to `out` while unpacking instead of first
+    * building the fc::variant tree, for responses with many or large objects.
+    */
+   void        binary_to_json( const std::string_view& type, fc::datastream<const char*>& binary, std::string& out, const yield_function_t& yield, bool short_path = false )const;
+   std::string binary_to_json( const std::string_view& type, const bytes& binary, const yield_function_t& yield, bool short_path = false )const;
+   /**
+    * binary_to_json of a struct with only the given fields, in the order of the struct. Unpacking stops after the last
+    * of them, the other fields before it are read past without creating their JSON. fields must be fields of the
+    * struct or its bases without duplicates, otherwise the whole struct is read.
+    */
+   void        binary_to_json( const std::string_view& type, fc::datastream<const char*>& binary, std::string& out,
+                               const vector<string>& fields, const yield_function_t& yield, bool short_path = false )const;
+
    [[deprecated("use the overload with yield_function_t[=create_yield_function(max_serialization_time)]")]]
    bytes       variant_to_binary( const std::string_view& type, const fc::variant& var, const fc::microseconds& max_serialization_time, bool short_path = false )const;
    bytes       variant_to_binary( const std::string_view& type, const fc::variant& var, const yield_function_t& yield, bool short_path = false )const;
@@ -148,16 +167,88 @@ private:
    map<name,type_name>                        action_results;
 
    map<type_name, pair<unpack_function, pack_function>, std::less<>> built_in_types;
+   std::set<type_name, std::less<>>                                  specialized_types; ///< replaced by add_specialized_unpack_pack
    void configure_built_in_types();
 
+   /**
+    *  A type of the ABI with its name already resolved and classified, so that packing and unpacking follow
+    *  indexes instead of looking up typedefs, built-in types, variants and structs by name for every value.
+    *  Holds iterators into the maps above, so the plans are rebuilt whenever the serializer is copied.
+    */
+   struct type_plan {
+      enum class kind_t : uint8_t { unknown, built_in, array, optional, variant, structure };
+      /// built-in types written to JSON without going through fc::variant
+      enum class json_t : uint8_t { variant, boolean, int8, uint8, int16, uint16, int32, uint32, varint32, varuint32, name };
+
+      struct field_plan {
+         uint32_t          type = 0;
+         std::string_view  unresolved_type;    ///< without `$`, for error messages
+         bool              extension = false;
+         bool              bytes = false;      ///< resolves to bytes, trimmed when logging
+      };
+
+      kind_t                                              kind = kind_t::unknown;
+      std::string_view                                    type;          ///< resolved
+      std::string_view                                    fundamental;   ///< of type
+      const pair<unpack_function, pack_function>*         built_in = nullptr;
+      json_t                                              json = json_t::variant;
+      uint32_t                                            packed_size = 0;  ///< of a built-in of fixed size, of its elements if array or optional
+      bool                                                length_prefixed = false; ///< bytes and string, read past by their size
+      bool                                                is_array = false;
+      bool                                                is_optional = false;
+      uint32_t                                            element = 0;   ///< array and optional
+      std::string_view                                    element_name;
+      map<type_name, variant_def>::const_iterator         variant_itr;
+      vector<uint32_t>                                    variant_types;
+      bool                                                has_struct = false; ///< also set for a struct used as a base only
+      map<type_name, struct_def>::const_iterator          struct_itr;
+      std::optional<uint32_t>                             base;
+      std::string_view                                    base_name;
+      vector<field_plan>                                  fields;
+      bool                                                json_object = true; ///< false if a field name repeats one of a base
+   };
+
+   struct compiled_types {
+      vector<type_plan>                        plans;
+      map<type_name, uint32_t, std::less<>>    ids;   ///< resolved type name to index of plans
+   };
+
+   compiled_types compiled;
+
+   void     compile_types( impl::abi_traverse_context& ctx );
+   uint32_t _compile_type( compiled_types& ct, const std::string_view& type, impl::abi_traverse_context& ctx )const;
+
    fc::variant _binary_to_variant( const std::string_view& type, const bytes& binary, impl::binary_to_variant_context& ctx )const;
    fc::variant _binary_to_variant( const std::string_view& type, fc::datastream<const char*>& binary, impl::binary_to_variant_context& ctx )const;
-   void        _binary_to_variant( const std::string_view& type, fc::datastream<const char*>& stream,
+   fc::variant _binary_to_variant( const compiled_types& ct, uint32_t type, fc::datastream<const char*>& stream,
+                                   impl::binary_to_variant_context& ctx )const;
+   void        _binary_to_variant( const compiled_types& ct, const type_plan& plan, fc::datastream<const char*>& stream,
                                    fc::mutable_variant_object& obj, impl::binary_to_variant_context& ctx )const;
 
+   void        _binary_to_json( const std::string_view& type, fc::datastream<const char*>& stream, std::string& out,
+                                impl::binary_to_variant_context& ctx )const;
+   void        _binary_to_json( const compiled_types& ct, uint32_t type, fc::datastream<const char*>& stream, std::string& out,
+                                impl::binary_to_variant_context& ctx )const;
+   /// fields of a struct to write, and how many of them are still to come
+   struct field_selection {
+      const vector<string>& fields;
+      size_t                remaining = 0;
+   };
+
+   void        _binary_to_json( const compiled_types& ct, const type_plan& plan, fc::datastream<const char*>& stream, std::string& out,
+                                bool& empty, impl::binary_to_variant_context& ctx, field_selection* selection = nullptr )const;
+
+   /// reads past a value of type in stream, checking only its size
+   void        _skip_binary( const compiled_types& ct, uint32_t type, fc::datastream<const char*>& stream,
+                             impl::binary_to_variant_context& ctx )const;
+   void        _skip_binary( const compiled_types& ct, const type_plan& plan, fc::datastream<const char*>& stream,
+                             impl::binary_to_variant_context& ctx )const;
+
    bytes       _variant_to_binary( const std::string_view& type, const fc::variant& var, impl::variant_to_binary_context& ctx )const;
    void        _variant_to_binary( const std::string_view& type, const fc::variant& var,
                                    fc::datastream<char*>& ds, impl::variant_to_binary_context& ctx )const;
+   void        _variant_to_binary( const compiled_types& ct, uint32_t type, const std::string_view& unresolved_type, const fc::variant& var,
+                                   fc::datastream<char*>& ds, impl::variant_to_binary_context& ctx )const;
 
    static std::string_view _remove_bin_extension(const std::string_view& type);
    bool _is_type( const std::string_view& type, impl::abi_traverse_context& ctx )const;
@@ -181,7 +272,7 @@ namespace impl {
       bool is_logging() const { return log; }
 
       void check_deadline()const { yield( recursion_depth ); }
-      abi_serializer::yield_function_t get_yield_function() { return yield; }
+      const abi_serializer::yield_function_t& get_yield_function()const { return yield; }
 
       fc::scoped_exit<std::function<void()>> enter_scope();
 
@@ -4,8 +4,12 @@
 #include <eosio/chain/permission_object.hpp>
 #include <eosio/chain/snapshot.hpp>
 
+#include <boost/functional/hash.hpp>
+
 #include <utility>
 #include <functional>
+#include <tuple>
+#include <unordered_map>
 
 namespace eosio { namespace chain {
 
@@ -20,6 +24,23 @@ namespace eosio { namespace chain {
       public:
          using permission_id_type = permission_object::id_type;
 
+         /**
+          * Authorization checks that passed, so that later checks of the same authorities can skip them. Valid only
+          * for checks without provided keys and with the same provided permissions and delay, which is the case for
+          * the inline actions of a transaction. Dropped as soon as any permission or permission link changes, so
+          * it must not outlive the state it was filled from; a transaction_context owns one.
+          */
+         struct check_cache {
+            uint64_t                                                  version = 0;
+            uint16_t                                                  max_authority_depth = 0;
+            fc::microseconds                                          provided_delay;
+            flat_set<permission_level>                                provided_permissions;
+            /// declared authorization, code, action of authorizations found relevant
+            flat_set<std::tuple<permission_level, account_name, action_name>>  relevant;
+            /// permissions satisfied and the lowest delay they were satisfied with
+            flat_map<permission_level, fc::microseconds>              satisfied;
+         };
+
          explicit authorization_manager(controller& c, chainbase::database& d);
 
          void add_indices();
@@ -47,6 +68,14 @@ namespace eosio { namespace chain {
 
          void update_permission_usage( const permission_object& permission );
 
+         /// Must be called when changes to permissions or permission links are undone, invalidates each check_cache
+         /// and the minimum permission index
+         void state_changed();
+         /// Must be called when permissions or permission links of account are changed outside of this class,
+         /// invalidates each check_cache and the minimum permissions of account
+         void state_changed( account_name account );
+         uint64_t version()const { return _version; }
+
          fc::time_point get_permission_last_used( const permission_object& permission )const;
 
          const permission_object*  find_permission( const permission_level& level )const;
@@ -73,6 +102,7 @@ namespace eosio { namespace chain {
           *  @param provided_delay - the delay satisfied by the transaction
           *  @param checktime - the function that can be called to track CPU usage and time during the process of checking authorization
           *  @param allow_unused_keys - true if method should not assert on unused keys
+          *  @param cache - if not null, results of earlier checks recorded in it are reused and new ones added
           */
          void
          check_authorization( const vector<action>&                actions,
@@ -82,7 +112,8 @@ namespace eosio { namespace chain {
                               const std::function<void()>&         checktime = std::function<void()>(),
                               bool                                 allow_unused_keys = false,
                               bool                                 check_but_dont_fail = false,
-                              const flat_set<permission_level>&    satisfied_authorizations = flat_set<permission_level>()
+                              const flat_set<permission_level>&    satisfied_authorizations = flat_set<permission_level>(),
+                              check_cache*                         cache = nullptr
                             )const;
 
 
@@ -118,6 +149,42 @@ namespace eosio { namespace chain {
       private:
          const controller&    _control;
          chainbase::database& _db;
+         /// incremented on every change to permissions or permission links
+         uint64_t             _version = 1;
+
+         /// the minimum permission of an (account, code, action) and the permissions of account that satisfy it
+         struct minimum_permission {
+            bool                        any = false; ///< linked to eosio.any, every permission satisfies it
+            permission_name             name;
+            flat_set<permission_name>   satisfied_by; ///< the minimum permission and its ancestors
+         };
+         /// names are chosen by users, so they are mixed rather than hashed by identity
+         struct link_key_hash {
+            size_t operator()( account_name a )const {
+               size_t seed = 0;
+               boost::hash_combine( seed, a.to_uint64_t() );
+               return seed;
+            }
+            size_t operator()( const std::pair<account_name, action_name>& k )const {
+               size_t seed = 0;
+               boost::hash_combine( seed, k.first.to_uint64_t() );
+               boost::hash_combine( seed, k.second.to_uint64_t() );
+               return seed;
+            }
+         };
+         using minimum_permissions_of_account =
+            std::unordered_map<std::pair<account_name, action_name>, minimum_permission, link_key_hash>;
+         static constexpr size_t max_minimum_permissions = 64*1024;
+         /// Flattened permission_link_index and permission parent chains by authorizer account, then (code, action).
+         /// Entries are built lazily and dropped for an account when its permissions or links change, or entirely when
+         /// changes are undone. Only used by check_authorization, which runs on the main thread.
+         mutable std::unordered_map<account_name, minimum_permissions_of_account, link_key_hash>  _minimum_permissions;
+         mutable size_t                                                                           _minimum_permissions_size = 0;
+
+         const minimum_permission& get_minimum_permission( account_name authorizer_account,
+                                                           scope_name code_account,
+                                                           action_name type
+                                                         )const;
 
          void             check_updateauth_authorization( const updateauth& update, const vector<permission_level>& auths )const;
          void             check_deleteauth_authorization( const deleteauth& del, const vector<permission_level>& auths )const;
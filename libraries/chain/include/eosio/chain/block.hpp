@@ -38,15 +38,22 @@ namespace eosio { namespace chain {
 
       std::variant<transaction_id_type, packed_transaction> trx;
 
-      digest_type digest()const {
-         digest_type::encoder enc;
-         fc::raw::pack( enc, status );
-         fc::raw::pack( enc, cpu_usage_us );
-         fc::raw::pack( enc, net_usage_words );
+      /// bytes hashed by digest(), at most max_digest_input_size
+      template<typename Stream>
+      void pack_digest_input( Stream& s )const {
+         fc::raw::pack( s, status );
+         fc::raw::pack( s, cpu_usage_us );
+         fc::raw::pack( s, net_usage_words );
          if( std::holds_alternative<transaction_id_type>(trx) )
-            fc::raw::pack( enc, std::get<transaction_id_type>(trx) );
+            fc::raw::pack( s, std::get<transaction_id_type>(trx) );
          else
-            fc::raw::pack( enc, std::get<packed_transaction>(trx).packed_digest() );
+            fc::raw::pack( s, std::get<packed_transaction>(trx).packed_digest() );
+      }
+      static constexpr size_t max_digest_input_size = 1 + 4 + 5 + 32;
+
+      digest_type digest()const {
+         digest_type::encoder enc;
+         pack_digest_input( enc );
          return enc.result();
       }
    };
@@ -3,6 +3,7 @@
 #include <eosio/chain/block_log.hpp>
 #include <eosio/chain/trace.hpp>
 #include <eosio/chain/genesis_state.hpp>
+#include <eosio/chain/writer_priority_mutex.hpp>
 #include <chainbase/pinnable_mapped_file.hpp>
 #include <boost/signals2/signal.hpp>
 
@@ -191,6 +192,13 @@ namespace eosio { namespace chain {
 
          const chainbase::database& db()const;
 
+         /**
+          * Held exclusively by each call that changes chain state, e.g. one push_transaction. Threads other than the
+          * main thread hold it shared to read a consistent view of the chain between two such calls; that view
+          * includes the transactions applied to the pending block so far, as the main thread API calls always did.
+          */
+         writer_priority_mutex& get_state_mutex()const;
+
          const fork_database& fork_db()const;
 
          const account_object&                 get_account( account_name n )const;
@@ -262,6 +270,11 @@ namespace eosio { namespace chain {
          bool sender_avoids_whitelist_blacklist_enforcement( account_name sender )const;
          void check_actor_list( const flat_set<account_name>& actors )const;
          void check_contract_list( account_name code )const;
+         /// Thread safe, checks against the provided lists instead of the configured ones
+         static void check_actor_list( const flat_set<account_name>& actors,
+                                       const flat_set<account_name>& whitelist, const flat_set<account_name>& blacklist );
+         static void check_contract_list( account_name code,
+                                          const flat_set<account_name>& whitelist, const flat_set<account_name>& blacklist );
          void check_action_list( account_name code, action_name action )const;
          void check_key_list( const public_key_type& key )const;
          bool is_building_block()const;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace eosio { namespace chain {
+
+   /**
+    * Thread safe queue that takes turns between keys.
+    *
+    * Each key has its own FIFO queue. pop takes the oldest item of the key whose turn it is, then moves that key to the
+    * back of the line, so a key with many items queued gets one item through per round and cannot delay the items of
+    * the other keys. Keys without items are dropped.
+    */
+   template<typename Key, typename T, typename Hash = std::hash<Key>>
+   class fair_queue {
+   public:
+      void push( const Key& key, T item ) {
+         std::lock_guard<std::mutex> g( _mtx );
+         auto& q = _queues[key];
+         if( q.empty() )
+            _turns.push_back( key );
+         q.push_back( std::move( item ) );
+         ++_size;
+      }
+
+      /// @return the next item, nothing if empty
+      std::optional<T> pop() {
+         std::lock_guard<std::mutex> g( _mtx );
+         if( _turns.empty() )
+            return {};
+         Key key = std::move( _turns.front() );
+         _turns.pop_front();
+         auto itr = _queues.find( key );
+         std::optional<T> item( std::move( itr->second.front() ) );
+         itr->second.pop_front();
+         if( itr->second.empty() )
+            _queues.erase( itr );
+         else
+            _turns.push_back( std::move( key ) );
+         --_size;
+         return item;
+      }
+
+      size_t size() const {
+         std::lock_guard<std::mutex> g( _mtx );
+         return _size;
+      }
+
+      /// number of keys with items queued
+      size_t keys() const {
+         std::lock_guard<std::mutex> g( _mtx );
+         return _queues.size();
+      }
+
+   private:
+      mutable std::mutex                               _mtx;
+      std::unordered_map<Key, std::deque<T>, Hash>     _queues;
+      std::deque<Key>                                  _turns; // keys with items, next turn first
+      size_t                                           _size = 0;
+   };
+
+} } // eosio::chain
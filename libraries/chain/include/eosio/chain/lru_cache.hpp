@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace eosio { namespace chain {
+
+   /**
+    * Thread safe least recently used cache limited by the total size of its values.
+    *
+    * The size of each value is given by the caller on insertion. Inserting evicts the least recently used entries
+    * until the new one fits, a value larger than the whole budget is not cached. Value is returned by copy, use a
+    * shared_ptr for large values.
+    */
+   template<typename Key, typename Value, typename Hash = std::hash<Key>>
+   class lru_cache {
+   public:
+      struct stats {
+         uint64_t hits = 0;
+         uint64_t misses = 0;
+         uint64_t entries = 0;
+         uint64_t bytes = 0;
+      };
+
+      explicit lru_cache( size_t max_bytes = 0 ) : _max_bytes( max_bytes ) {}
+
+      /// Not thread safe, call before use. 0 disables the cache.
+      void set_max_bytes( size_t max_bytes ) { _max_bytes = max_bytes; }
+
+      bool enabled() const { return _max_bytes > 0; }
+
+      /// @return value of key if cached, and makes it the most recently used
+      std::optional<Value> get( const Key& key ) {
+         std::lock_guard<std::mutex> g( _mtx );
+         auto itr = _index.find( key );
+         if( itr == _index.end() ) {
+            ++_misses;
+            return {};
+         }
+         ++_hits;
+         _entries.splice( _entries.begin(), _entries, itr->second );
+         return itr->second->value;
+      }
+
+      /// inserts or replaces the value of key
+      void put( const Key& key, Value value, size_t size ) {
+         if( size > _max_bytes )
+            return;
+         std::lock_guard<std::mutex> g( _mtx );
+         auto itr = _index.find( key );
+         if( itr != _index.end() ) {
+            _bytes -= itr->second->size;
+            _entries.erase( itr->second );
+            _index.erase( itr );
+         }
+         while( _bytes + size > _max_bytes ) {
+            _bytes -= _entries.back().size;
+            _index.erase( _entries.back().key );
+            _entries.pop_back();
+         }
+         _entries.push_front( entry{ key, std::move( value ), size } );
+         _index.emplace( key, _entries.begin() );
+         _bytes += size;
+      }
+
+      void clear() {
+         std::lock_guard<std::mutex> g( _mtx );
+         _index.clear();
+         _entries.clear();
+         _bytes = 0;
+      }
+
+      stats get_stats() const {
+         std::lock_guard<std::mutex> g( _mtx );
+         return stats{ _hits, _misses, _index.size(), _bytes };
+      }
+
+   private:
+      struct entry {
+         Key    key;
+         Value  value;
+         size_t size = 0;
+      };
+      using entry_list = std::list<entry>;
+
+      size_t                                                              _max_bytes = 0;
+      mutable std::mutex                                                  _mtx;
+      entry_list                                                          _entries; // most recently used first
+      std::unordered_map<Key, typename entry_list::iterator, Hash>        _index;
+      size_t                                                              _bytes = 0;
+      uint64_t                                                            _hits = 0;
+      uint64_t                                                            _misses = 0;
+   };
+
+} } // eosio::chain
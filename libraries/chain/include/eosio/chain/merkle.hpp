@@ -18,5 +18,28 @@ namespace eosio { namespace chain {
     *  Calculates the merkle root of a set of digests, if ids is odd it will duplicate the last id.
     */
    digest_type merkle( deque<digest_type> ids );
+   digest_type merkle( vector<digest_type> ids );
+
+   /**
+    *  Builds the same root as merkle() one digest at a time.
+    *
+    *  Every completed pair is combined as soon as its right hand side is appended, so append() costs one hash
+    *  amortized and root() only has to fold the O(log n) unpaired nodes on the right edge of the tree. All levels
+    *  are kept so the builder can be truncated back to an earlier size cheaply, e.g. when a transaction is undone.
+    */
+   class merkle_builder {
+   public:
+      void append( const digest_type& d );
+
+      /// discards all digests appended after the first n
+      void truncate( size_t n );
+
+      size_t size() const { return _levels.empty() ? 0 : _levels.front().size(); }
+
+      digest_type root() const;
+
+   private:
+      vector<vector<digest_type>> _levels; // _levels[k] holds the nodes covering 2^k complete leaves
+   };
 
 } } /// eosio::chain
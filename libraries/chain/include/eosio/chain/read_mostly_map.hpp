@@ -0,0 +1,202 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace eosio { namespace chain {
+
+   /**
+    * Hash map for one writer thread and lookups from any thread, where lookups never lock or wait.
+    *
+    * Each bucket is an immutable linked list published through an atomic head pointer. Inserting prepends a node to
+    * its bucket, erasing publishes copies of the nodes in front of the erased one and shares the ones behind it, and
+    * growing publishes a new bucket array. Nothing is copied beyond the affected bucket except when growing. Values
+    * are never moved, so a value found stays at its address until the writer erases it.
+    *
+    * Memory unlinked by the writer is retired, and freed once no lookup that may still see it is running. A lookup
+    * marks itself running in a counter picked by its thread, one cache line each, so concurrent lookups do not contend;
+    * the writer frees what it retired when it finds every counter at zero.
+    */
+   template<typename Key, typename Value, typename Hash = std::hash<Key>>
+   class read_mostly_map {
+   public:
+      read_mostly_map() : _buckets( new buckets( initial_bucket_count ) ) {}
+
+      read_mostly_map( const read_mostly_map& ) = delete;
+      read_mostly_map& operator=( const read_mostly_map& ) = delete;
+
+      ~read_mostly_map() {
+         free_all( _buckets.load( std::memory_order_relaxed ) );
+         free_retired();
+      }
+
+      /// thread safe, calls on_found with the value of key before returning it
+      template<typename F>
+      const Value* find( const Key& key, F&& on_found ) const {
+         reader_slot& slot = _reader_slots[reader_slot_index()];
+         slot.readers.fetch_add( 1 );
+         const buckets* b = _buckets.load();
+         const Value* result = nullptr;
+         for( const node* n = b->heads[bucket_of( key, *b )].load(); n; n = n->next ) {
+            if( n->key == key ) {
+               result = n->value;
+               on_found( *result );
+               break;
+            }
+         }
+         slot.readers.fetch_sub( 1, std::memory_order_release );
+         return result;
+      }
+
+      /// thread safe
+      const Value* find( const Key& key ) const {
+         return find( key, []( const Value& ) {} );
+      }
+
+      // writer thread only from here on
+
+      size_t size() const { return _size; }
+
+      /// inserts a value constructed from args, replacing the value of key if there is one
+      template<typename... Args>
+      const Value& emplace( const Key& key, Args&&... args ) {
+         auto value = std::make_unique<Value>( std::forward<Args>( args )... );
+         erase( key );
+         if( _size >= _buckets.load( std::memory_order_relaxed )->count )
+            grow();
+         buckets* b = _buckets.load( std::memory_order_relaxed );
+         auto& head = b->heads[bucket_of( key, *b )];
+         head.store( new node{ key, value.get(), head.load( std::memory_order_relaxed ) } );
+         ++_size;
+         reclaim();
+         return *value.release();
+      }
+
+      /// @return true if key was found
+      bool erase( const Key& key ) {
+         buckets* b = _buckets.load( std::memory_order_relaxed );
+         auto& head = b->heads[bucket_of( key, *b )];
+         std::vector<const node*> in_front;
+         const node* found = head.load( std::memory_order_relaxed );
+         for( ; found && !( found->key == key ); found = found->next )
+            in_front.push_back( found );
+         if( !found )
+            return false;
+
+         const node* new_head = found->next;
+         for( auto itr = in_front.rbegin(); itr != in_front.rend(); ++itr )
+            new_head = new node{ ( *itr )->key, ( *itr )->value, new_head };
+         head.store( new_head );
+
+         _retired_nodes.insert( _retired_nodes.end(), in_front.begin(), in_front.end() );
+         _retired_nodes.push_back( found );
+         _retired_values.push_back( found->value );
+         --_size;
+         reclaim();
+         return true;
+      }
+
+      /// calls f with each key and value
+      template<typename F>
+      void for_each( F&& f ) const {
+         const buckets* b = _buckets.load( std::memory_order_relaxed );
+         for( size_t i = 0; i < b->count; ++i ) {
+            for( const node* n = b->heads[i].load( std::memory_order_relaxed ); n; n = n->next )
+               f( n->key, *n->value );
+         }
+      }
+
+      /// frees retired memory if no lookup is running, also done by emplace and erase
+      void reclaim() {
+         if( _retired_nodes.empty() && _retired_buckets.empty() )
+            return;
+         for( const auto& slot : _reader_slots ) {
+            if( slot.readers.load() != 0 )
+               return;
+         }
+         free_retired();
+      }
+
+   private:
+      static constexpr size_t initial_bucket_count = 16;
+      static constexpr size_t reader_slot_count = 64;
+
+      struct node {
+         Key           key;
+         Value*        value; // shared by the copies of the node made by erase and grow
+         const node*   next;
+      };
+
+      struct buckets {
+         explicit buckets( size_t n ) : count( n ), heads( new std::atomic<const node*>[n] ) {
+            for( size_t i = 0; i < n; ++i )
+               heads[i].store( nullptr, std::memory_order_relaxed );
+         }
+         const size_t                                 count; // power of 2
+         std::unique_ptr<std::atomic<const node*>[]>  heads;
+      };
+
+      struct alignas(64) reader_slot {
+         std::atomic<uint64_t> readers{ 0 };
+      };
+
+      static size_t reader_slot_index() {
+         thread_local const size_t index = std::hash<std::thread::id>()( std::this_thread::get_id() ) % reader_slot_count;
+         return index;
+      }
+
+      size_t bucket_of( const Key& key, const buckets& b ) const {
+         return _hash( key ) & ( b.count - 1 );
+      }
+
+      void grow() {
+         buckets* old_buckets = _buckets.load( std::memory_order_relaxed );
+         auto new_buckets = std::make_unique<buckets>( old_buckets->count * 2 );
+         for( size_t i = 0; i < old_buckets->count; ++i ) {
+            for( const node* n = old_buckets->heads[i].load( std::memory_order_relaxed ); n; n = n->next ) {
+               auto& head = new_buckets->heads[bucket_of( n->key, *new_buckets )];
+               head.store( new node{ n->key, n->value, head.load( std::memory_order_relaxed ) }, std::memory_order_relaxed );
+               _retired_nodes.push_back( n );
+            }
+         }
+         _buckets.store( new_buckets.release() );
+         _retired_buckets.emplace_back( old_buckets );
+      }
+
+      void free_retired() {
+         for( const node* n : _retired_nodes )
+            delete n;
+         for( Value* v : _retired_values )
+            delete v;
+         _retired_nodes.clear();
+         _retired_values.clear();
+         _retired_buckets.clear();
+      }
+
+      void free_all( buckets* b ) {
+         for( size_t i = 0; i < b->count; ++i ) {
+            for( const node* n = b->heads[i].load( std::memory_order_relaxed ); n; ) {
+               const node* next = n->next;
+               delete n->value;
+               delete n;
+               n = next;
+            }
+         }
+         delete b;
+      }
+
+      Hash                                             _hash;
+      std::atomic<buckets*>                            _buckets;
+      size_t                                           _size = 0;
+      mutable std::array<reader_slot, reader_slot_count> _reader_slots;
+      std::vector<const node*>                         _retired_nodes;
+      std::vector<Value*>                              _retired_values;
+      std::vector<std::unique_ptr<buckets>>            _retired_buckets;
+   };
+
+} } // eosio::chain
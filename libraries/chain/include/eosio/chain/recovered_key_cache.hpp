@@ -0,0 +1,67 @@
+#pragma once
+
+#include <eosio/chain/types.hpp>
+
+#include <array>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace eosio { namespace chain {
+
+   /**
+    * Thread safe, bounded cache of public keys recovered from (digest, signature).
+    *
+    * The same signatures are recovered repeatedly: a transaction on ingress and again when it arrives in a block or
+    * after a fork switch, and by contracts that verify the same signature in many actions. Entries are spread over
+    * independently locked shards. Each shard keeps two generations; when the current one is full it replaces the
+    * previous one, so entries used within the last generation survive and memory stays bounded by capacity.
+    *
+    * Recovery with and without the canonical signature check are cached separately, a hit never skips a check the
+    * caller asked for.
+    */
+   class recovered_key_cache {
+   public:
+      static constexpr size_t default_capacity = 64*1024;
+
+      /// shared by transaction signature recovery and the recover_key intrinsics
+      static recovered_key_cache& instance();
+
+      explicit recovered_key_cache( size_t capacity = default_capacity ) { set_capacity( capacity ); }
+
+      /// Not thread safe, call before use. 0 disables caching.
+      void set_capacity( size_t capacity );
+      size_t capacity() const { return _capacity; }
+
+      /// Same as public_key_type( sig, digest, check_canonical ), including its exceptions, which are not cached
+      public_key_type recover( const signature_type& sig, const digest_type& digest, bool check_canonical = true );
+
+      std::optional<public_key_type> find( const signature_type& sig, const digest_type& digest, bool check_canonical = true );
+
+      size_t size() const;
+      void clear();
+
+   private:
+      static constexpr size_t num_shards = 16;
+
+      struct key_hash {
+         size_t operator()( const fc::sha256& k ) const { return k._hash[0]; }
+      };
+      using generation = std::unordered_map<fc::sha256, public_key_type, key_hash>;
+
+      struct shard {
+         mutable std::mutex mtx;
+         generation         current;
+         generation         previous;
+      };
+
+      static fc::sha256 make_key( const signature_type& sig, const digest_type& digest, bool check_canonical );
+      shard& shard_for( const fc::sha256& key ) { return _shards[ key._hash[1] % num_shards ]; }
+      void insert_locked( shard& s, const fc::sha256& key, const public_key_type& pub );
+
+      size_t                          _capacity = 0;
+      size_t                          _generation_size = 0; // per shard
+      std::array<shard, num_shards>   _shards;
+   };
+
+} } // eosio::chain
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <fc/crypto/sha256.hpp>
+
+#include <cstddef>
+
+namespace eosio { namespace chain {
+
+   /// one message of a batch, referenced memory must stay valid for the duration of the call
+   struct sha256_batch_input {
+      const char* data = nullptr;
+      size_t      size = 0;
+   };
+
+   enum class sha256_batch_impl {
+      scalar, ///< fc::sha256 one message at a time
+      avx2,   ///< 8 messages per pass using AVX2 multi-buffer hashing
+      sha_ni  ///< x86 SHA extensions
+   };
+
+   /// fastest implementation supported by the running CPU, detected once
+   sha256_batch_impl sha256_batch_best_impl();
+   bool sha256_batch_supported( sha256_batch_impl impl );
+   const char* to_string( sha256_batch_impl impl );
+
+   /**
+    * Hashes n independent messages, out[i] = sha256(inputs[i]).
+    *
+    * Intended for many small messages such as merkle nodes and receipt digests, where per message setup of
+    * fc::sha256::encoder dominates. Results are identical for every implementation.
+    */
+   void sha256_batch( const sha256_batch_input* inputs, size_t n, fc::sha256* out );
+
+   /// as above using impl, which must be supported by the running CPU
+   void sha256_batch( const sha256_batch_input* inputs, size_t n, fc::sha256* out, sha256_batch_impl impl );
+
+} } /// eosio::chain
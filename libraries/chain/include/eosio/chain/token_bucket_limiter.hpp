@@ -0,0 +1,124 @@
+#pragma once
+
+#include <fc/time.hpp>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace eosio { namespace chain {
+
+   /**
+    * Thread safe per-key token bucket rate limiter.
+    *
+    * Each key gets a bucket holding up to burst tokens which refills at rate_per_sec tokens per second. Keys are
+    * spread over independently locked shards so that concurrent callers rarely contend. Buckets that have refilled
+    * completely carry no information and are dropped lazily, which bounds memory to the keys active within the last
+    * burst / rate_per_sec seconds.
+    */
+   template<typename Key, typename Hash = std::hash<Key>, size_t NumShards = 32>
+   class token_bucket_limiter {
+   public:
+      token_bucket_limiter() = default;
+      token_bucket_limiter( uint32_t rate_per_sec, uint32_t burst ) { configure( rate_per_sec, burst ); }
+
+      /// Not thread safe, call before use. rate_per_sec of 0 disables the limiter.
+      void configure( uint32_t rate_per_sec, uint32_t burst ) {
+         _rate_per_sec = rate_per_sec;
+         _burst = std::max( burst, rate_per_sec > 0 ? 1u : 0u );
+      }
+
+      bool enabled() const { return _rate_per_sec > 0; }
+
+      /// @return true if tokens were available for key and have been consumed
+      bool try_consume( const Key& key, const fc::time_point& now, uint32_t tokens = 1 ) {
+         if( !enabled() ) return true;
+         shard& s = shard_for( key );
+         std::lock_guard<std::mutex> g( s.mtx );
+         if( s.buckets.size() >= prune_threshold && now - s.last_prune >= fc::seconds( 1 ) )
+            prune_shard( s, now );
+         auto itr = s.buckets.find( key );
+         if( itr == s.buckets.end() ) {
+            if( tokens > _burst ) return false;
+            s.buckets.emplace( key, bucket{ double( _burst - tokens ), now } );
+            return true;
+         }
+         bucket& b = itr->second;
+         refill( b, now );
+         if( b.tokens < tokens ) return false;
+         b.tokens -= tokens;
+         return true;
+      }
+
+      /// @return true if tokens are available for key, without consuming them
+      bool has_tokens( const Key& key, const fc::time_point& now, uint32_t tokens = 1 ) {
+         if( !enabled() ) return true;
+         shard& s = shard_for( key );
+         std::lock_guard<std::mutex> g( s.mtx );
+         auto itr = s.buckets.find( key );
+         if( itr == s.buckets.end() ) return tokens <= _burst;
+         refill( itr->second, now );
+         return itr->second.tokens >= tokens;
+      }
+
+      /// drop all buckets that have refilled completely
+      void prune( const fc::time_point& now ) {
+         for( shard& s : _shards ) {
+            std::lock_guard<std::mutex> g( s.mtx );
+            prune_shard( s, now );
+         }
+      }
+
+      size_t size() const {
+         size_t n = 0;
+         for( const shard& s : _shards ) {
+            std::lock_guard<std::mutex> g( s.mtx );
+            n += s.buckets.size();
+         }
+         return n;
+      }
+
+   private:
+      static constexpr size_t prune_threshold = 1024;
+
+      struct bucket {
+         double         tokens = 0;
+         fc::time_point last_refill;
+      };
+
+      struct shard {
+         mutable std::mutex                    mtx;
+         std::unordered_map<Key, bucket, Hash> buckets;
+         fc::time_point                        last_prune;
+      };
+
+      shard& shard_for( const Key& key ) {
+         // mix, std::hash of integral types is often the identity
+         const uint64_t h = uint64_t( Hash{}( key ) ) * 0x9E3779B97F4A7C15ull;
+         return _shards[ (h >> 32) % NumShards ];
+      }
+
+      void refill( bucket& b, const fc::time_point& now ) const {
+         if( now <= b.last_refill ) return;
+         const double elapsed_sec = double( (now - b.last_refill).count() ) / 1'000'000;
+         b.tokens = std::min<double>( _burst, b.tokens + elapsed_sec * _rate_per_sec );
+         b.last_refill = now;
+      }
+
+      void prune_shard( shard& s, const fc::time_point& now ) {
+         for( auto itr = s.buckets.begin(); itr != s.buckets.end(); ) {
+            refill( itr->second, now );
+            if( itr->second.tokens >= _burst ) itr = s.buckets.erase( itr );
+            else ++itr;
+         }
+         s.last_prune = now;
+      }
+
+      uint32_t                      _rate_per_sec = 0;
+      uint32_t                      _burst = 0;
+      std::array<shard, NumShards>  _shards;
+   };
+
+} } // eosio::chain
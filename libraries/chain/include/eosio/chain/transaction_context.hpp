@@ -1,6 +1,7 @@
 #pragma once
 #include <eosio/chain/controller.hpp>
 #include <eosio/chain/trace.hpp>
+#include <eosio/chain/authorization_manager.hpp>
 #include <eosio/chain/platform_timer.hpp>
 #include <signal.h>
 
@@ -117,6 +118,8 @@ namespace eosio { namespace chain {
 
          void disallow_transaction_extensions( const char* error_msg )const;
 
+         void check_undone_auth_state();
+
       /// Fields:
       public:
 
@@ -149,6 +152,9 @@ namespace eosio { namespace chain {
 
          transaction_checktime_timer   transaction_timer;
 
+         /// authorization checks of inline actions that passed, see authorization_manager::check_cache
+         authorization_manager::check_cache  auth_check_cache;
+
          const bool                    is_read_only;
    private:
          bool                          is_initialized = false;
@@ -158,6 +164,7 @@ namespace eosio { namespace chain {
          bool                          net_limit_due_to_greylist = false;
          uint64_t                      eager_net_limit = 0;
          uint64_t&                     net_usage; /// reference to trace->net_usage
+         uint64_t                      auth_state_version = 0; /// authorization_manager version when started
 
          bool                          cpu_limit_due_to_greylist = false;
 
@@ -3,6 +3,7 @@
 #include <eosio/chain/types.hpp>
 #include <boost/asio/io_context.hpp>
 #include <future>
+#include <vector>
 
 namespace boost { namespace asio {
    class thread_pool;
@@ -48,6 +49,9 @@ class transaction_metadata {
                   "signature variable length component size (${s}) greater than subjective maximum (${m})", ("s", sig.variable_size())("m", max));
       }
 
+      static transaction_metadata_ptr recover_keys( packed_transaction_ptr trx, const chain_id_type& chain_id, fc::microseconds time_limit,
+                                                    trx_type t, uint32_t max_variable_sig_size );
+
    public:
       // creation of tranaction_metadata restricted to start_recover_keys and create_no_recover_keys below, public for make_shared
       explicit transaction_metadata( const private_type& pt, packed_transaction_ptr ptrx,
@@ -81,6 +85,15 @@ class transaction_metadata {
                           const chain_id_type& chain_id, fc::microseconds time_limit,
                           trx_type t, uint32_t max_variable_sig_size = UINT32_MAX );
 
+      /// Thread safe. Recovers the keys of many transactions, such as those of a block, with num_tasks thread pool tasks
+      /// instead of one task per transaction. Task i recovers trxs i, i+num_tasks, ... so the first transactions are
+      /// ready first and signatures are spread evenly over the tasks.
+      /// @returns one future per trx in the same order, each holding transaction_metadata_ptr or exception
+      static std::vector<recover_keys_future>
+      start_recover_keys( const std::vector<packed_transaction_ptr>& trxs, boost::asio::io_context& thread_pool, size_t num_tasks,
+                          const chain_id_type& chain_id, fc::microseconds time_limit,
+                          trx_type t, uint32_t max_variable_sig_size = UINT32_MAX );
+
       /// @returns constructed transaction_metadata with no key recovery (sig_cpu_usage=0, recovered_pub_keys=empty)
       static transaction_metadata_ptr
       create_no_recover_keys( packed_transaction_ptr trx, trx_type t ) {
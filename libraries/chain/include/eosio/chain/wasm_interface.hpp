@@ -57,6 +57,12 @@ namespace eosio { namespace chain {
          //indicate the current LIB. evicts old cache entries
          void current_lib(const uint32_t lib);
 
+         //compile the most recently used contracts with EOS VM OC ahead of applying blocks, see eosvmoc::config::warmup_contracts
+         void eosvmoc_warmup(const std::function<bool()>& check_shutdown);
+
+         //whether EOS VM OC tier-up has compiled code available for the given code, false if tier-up is not enabled
+         bool eosvmoc_is_code_cached(const digest_type& code_hash, const uint8_t& vm_version) const;
+
          //Calls apply or error on a given code
          void apply(const digest_type& code_hash, const uint8_t& vm_type, const uint8_t& vm_version, apply_context& context);
 
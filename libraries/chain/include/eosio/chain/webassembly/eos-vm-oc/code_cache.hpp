@@ -4,6 +4,9 @@
 
 #include <eosio/chain/webassembly/eos-vm-oc/eos-vm-oc.hpp>
 #include <eosio/chain/webassembly/eos-vm-oc/ipc_helpers.hpp>
+#include <eosio/chain/code_object.hpp>
+#include <eosio/chain/read_mostly_map.hpp>
+#include <eosio/chain/thread_utils.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
@@ -14,7 +17,13 @@
 #include <boost/asio/local/datagram_protocol.hpp>
 
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace std {
     template<> struct hash<eosio::chain::eosvmoc::code_tuple> {
@@ -34,8 +43,85 @@ namespace bfs = boost::filesystem;
 
 using allocator_t = bip::rbtree_best_fit<bip::null_mutex_family, bip::offset_ptr<void>, alignof(std::max_align_t)>;
 
+struct code_usage_entry {
+   code_tuple code;
+   uint32_t   last_block_num_used = 0;
+};
+
+/**
+ * Compiled code of one contract as shared between nodes, one file per entry named after the code it was compiled
+ * from. Only usable by nodes with the same codegen_version and compiler; the file is followed by a sha256 of its
+ * packed contents.
+ */
+struct exported_code_entry {
+   uint64_t                            id = 0;
+   uint8_t                             codegen_version = 0;
+   std::string                         compiler;
+   code_tuple                          code;
+   eosvmoc_optional_offset_or_import_t start;
+   unsigned                            apply_offset = 0;
+   int                                 starting_memory_pages = 0;
+   unsigned                            initdata_prologue_size = 0;
+   std::vector<char>                   code_bytes;
+   std::vector<char>                   initdata;
+};
+
 struct config;
 
+/**
+ * Contents of the code cache.
+ *
+ * find() may be called from any thread and never locks or waits on the main thread, see read_mostly_map. The main
+ * thread is the only writer.
+ *
+ * Instead of moving entries to the front of an MRU list, lookups store the current epoch in the entry. Recency is
+ * only consulted when the main thread evicts a batch of entries because the cache is running out of space.
+ * A returned descriptor stays valid until the main thread removes its entry.
+ */
+class code_descriptor_table {
+   public:
+      //thread safe
+      const code_descriptor* find(const digest_type& code_id, const uint8_t& vm_version) const {
+         const entry* e = _table.find(code_tuple{code_id, vm_version}, [&](const entry& e) {
+            const uint64_t epoch = _epoch.load(std::memory_order_relaxed);
+            if(e.last_used_epoch.load(std::memory_order_relaxed) != epoch)
+               e.last_used_epoch.store(epoch, std::memory_order_relaxed);
+         });
+         return e ? &e->descriptor : nullptr;
+      }
+
+      //main thread only from here on
+
+      //lookups after this are more recent than lookups before it
+      void advance_epoch() {
+         _epoch.store(_epoch.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+         _table.reclaim();
+      }
+
+      size_t size() const { return _table.size(); }
+      bool contains(const code_tuple& ct) const { return _table.find(ct) != nullptr; }
+
+      //inserts as the most recently used entry
+      const code_descriptor& insert(code_descriptor cd);
+      //inserts descriptors ordered most recently used first, as returned by by_recency()
+      void insert_by_recency(std::vector<code_descriptor> cds);
+      std::optional<code_descriptor> erase(const code_tuple& ct);
+      //removes up to n least recently used entries, but never the last keep_at_least entries
+      std::vector<code_descriptor> evict(size_t n, size_t keep_at_least);
+      //most recently used first
+      std::vector<code_descriptor> by_recency() const;
+
+   private:
+      struct entry {
+         explicit entry(code_descriptor cd, uint64_t epoch) : descriptor(std::move(cd)), last_used_epoch(epoch) {}
+         const code_descriptor         descriptor;
+         mutable std::atomic<uint64_t> last_used_epoch;
+      };
+
+      read_mostly_map<code_tuple, entry> _table;
+      std::atomic<uint64_t> _epoch{1};
+};
+
 class code_cache_base {
    public:
       code_cache_base(const bfs::path data_dir, const eosvmoc::config& eosvmoc_config, const chainbase::database& db);
@@ -45,22 +131,21 @@ class code_cache_base {
 
       void free_code(const digest_type& code_id, const uint8_t& vm_version);
 
+      //record that code was executed in block_num, ranks contracts for warmup
+      void code_used(const digest_type& code_id, const uint8_t& vm_version, uint32_t block_num);
+
+      bool tierup_thresholds_enabled() const { return _tierup_executions || _tierup_cpu_us; }
+
+      //Thread safe. Returns code's descriptor if it is in the cache, does not start compiling it
+      const code_descriptor* find_descriptor(const digest_type& code_id, const uint8_t& vm_version) const {
+         return _cache_index.find(code_id, vm_version);
+      }
+
+      //add time code spent executing on the baseline runtime, counts towards the tier-up thresholds
+      void add_baseline_cpu(const digest_type& code_id, const uint8_t& vm_version, uint64_t cpu_us);
+
    protected:
-      struct by_hash;
-
-      typedef boost::multi_index_container<
-         code_descriptor,
-         indexed_by<
-            sequenced<>,
-            hashed_unique<tag<by_hash>,
-               composite_key< code_descriptor,
-                  member<code_descriptor, digest_type, &code_descriptor::code_hash>,
-                  member<code_descriptor, uint8_t,     &code_descriptor::vm_version>
-               >
-            >
-         >
-      > code_cache_index;
-      code_cache_index _cache_index;
+      code_descriptor_table _cache_index;
 
       const chainbase::database& _db;
 
@@ -83,7 +168,46 @@ class code_cache_base {
       void set_on_disk_region_dirty(bool);
 
       template <typename T>
-      void serialize_cache_index(fc::datastream<T>& ds);
+      static void serialize_cache_index(fc::datastream<T>& ds, const std::vector<code_descriptor>& descriptors);
+
+      //block each code was last executed in. Kept in its own file so that it survives the code cache being discarded
+      std::unordered_map<code_tuple, uint32_t> _code_last_used;
+      bfs::path _usage_file_path;
+      uint32_t _usage_persisted_block_num = 0;
+      static constexpr uint32_t usage_persist_interval_blocks = 2*60*60; //about an hour of blocks
+      void load_code_usage();
+      void persist_code_usage();
+
+      void send_compile(const code_tuple& ct, const code_object& codeobject);
+
+      //baseline runtime usage of code not (yet) compiled, decayed periodically so one-off code is eventually forgotten
+      struct code_hotness {
+         uint32_t executions = 0;
+         uint64_t cpu_us     = 0;
+      };
+      std::unordered_map<code_tuple, code_hotness> _hotness;
+      const uint32_t _tierup_executions;
+      const uint64_t _tierup_cpu_us;
+      uint32_t _hotness_decayed_block_num = 0;
+      static constexpr uint32_t hotness_decay_interval_blocks = 2*60*10; //about ten minutes of blocks
+      void decay_hotness();
+      //counts an execution of ct and returns true once it is hot enough to compile
+      bool tierup_ready(const code_tuple& ct);
+
+      //compiled code is exported to _export_dir as it is added to the cache, and imported from import_dir at startup.
+      //Entries are content addressed so any number of nodes may share a directory
+      bfs::path _export_dir;
+      char* _export_mapping = nullptr; //read only view of the cache used for exporting
+      size_t _export_mapping_size = 0;
+      std::optional<named_thread_pool> _export_thread; //writes exported entries off the main thread
+      //subdirectory of dir holding the entries usable by this build
+      static bfs::path exported_code_dir(const bfs::path& dir);
+      exported_code_entry make_exported_code_entry(const code_descriptor& cd) const;
+      static void write_exported_code(const bfs::path& export_dir, const exported_code_entry& e);
+      //queues cd to be written to _export_dir
+      void export_code(const code_descriptor& cd);
+      //adds entries of import_dir not already in loaded to the cache mapped at code_mapping, and to loaded
+      void import_code(const bfs::path& import_dir, char* code_mapping, std::vector<code_descriptor>& loaded);
 };
 
 class code_cache_async : public code_cache_base {
@@ -96,6 +220,10 @@ class code_cache_async : public code_cache_base {
       //otherwise: return nullptr
       const code_descriptor* const get_descriptor_for_code(const digest_type& code_id, const uint8_t& vm_version);
 
+      //Compiles the warmup_contracts most recently used contracts that are not cached yet and waits for them to complete.
+      //Returns early if check_shutdown returns true; unfinished compiles are then picked up by get_descriptor_for_code
+      void warmup(const std::function<bool()>& check_shutdown);
+
    private:
       std::thread _monitor_reply_thread;
       boost::lockfree::spsc_queue<wasm_compilation_result_message> _result_queue;
@@ -103,6 +231,7 @@ class code_cache_async : public code_cache_base {
       std::tuple<size_t, size_t> consume_compile_thread_queue();
       std::unordered_set<code_tuple> _blacklist;
       size_t _threads;
+      uint32_t _warmup_contracts;
 };
 
 class code_cache_sync : public code_cache_base {
@@ -114,4 +243,8 @@ class code_cache_sync : public code_cache_base {
       const code_descriptor* const get_descriptor_for_code_sync(const digest_type& code_id, const uint8_t& vm_version);
 };
 
-}}}
\ No newline at end of file
+}}}
+
+FC_REFLECT(eosio::chain::eosvmoc::code_usage_entry, (code)(last_block_num_used))
+FC_REFLECT(eosio::chain::eosvmoc::exported_code_entry, (id)(codegen_version)(compiler)(code)(start)(apply_offset)(starting_memory_pages)
+                                                       (initdata_prologue_size)(code_bytes)(initdata))
\ No newline at end of file
@@ -13,6 +13,14 @@ namespace eosio { namespace chain { namespace eosvmoc {
 struct config {
    uint64_t cache_size = 1024u*1024u*1024u;
    uint64_t threads    = 1u;
+   uint32_t warmup_contracts = 0u; //number of most recently used contracts to compile at startup, before any block is applied
+   //code is only compiled once it has been executed tierup_executions times or for tierup_cpu_us on the baseline runtime,
+   //both 0 compiles everything on first use
+   uint32_t tierup_executions = 0u;
+   uint64_t tierup_cpu_us     = 0u;
+   //directories compiled code is written to and read from, see code_cache_base. Empty to disable
+   boost::filesystem::path export_dir;
+   boost::filesystem::path import_dir;
 };
 
 }}}
@@ -37,4 +37,5 @@ struct eos_vm_oc_control_block {
    unsigned is_running;
    int64_t max_linear_memory_pages;
    void* globals;
+   int64_t peak_linear_memory_pages; //pages at or above this have not been written since linear memory was last reset
 };
@@ -30,6 +30,19 @@ class memory {
       memory& operator=(const memory&) = delete;
       void reset(uint64_t max_pages);
 
+      //Returns the first pages of linear memory to all zeroes. Up to zero_linear_memory_max_pages this is a memset that
+      //keeps the pages mapped for the next execution, above it the pages of the backing memfd are released so the cost
+      //follows the pages touched rather than pages
+      void reset_linear_memory(uint64_t pages);
+
+      //the two ways reset_linear_memory() zeroes pages still backed by the memfd, public for benchmarking
+      void zero_linear_memory(uint64_t pages);
+      void release_linear_memory(uint64_t pages);
+
+      //memset is an order of magnitude faster than releasing pages and faulting them in again, unless only a small
+      //fraction of a large footprint was touched. See the eosvmoc_memory benchmark
+      static constexpr uint64_t zero_linear_memory_max_pages = 32;
+
       uint8_t* const zero_page_memory_base() const { return zeropage_base; }
       uint8_t* const full_page_memory_base() const { return fullpage_base; }
 
@@ -56,6 +69,7 @@ class memory {
       static_assert(stride == EOS_VM_OC_MEMORY_STRIDE, "EOS VM OC memory stride has slid out of place somehow");
 
    private:
+      int fd;
       uint8_t* mapbase;
       uint64_t mapsize;
 
@@ -54,6 +54,12 @@ class eos_vm_runtime : public eosio::chain::wasm_runtime_interface {
       //       move from wasm_runtime_interface to wasm_instantiated_module_interface.
       eos_vm_backend_t<Backend>* _bkend = nullptr;  // non owning pointer to allow for immediate exit
 
+      // Modules applied this many times are hot and get a linear memory of their own, see eos_vm_instantiated_module.
+      // Each keeps up to maximum_linear_memory resident between actions, so their number is bounded
+      static constexpr uint32_t dedicated_memory_threshold = 16;
+      static constexpr uint32_t max_dedicated_memories = 32;
+      uint32_t _dedicated_memories = 0;
+
    template<typename Impl>
    friend class eos_vm_instantiated_module;
 };
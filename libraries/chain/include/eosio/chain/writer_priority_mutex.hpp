@@ -0,0 +1,122 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace eosio { namespace chain {
+
+   /**
+    * Shared mutex that neither side can starve. A waiting writer keeps new readers out, and when a writer unlocks,
+    * the readers that were waiting at that moment are let in before the next writer. Readers arriving later wait for
+    * the next writer.
+    *
+    * The thread holding it exclusively may lock it again, exclusively or shared, since the controller re-enters its
+    * public interface from intrinsics and signal handlers.
+    *
+    * Satisfies SharedMutex, use with std::unique_lock, std::lock_guard and std::shared_lock.
+    */
+   class writer_priority_mutex {
+   public:
+      void lock() {
+         std::unique_lock<std::mutex> g( _mtx );
+         if( _writer == std::this_thread::get_id() ) {
+            ++_depth;
+            return;
+         }
+         ++_waiting_writers;
+         _cv.wait( g, [this]() { return can_write(); } );
+         --_waiting_writers;
+         _writer = std::this_thread::get_id();
+         _depth = 1;
+      }
+
+      bool try_lock() {
+         std::lock_guard<std::mutex> g( _mtx );
+         if( _writer == std::this_thread::get_id() ) {
+            ++_depth;
+            return true;
+         }
+         if( !can_write() )
+            return false;
+         _writer = std::this_thread::get_id();
+         _depth = 1;
+         return true;
+      }
+
+      void unlock() {
+         {
+            std::lock_guard<std::mutex> g( _mtx );
+            if( --_depth > 0 )
+               return;
+            _writer = std::thread::id();
+            // readers that waited for this writer go before the next one
+            _admitted_readers = _waiting_readers;
+            ++_writer_unlocks;
+         }
+         _cv.notify_all();
+      }
+
+      void lock_shared() {
+         std::unique_lock<std::mutex> g( _mtx );
+         if( _writer == std::this_thread::get_id() ) {
+            ++_depth;
+            return;
+         }
+         if( can_read() ) {
+            ++_readers;
+            return;
+         }
+         ++_waiting_readers;
+         const uint64_t waiting_since = _writer_unlocks;
+         _cv.wait( g, [&]() { return can_read() || ( _writer == std::thread::id() && _writer_unlocks != waiting_since ); } );
+         --_waiting_readers;
+         ++_readers;
+         // counted in _admitted_readers by every writer unlock since waiting_since, which can only be the last one
+         if( _writer_unlocks != waiting_since )
+            --_admitted_readers;
+      }
+
+      bool try_lock_shared() {
+         std::lock_guard<std::mutex> g( _mtx );
+         if( _writer == std::this_thread::get_id() ) {
+            ++_depth;
+            return true;
+         }
+         if( !can_read() )
+            return false;
+         ++_readers;
+         return true;
+      }
+
+      void unlock_shared() {
+         {
+            std::lock_guard<std::mutex> g( _mtx );
+            if( _writer == std::this_thread::get_id() ) {
+               --_depth;
+               return;
+            }
+            if( --_readers > 0 )
+               return;
+         }
+         _cv.notify_all();
+      }
+
+   private:
+      bool can_write()const { return _writer == std::thread::id() && _readers == 0 && _admitted_readers == 0; }
+      /// for a reader that was not waiting when the last writer unlocked
+      bool can_read()const  { return _writer == std::thread::id() && _waiting_writers == 0; }
+
+      std::mutex                 _mtx;
+      std::condition_variable    _cv;
+      std::thread::id            _writer;
+      uint32_t                   _depth = 0;
+      uint32_t                   _readers = 0;
+      uint32_t                   _waiting_readers = 0;
+      uint32_t                   _waiting_writers = 0;
+      uint32_t                   _admitted_readers = 0; ///< waiting readers let in by the last writer unlock, not yet in
+      uint64_t                   _writer_unlocks = 0;
+   };
+
+} } // eosio::chain
@@ -1,6 +1,10 @@
 #include <eosio/chain/merkle.hpp>
+#include <eosio/chain/sha256_batch.hpp>
 #include <fc/io/raw.hpp>
 
+#include <array>
+#include <optional>
+
 namespace eosio { namespace chain {
 
 /**
@@ -33,20 +37,69 @@ bool is_canonical_right(const digest_type& val) {
 
 
 digest_type merkle(deque<digest_type> ids) {
-   if( 0 == ids.size() ) { return digest_type(); }
+   return merkle( vector<digest_type>( ids.begin(), ids.end() ) );
+}
 
-   while( ids.size() > 1 ) {
-      if( ids.size() % 2 )
-         ids.push_back(ids.back());
+digest_type merkle(vector<digest_type> level) {
+   if( 0 == level.size() ) { return digest_type(); }
 
-      for (size_t i = 0; i < ids.size() / 2; i++) {
-         ids[i] = digest_type::hash(make_canonical_pair(ids[2 * i], ids[(2 * i) + 1]));
+   // each level is hashed as one batch, pairs are laid out as the 64 bytes digest_type::hash(pair) would serialize
+   static_assert( sizeof(std::array<digest_type, 2>) == 2 * sizeof(digest_type) );
+   vector<std::array<digest_type, 2>> pairs;
+   vector<sha256_batch_input> inputs;
+   while( level.size() > 1 ) {
+      if( level.size() % 2 )
+         level.push_back(level.back());
+
+      const size_t n = level.size() / 2;
+      pairs.resize(n);
+      inputs.resize(n);
+      for (size_t i = 0; i < n; i++) {
+         pairs[i] = { make_canonical_left(level[2 * i]), make_canonical_right(level[(2 * i) + 1]) };
+         inputs[i] = { pairs[i][0].data(), 2 * sizeof(digest_type) };
       }
+      sha256_batch( inputs.data(), n, level.data() );
+
+      level.resize(n);
+   }
+
+   return level.front();
+}
 
-      ids.resize(ids.size() / 2);
+void merkle_builder::append( const digest_type& d ) {
+   if( _levels.empty() ) _levels.emplace_back();
+   _levels[0].push_back( d );
+   for( size_t k = 0; _levels[k].size() % 2 == 0; ++k ) {
+      if( k + 1 == _levels.size() ) _levels.emplace_back();
+      const auto& level = _levels[k];
+      _levels[k + 1].push_back( digest_type::hash( make_canonical_pair( level[level.size() - 2], level.back() ) ) );
    }
+}
+
+void merkle_builder::truncate( size_t n ) {
+   for( size_t k = 0; k < _levels.size(); ++k ) {
+      if( (n >> k) < _levels[k].size() ) _levels[k].resize( n >> k );
+   }
+}
 
-   return ids.front();
+digest_type merkle_builder::root() const {
+   const size_t n = size();
+   if( n == 0 ) return digest_type();
+
+   // Walk up the right edge. At level k there are n >> k complete nodes followed by a partial node (tail) when the
+   // lower levels did not divide evenly. An odd node count pairs the last node with itself, as merkle() does.
+   std::optional<digest_type> tail;
+   size_t k = 0;
+   for( ; (size_t(1) << k) < n; ++k ) {
+      const bool unpaired = (n >> k) % 2 == 1;
+      if( tail ) {
+         tail = unpaired ? digest_type::hash( make_canonical_pair( _levels[k].back(), *tail ) )
+                         : digest_type::hash( make_canonical_pair( *tail, *tail ) );
+      } else if( unpaired ) {
+         tail = digest_type::hash( make_canonical_pair( _levels[k].back(), _levels[k].back() ) );
+      }
+   }
+   return tail ? *tail : _levels[k].back();
 }
 
 } } // eosio::chain
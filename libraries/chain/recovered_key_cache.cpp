@@ -0,0 +1,91 @@
+#include <eosio/chain/recovered_key_cache.hpp>
+
+#include <fc/io/raw.hpp>
+
+namespace eosio { namespace chain {
+
+recovered_key_cache& recovered_key_cache::instance() {
+   static recovered_key_cache cache;
+   return cache;
+}
+
+void recovered_key_cache::set_capacity( size_t capacity ) {
+   _capacity = capacity;
+   // two generations per shard
+   _generation_size = capacity / num_shards / 2;
+   clear();
+}
+
+fc::sha256 recovered_key_cache::make_key( const signature_type& sig, const digest_type& digest, bool check_canonical ) {
+   fc::sha256::encoder enc;
+   enc.write( digest.data(), digest.data_size() );
+   fc::raw::pack( enc, sig );
+   const char canonical = check_canonical;
+   enc.write( &canonical, sizeof(canonical) );
+   return enc.result();
+}
+
+std::optional<public_key_type> recovered_key_cache::find( const signature_type& sig, const digest_type& digest, bool check_canonical ) {
+   if( !_generation_size ) return {};
+   const fc::sha256 key = make_key( sig, digest, check_canonical );
+   shard& s = shard_for( key );
+   std::lock_guard<std::mutex> g( s.mtx );
+   if( auto itr = s.current.find( key ); itr != s.current.end() )
+      return itr->second;
+   if( auto itr = s.previous.find( key ); itr != s.previous.end() )
+      return itr->second;
+   return {};
+}
+
+public_key_type recovered_key_cache::recover( const signature_type& sig, const digest_type& digest, bool check_canonical ) {
+   if( !_generation_size )
+      return public_key_type( sig, digest, check_canonical );
+
+   const fc::sha256 key = make_key( sig, digest, check_canonical );
+   shard& s = shard_for( key );
+   {
+      std::lock_guard<std::mutex> g( s.mtx );
+      if( auto itr = s.current.find( key ); itr != s.current.end() )
+         return itr->second;
+      if( auto itr = s.previous.find( key ); itr != s.previous.end() ) {
+         // still in use, keep it past the next generation change
+         public_key_type pub = itr->second;
+         s.previous.erase( itr );
+         insert_locked( s, key, pub );
+         return pub;
+      }
+   }
+
+   // recover without holding the lock, two threads racing on the same key both recover the same result
+   public_key_type pub( sig, digest, check_canonical );
+   std::lock_guard<std::mutex> g( s.mtx );
+   insert_locked( s, key, pub );
+   return pub;
+}
+
+void recovered_key_cache::insert_locked( shard& s, const fc::sha256& key, const public_key_type& pub ) {
+   if( s.current.size() >= _generation_size ) {
+      s.previous = std::move( s.current );
+      s.current = generation();
+   }
+   s.current.emplace( key, pub );
+}
+
+size_t recovered_key_cache::size() const {
+   size_t n = 0;
+   for( const shard& s : _shards ) {
+      std::lock_guard<std::mutex> g( s.mtx );
+      n += s.current.size() + s.previous.size();
+   }
+   return n;
+}
+
+void recovered_key_cache::clear() {
+   for( shard& s : _shards ) {
+      std::lock_guard<std::mutex> g( s.mtx );
+      s.current.clear();
+      s.previous.clear();
+   }
+}
+
+} } // eosio::chain
@@ -0,0 +1,327 @@
+#include <eosio/chain/sha256_batch.hpp>
+#include <eosio/chain/exceptions.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define EOSIO_SHA256_BATCH_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace eosio { namespace chain {
+
+namespace {
+
+constexpr uint32_t sha256_k[64] = {
+   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+   0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+   0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+   0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+   0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+   0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+   0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+constexpr uint32_t sha256_h0[8] = {
+   0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/**
+ * A message split into the blocks that can be read in place and one or two final blocks holding the remaining
+ * bytes plus padding.
+ */
+struct padded_message {
+   const uint8_t* data        = nullptr;
+   size_t         full_blocks = 0;
+   size_t         num_blocks  = 0;
+   uint8_t        tail[128];
+
+   explicit padded_message( const sha256_batch_input& in ) {
+      data = reinterpret_cast<const uint8_t*>( in.data );
+      full_blocks = in.size / 64;
+      num_blocks = (in.size + 9 + 63) / 64;
+      const size_t rem = in.size % 64;
+      const size_t tail_size = (num_blocks - full_blocks) * 64;
+      memset( tail, 0, tail_size );
+      if( rem ) memcpy( tail, data + full_blocks * 64, rem );
+      tail[rem] = 0x80;
+      const uint64_t bits = uint64_t( in.size ) * 8;
+      for( int i = 0; i < 8; ++i ) tail[tail_size - 1 - i] = uint8_t( bits >> (8 * i) );
+   }
+
+   const uint8_t* block( size_t i ) const {
+      return i < full_blocks ? data + i * 64 : tail + (i - full_blocks) * 64;
+   }
+};
+
+void store_digest( const uint32_t state[8], fc::sha256& out ) {
+   auto* p = reinterpret_cast<uint8_t*>( out.data() );
+   for( int i = 0; i < 8; ++i ) {
+      p[4 * i]     = uint8_t( state[i] >> 24 );
+      p[4 * i + 1] = uint8_t( state[i] >> 16 );
+      p[4 * i + 2] = uint8_t( state[i] >> 8 );
+      p[4 * i + 3] = uint8_t( state[i] );
+   }
+}
+
+void scalar_batch( const sha256_batch_input* inputs, size_t n, fc::sha256* out ) {
+   for( size_t i = 0; i < n; ++i ) {
+      out[i] = fc::sha256::hash( inputs[i].data, inputs[i].size );
+   }
+}
+
+#ifdef EOSIO_SHA256_BATCH_X86
+
+bool detect_sha_ni() {
+   unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+   if( !__get_cpuid_count( 7, 0, &eax, &ebx, &ecx, &edx ) ) return false;
+   const bool sha = ebx & (1u << 29);
+   if( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) ) return false;
+   const bool ssse3 = ecx & (1u << 9);
+   const bool sse41 = ecx & (1u << 19);
+   return sha && ssse3 && sse41;
+}
+
+// cpuid is slow, and serializing in a VM, detect once
+bool cpu_has_sha_ni() {
+   static const bool has_sha_ni = detect_sha_ni();
+   return has_sha_ni;
+}
+
+bool cpu_has_avx2() {
+   static const bool has_avx2 = []() {
+      __builtin_cpu_init();
+      return __builtin_cpu_supports( "avx2" );
+   }();
+   return has_avx2;
+}
+
+__attribute__((target("sha,sse4.1,ssse3")))
+void sha_ni_compress( uint32_t state[8], const uint8_t* block ) {
+   const __m128i bswap_mask = _mm_set_epi64x( 0x0c0d0e0f08090a0bull, 0x0405060700010203ull );
+
+   // the sha256rnds2 instruction wants the state as ABEF and CDGH
+   __m128i tmp    = _mm_shuffle_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( &state[0] ) ), 0xB1 ); // CDAB
+   __m128i state1 = _mm_shuffle_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( &state[4] ) ), 0x1B ); // EFGH
+   __m128i state0 = _mm_alignr_epi8( tmp, state1, 8 );    // ABEF
+   state1         = _mm_blend_epi16( state1, tmp, 0xF0 ); // CDGH
+   const __m128i abef_save = state0;
+   const __m128i cdgh_save = state1;
+
+   __m128i w[4];
+   for( int i = 0; i < 16; ++i ) {
+      if( i < 4 )
+         w[i] = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( block + 16 * i ) ), bswap_mask );
+      __m128i msg = _mm_add_epi32( w[i % 4], _mm_loadu_si128( reinterpret_cast<const __m128i*>( &sha256_k[4 * i] ) ) );
+      state1 = _mm_sha256rnds2_epu32( state1, state0, msg );
+      if( i >= 3 && i < 15 ) {
+         __m128i& next = w[(i + 1) % 4];
+         next = _mm_add_epi32( next, _mm_alignr_epi8( w[i % 4], w[(i + 3) % 4], 4 ) );
+         next = _mm_sha256msg2_epu32( next, w[i % 4] );
+      }
+      msg = _mm_shuffle_epi32( msg, 0x0E );
+      state0 = _mm_sha256rnds2_epu32( state0, state1, msg );
+      if( i >= 1 && i < 13 ) {
+         __m128i& prev = w[(i + 3) % 4];
+         prev = _mm_sha256msg1_epu32( prev, w[i % 4] );
+      }
+   }
+
+   state0 = _mm_add_epi32( state0, abef_save );
+   state1 = _mm_add_epi32( state1, cdgh_save );
+
+   tmp    = _mm_shuffle_epi32( state0, 0x1B );        // FEBA
+   state1 = _mm_shuffle_epi32( state1, 0xB1 );        // DCHG
+   state0 = _mm_blend_epi16( tmp, state1, 0xF0 );     // DCBA
+   state1 = _mm_alignr_epi8( state1, tmp, 8 );        // HGFE
+   _mm_storeu_si128( reinterpret_cast<__m128i*>( &state[0] ), state0 );
+   _mm_storeu_si128( reinterpret_cast<__m128i*>( &state[4] ), state1 );
+}
+
+void sha_ni_batch( const sha256_batch_input* inputs, size_t n, fc::sha256* out ) {
+   for( size_t i = 0; i < n; ++i ) {
+      const padded_message m( inputs[i] );
+      uint32_t state[8];
+      std::copy( std::begin( sha256_h0 ), std::end( sha256_h0 ), state );
+      for( size_t b = 0; b < m.num_blocks; ++b ) sha_ni_compress( state, m.block( b ) );
+      store_digest( state, out[i] );
+   }
+}
+
+constexpr size_t avx2_lanes = 8;
+
+__attribute__((target("avx2"))) inline __m256i rotr( __m256i x, int n ) {
+   return _mm256_or_si256( _mm256_srli_epi32( x, n ), _mm256_slli_epi32( x, 32 - n ) );
+}
+
+__attribute__((target("avx2"))) inline __m256i add( __m256i a, __m256i b ) {
+   return _mm256_add_epi32( a, b );
+}
+
+__attribute__((target("avx2"))) inline __m256i load_be_words( const uint8_t* const blocks[avx2_lanes], int t ) {
+   uint32_t v[avx2_lanes];
+   for( size_t l = 0; l < avx2_lanes; ++l ) {
+      uint32_t x;
+      memcpy( &x, blocks[l] + 4 * t, 4 );
+      v[l] = __builtin_bswap32( x );
+   }
+   return _mm256_loadu_si256( reinterpret_cast<const __m256i*>( v ) );
+}
+
+/// state[i] holds word i of the state of each of the 8 lanes
+__attribute__((target("avx2")))
+void avx2_compress8( __m256i state[8], const uint8_t* const blocks[avx2_lanes] ) {
+   __m256i w[16];
+   __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+   __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+   for( int t = 0; t < 64; ++t ) {
+      __m256i wt;
+      if( t < 16 ) {
+         wt = load_be_words( blocks, t );
+      } else {
+         const __m256i w2  = w[(t - 2) & 15];
+         const __m256i w15 = w[(t - 15) & 15];
+         const __m256i s1 = _mm256_xor_si256( _mm256_xor_si256( rotr( w2, 17 ), rotr( w2, 19 ) ), _mm256_srli_epi32( w2, 10 ) );
+         const __m256i s0 = _mm256_xor_si256( _mm256_xor_si256( rotr( w15, 7 ), rotr( w15, 18 ) ), _mm256_srli_epi32( w15, 3 ) );
+         wt = add( add( s1, w[(t - 7) & 15] ), add( s0, w[t & 15] ) );
+      }
+      w[t & 15] = wt;
+
+      const __m256i bsig1 = _mm256_xor_si256( _mm256_xor_si256( rotr( e, 6 ), rotr( e, 11 ) ), rotr( e, 25 ) );
+      const __m256i ch    = _mm256_xor_si256( _mm256_and_si256( e, f ), _mm256_andnot_si256( e, g ) );
+      const __m256i t1    = add( add( add( h, bsig1 ), add( ch, _mm256_set1_epi32( int( sha256_k[t] ) ) ) ), wt );
+      const __m256i bsig0 = _mm256_xor_si256( _mm256_xor_si256( rotr( a, 2 ), rotr( a, 13 ) ), rotr( a, 22 ) );
+      const __m256i maj   = _mm256_or_si256( _mm256_and_si256( a, b ), _mm256_and_si256( c, _mm256_or_si256( a, b ) ) );
+      const __m256i t2    = add( bsig0, maj );
+      h = g; g = f; f = e; e = add( d, t1 );
+      d = c; c = b; b = a; a = add( t1, t2 );
+   }
+   state[0] = add( state[0], a ); state[1] = add( state[1], b );
+   state[2] = add( state[2], c ); state[3] = add( state[3], d );
+   state[4] = add( state[4], e ); state[5] = add( state[5], f );
+   state[6] = add( state[6], g ); state[7] = add( state[7], h );
+}
+
+/// lanes must all have the same number of blocks
+__attribute__((target("avx2")))
+void avx2_hash8( const padded_message* const lanes[avx2_lanes], fc::sha256* const out[avx2_lanes] ) {
+   __m256i state[8];
+   for( int i = 0; i < 8; ++i ) state[i] = _mm256_set1_epi32( int( sha256_h0[i] ) );
+   const uint8_t* blocks[avx2_lanes];
+   for( size_t b = 0; b < lanes[0]->num_blocks; ++b ) {
+      for( size_t l = 0; l < avx2_lanes; ++l ) blocks[l] = lanes[l]->block( b );
+      avx2_compress8( state, blocks );
+   }
+   uint32_t words[8][avx2_lanes];
+   for( int i = 0; i < 8; ++i ) _mm256_storeu_si256( reinterpret_cast<__m256i*>( words[i] ), state[i] );
+   for( size_t l = 0; l < avx2_lanes; ++l ) {
+      if( !out[l] ) continue;
+      uint32_t s[8];
+      for( int i = 0; i < 8; ++i ) s[i] = words[i][l];
+      store_digest( s, *out[l] );
+   }
+}
+
+void avx2_batch( const sha256_batch_input* inputs, size_t n, fc::sha256* out ) {
+   std::vector<padded_message> msgs;
+   msgs.reserve( n );
+   for( size_t i = 0; i < n; ++i ) msgs.emplace_back( inputs[i] );
+
+   // lanes advance in lock step, so group messages by block count
+   std::vector<size_t> order( n );
+   std::iota( order.begin(), order.end(), 0 );
+   std::stable_sort( order.begin(), order.end(), [&]( size_t l, size_t r ) {
+      return msgs[l].num_blocks < msgs[r].num_blocks;
+   } );
+
+   for( size_t i = 0; i < n; ) {
+      size_t j = i + 1;
+      while( j < n && j - i < avx2_lanes && msgs[order[j]].num_blocks == msgs[order[i]].num_blocks ) ++j;
+      if( j - i == 1 ) {
+         scalar_batch( &inputs[order[i]], 1, &out[order[i]] );
+      } else {
+         // unused lanes repeat the last message and discard the result
+         const padded_message* lanes[avx2_lanes];
+         fc::sha256* lane_out[avx2_lanes];
+         for( size_t l = 0; l < avx2_lanes; ++l ) {
+            const bool used = i + l < j;
+            lanes[l] = &msgs[order[used ? i + l : j - 1]];
+            lane_out[l] = used ? &out[order[i + l]] : nullptr;
+         }
+         avx2_hash8( lanes, lane_out );
+      }
+      i = j;
+   }
+}
+
+#endif // EOSIO_SHA256_BATCH_X86
+
+sha256_batch_impl detect_best_impl() {
+#ifdef EOSIO_SHA256_BATCH_X86
+   if( cpu_has_sha_ni() ) return sha256_batch_impl::sha_ni;
+   if( cpu_has_avx2() ) return sha256_batch_impl::avx2;
+#endif
+   return sha256_batch_impl::scalar;
+}
+
+} // anonymous namespace
+
+sha256_batch_impl sha256_batch_best_impl() {
+   static const sha256_batch_impl best = detect_best_impl();
+   return best;
+}
+
+bool sha256_batch_supported( sha256_batch_impl impl ) {
+   switch( impl ) {
+      case sha256_batch_impl::scalar:
+         return true;
+#ifdef EOSIO_SHA256_BATCH_X86
+      case sha256_batch_impl::avx2:
+         return cpu_has_avx2();
+      case sha256_batch_impl::sha_ni:
+         return cpu_has_sha_ni();
+#endif
+      default:
+         return false;
+   }
+}
+
+const char* to_string( sha256_batch_impl impl ) {
+   switch( impl ) {
+      case sha256_batch_impl::scalar: return "scalar";
+      case sha256_batch_impl::avx2:   return "avx2";
+      case sha256_batch_impl::sha_ni: return "sha_ni";
+   }
+   return "unknown";
+}
+
+void sha256_batch( const sha256_batch_input* inputs, size_t n, fc::sha256* out ) {
+   sha256_batch( inputs, n, out, sha256_batch_best_impl() );
+}
+
+void sha256_batch( const sha256_batch_input* inputs, size_t n, fc::sha256* out, sha256_batch_impl impl ) {
+   switch( impl ) {
+#ifdef EOSIO_SHA256_BATCH_X86
+      case sha256_batch_impl::sha_ni:
+         EOS_ASSERT( sha256_batch_supported( impl ), misc_exception, "sha256 batch implementation ${i} not supported", ("i", to_string( impl )) );
+         sha_ni_batch( inputs, n, out );
+         return;
+      case sha256_batch_impl::avx2:
+         EOS_ASSERT( sha256_batch_supported( impl ), misc_exception, "sha256 batch implementation ${i} not supported", ("i", to_string( impl )) );
+         avx2_batch( inputs, n, out );
+         return;
+#endif
+      case sha256_batch_impl::scalar:
+         scalar_batch( inputs, n, out );
+         return;
+      default:
+         EOS_THROW( misc_exception, "sha256 batch implementation ${i} not supported", ("i", to_string( impl )) );
+   }
+}
+
+} } /// eosio::chain
@@ -62,6 +62,7 @@ namespace eosio { namespace chain {
       if (!c.skip_db_sessions()) {
          undo_session.emplace(c.mutable_db().start_undo_session(true));
       }
+      auth_state_version = c.get_authorization_manager().version();
       trace->id = packed_trx.id();
       trace->block_num = c.head_block_num() + 1;
       trace->block_time = c.pending_block_time();
@@ -75,6 +76,8 @@ namespace eosio { namespace chain {
 
    transaction_context::~transaction_context()
    {
+      // the undo_session, if not squashed, is undone after this
+      check_undone_auth_state();
       if(auto dm_logger = control.get_deep_mind_logger())
       {
          dm_logger->on_end_transaction();
@@ -382,6 +385,16 @@ namespace eosio { namespace chain {
 
    void transaction_context::undo() {
       if (undo_session) undo_session->undo();
+      check_undone_auth_state();
+   }
+
+   void transaction_context::check_undone_auth_state() {
+      // permission changes of this transaction may have been undone, which authorization_manager is not aware of
+      auto& authorization = control.get_mutable_authorization_manager();
+      if( authorization.version() != auth_state_version ) {
+         authorization.state_changed();
+         auth_state_version = authorization.version();
+      }
    }
 
    void transaction_context::check_net_usage()const {
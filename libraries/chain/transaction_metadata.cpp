@@ -2,8 +2,26 @@
 #include <eosio/chain/thread_utils.hpp>
 #include <boost/asio/thread_pool.hpp>
 
+#include <algorithm>
+
 namespace eosio { namespace chain {
 
+transaction_metadata_ptr transaction_metadata::recover_keys( packed_transaction_ptr trx,
+                                                             const chain_id_type& chain_id,
+                                                             fc::microseconds time_limit,
+                                                             trx_type t,
+                                                             uint32_t max_variable_sig_size )
+{
+   fc::time_point deadline = time_limit == fc::microseconds::maximum() ?
+                             fc::time_point::maximum() : fc::time_point::now() + time_limit;
+   check_variable_sig_size( trx, max_variable_sig_size );
+   const signed_transaction& trn = trx->get_signed_transaction();
+   flat_set<public_key_type> recovered_pub_keys;
+   fc::microseconds cpu_usage = trn.get_signature_keys( chain_id, deadline, recovered_pub_keys );
+   return std::make_shared<transaction_metadata>( private_type(), std::move( trx ), cpu_usage, std::move( recovered_pub_keys ),
+                                                  t==trx_type::implicit, t==trx_type::scheduled, t==trx_type::read_only);
+}
+
 recover_keys_future transaction_metadata::start_recover_keys( packed_transaction_ptr trx,
                                                               boost::asio::io_context& thread_pool,
                                                               const chain_id_type& chain_id,
@@ -12,18 +30,45 @@ recover_keys_future transaction_metadata::start_recover_keys( packed_transaction
                                                               uint32_t max_variable_sig_size )
 {
    return async_thread_pool( thread_pool, [trx{std::move(trx)}, chain_id, time_limit, t, max_variable_sig_size]() mutable {
-         fc::time_point deadline = time_limit == fc::microseconds::maximum() ?
-                                   fc::time_point::maximum() : fc::time_point::now() + time_limit;
-         check_variable_sig_size( trx, max_variable_sig_size );
-         const signed_transaction& trn = trx->get_signed_transaction();
-         flat_set<public_key_type> recovered_pub_keys;
-         fc::microseconds cpu_usage = trn.get_signature_keys( chain_id, deadline, recovered_pub_keys );
-         return std::make_shared<transaction_metadata>( private_type(), std::move( trx ), cpu_usage, std::move( recovered_pub_keys ),
-                                                        t==trx_type::implicit, t==trx_type::scheduled, t==trx_type::read_only);
+         return recover_keys( std::move( trx ), chain_id, time_limit, t, max_variable_sig_size );
       }
    );
 }
 
+std::vector<recover_keys_future> transaction_metadata::start_recover_keys( const std::vector<packed_transaction_ptr>& trxs,
+                                                                           boost::asio::io_context& thread_pool,
+                                                                           size_t num_tasks,
+                                                                           const chain_id_type& chain_id,
+                                                                           fc::microseconds time_limit,
+                                                                           trx_type t,
+                                                                           uint32_t max_variable_sig_size )
+{
+   struct batch {
+      std::vector<packed_transaction_ptr>                trxs;
+      std::vector<std::promise<transaction_metadata_ptr>> results;
+   };
+   auto b = std::make_shared<batch>( batch{ trxs, std::vector<std::promise<transaction_metadata_ptr>>( trxs.size() ) } );
+
+   std::vector<recover_keys_future> futures;
+   futures.reserve( trxs.size() );
+   for( auto& r : b->results )
+      futures.emplace_back( r.get_future() );
+
+   num_tasks = std::min( std::max<size_t>( num_tasks, 1 ), trxs.size() );
+   for( size_t task = 0; task < num_tasks; ++task ) {
+      boost::asio::post( thread_pool, [b, task, num_tasks, chain_id, time_limit, t, max_variable_sig_size]() {
+         for( size_t i = task; i < b->trxs.size(); i += num_tasks ) {
+            try {
+               b->results[i].set_value( recover_keys( std::move( b->trxs[i] ), chain_id, time_limit, t, max_variable_sig_size ) );
+            } catch( ... ) {
+               b->results[i].set_exception( std::current_exception() );
+            }
+         }
+      } );
+   }
+   return futures;
+}
+
 size_t transaction_metadata::get_estimated_size() const {
    return sizeof(*this) + _recovered_pub_keys.size() * sizeof(public_key_type) + packed_trx()->get_estimated_size();
 }
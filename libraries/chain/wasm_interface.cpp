@@ -78,6 +78,21 @@ namespace eosio { namespace chain {
       my->current_lib(lib);
    }
 
+   void wasm_interface::eosvmoc_warmup(const std::function<bool()>& check_shutdown) {
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+      if(my->eosvmoc)
+         my->eosvmoc->cc.warmup(check_shutdown);
+#endif
+   }
+
+   bool wasm_interface::eosvmoc_is_code_cached(const digest_type& code_hash, const uint8_t& vm_version) const {
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+      if(my->eosvmoc)
+         return my->eosvmoc->cc.find_descriptor(code_hash, vm_version) != nullptr;
+#endif
+      return false;
+   }
+
    void wasm_interface::apply( const digest_type& code_hash, const uint8_t& vm_type, const uint8_t& vm_version, apply_context& context ) {
       if(substitute_apply && substitute_apply(code_hash, vm_type, vm_version, context))
          return;
@@ -85,6 +100,7 @@ namespace eosio { namespace chain {
       if(my->eosvmoc) {
          const chain::eosvmoc::code_descriptor* cd = nullptr;
          try {
+            my->eosvmoc->cc.code_used(code_hash, vm_version, context.control.head_block_num() + 1);
             cd = my->eosvmoc->cc.get_descriptor_for_code(code_hash, vm_version);
          }
          catch(...) {
@@ -99,6 +115,14 @@ namespace eosio { namespace chain {
             my->eosvmoc->exec.execute(*cd, my->eosvmoc->mem, context);
             return;
          }
+         if(my->eosvmoc->cc.tierup_thresholds_enabled()) {
+            const fc::time_point start = fc::time_point::now();
+            auto add_cpu = fc::make_scoped_exit([&]() {
+               my->eosvmoc->cc.add_baseline_cpu(code_hash, vm_version, (fc::time_point::now() - start).count());
+            });
+            my->get_instantiated_module(code_hash, vm_type, vm_version, context.trx_context)->apply(context);
+            return;
+         }
       }
 #endif
       my->get_instantiated_module(code_hash, vm_type, vm_version, context.trx_context)->apply(context);
@@ -9,6 +9,11 @@
 #include <eosio/chain/webassembly/eos-vm-oc/compile_monitor.hpp>
 #include <eosio/chain/exceptions.hpp>
 
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <fstream>
+
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <sys/mman.h>
@@ -19,6 +24,8 @@
 #include "WASM/WASM.h"
 #include "LLVMJIT.h"
 
+#include <llvm/Config/llvm-config.h>
+
 using namespace IR;
 using namespace Runtime;
 
@@ -39,10 +46,15 @@ static constexpr size_t descriptor_ptr_from_file_start = header_offset + offseto
 
 static_assert(sizeof(code_cache_header) <= header_size, "code_cache_header too big");
 
+static constexpr uint64_t exported_code_id = 0x31585456534f45ULL; //"EOSVTX1" little endian
+static const std::string exported_code_compiler = "llvm-" LLVM_VERSION_STRING;
+static const std::string exported_code_extension = ".eosvmoc";
+
 code_cache_async::code_cache_async(const bfs::path data_dir, const eosvmoc::config& eosvmoc_config, const chainbase::database& db) :
    code_cache_base(data_dir, eosvmoc_config, db),
    _result_queue(eosvmoc_config.threads * 2),
-   _threads(eosvmoc_config.threads)
+   _threads(eosvmoc_config.threads),
+   _warmup_contracts(eosvmoc_config.warmup_contracts)
 {
    FC_ASSERT(_threads, "EOS VM OC requires at least 1 compile thread");
 
@@ -88,7 +100,7 @@ std::tuple<size_t, size_t> code_cache_async::consume_compile_thread_queue() {
       if(_outstanding_compiles_and_poison[result.code] == false) {
          std::visit(overloaded {
             [&](const code_descriptor& cd) {
-               _cache_index.push_front(cd);
+               export_code(_cache_index.insert(cd));
             },
             [&](const compilation_result_unknownfailure&) {
                wlog("code ${c} failed to tier-up with EOS VM OC", ("c", result.code.code_id));
@@ -107,6 +119,8 @@ std::tuple<size_t, size_t> code_cache_async::consume_compile_thread_queue() {
 }
 
 const code_descriptor* const code_cache_async::get_descriptor_for_code(const digest_type& code_id, const uint8_t& vm_version) {
+   _cache_index.advance_epoch();
+
    //if there are any outstanding compiles, process the result queue now
    if(_outstanding_compiles_and_poison.size()) {
       auto [count_processed, bytes_remaining] = consume_compile_thread_queue();
@@ -121,10 +135,7 @@ const code_descriptor* const code_cache_async::get_descriptor_for_code(const dig
          // if we got notification of it no longer existing we would have removed it from queued_compiles
          const code_object* const codeobject = _db.find<code_object,by_code_hash>(boost::make_tuple(nextup->code_id, 0, nextup->vm_version));
          if(codeobject) {
-            _outstanding_compiles_and_poison.emplace(*nextup, false);
-            std::vector<wrapped_fd> fds_to_pass;
-            fds_to_pass.emplace_back(memfd_for_bytearray(codeobject->code));
-            FC_ASSERT(write_message_with_fds(_compile_monitor_write_socket, compile_wasm_message{ *nextup }, fds_to_pass), "EOS VM failed to communicate to OOP manager");
+            send_compile(*nextup, *codeobject);
             --count_processed;
          }
          _queued_compiles.erase(nextup);
@@ -132,11 +143,8 @@ const code_descriptor* const code_cache_async::get_descriptor_for_code(const dig
    }
 
    //check for entry in cache
-   code_cache_index::index<by_hash>::type::iterator it = _cache_index.get<by_hash>().find(boost::make_tuple(code_id, vm_version));
-   if(it != _cache_index.get<by_hash>().end()) {
-      _cache_index.relocate(_cache_index.begin(), _cache_index.project<0>(it));
-      return &*it;
-   }
+   if(const code_descriptor* cd = _cache_index.find(code_id, vm_version))
+      return cd;
 
    const code_tuple ct = code_tuple{code_id, vm_version};
 
@@ -148,6 +156,8 @@ const code_descriptor* const code_cache_async::get_descriptor_for_code(const dig
    }
    if(_queued_compiles.find(ct) != _queued_compiles.end())
       return nullptr;
+   if(!tierup_ready(ct))
+      return nullptr;
 
    if(_outstanding_compiles_and_poison.size() >= _threads) {
       _queued_compiles.emplace(ct);
@@ -158,13 +168,51 @@ const code_descriptor* const code_cache_async::get_descriptor_for_code(const dig
    if(!codeobject) //should be impossible right?
       return nullptr;
 
-   _outstanding_compiles_and_poison.emplace(ct, false);
-   std::vector<wrapped_fd> fds_to_pass;
-   fds_to_pass.emplace_back(memfd_for_bytearray(codeobject->code));
-   write_message_with_fds(_compile_monitor_write_socket, compile_wasm_message{ ct }, fds_to_pass);
+   send_compile(ct, *codeobject);
    return nullptr;
 }
 
+void code_cache_async::warmup(const std::function<bool()>& check_shutdown) {
+   if(!_warmup_contracts || _code_last_used.empty())
+      return;
+
+   std::vector<std::pair<uint32_t, code_tuple>> recent;
+   for(const auto& [ct, block_num] : _code_last_used)
+      if(_db.find<code_object,by_code_hash>(boost::make_tuple(ct.code_id, 0, ct.vm_version)))
+         recent.emplace_back(block_num, ct);
+   const size_t n = std::min<size_t>(_warmup_contracts, recent.size());
+   std::partial_sort(recent.begin(), recent.begin() + n, recent.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+   recent.resize(n);
+
+   std::vector<code_tuple> to_compile;
+   for(const auto& r : recent)
+      if(!_cache_index.contains(r.second))
+         to_compile.push_back(r.second);
+   if(to_compile.empty())
+      return;
+
+   ilog("EOS VM OC warming up ${c} of the ${n} most recently used contracts", ("c", to_compile.size())("n", n));
+   const fc::time_point start = fc::time_point::now();
+   size_t next = 0;
+   while((next < to_compile.size() || _outstanding_compiles_and_poison.size()) && !check_shutdown()) {
+      for(; next < to_compile.size() && _outstanding_compiles_and_poison.size() < _threads; ++next) {
+         const code_tuple& ct = to_compile[next];
+         if(_outstanding_compiles_and_poison.count(ct))
+            continue;
+         const code_object* const codeobject = _db.find<code_object,by_code_hash>(boost::make_tuple(ct.code_id, 0, ct.vm_version));
+         if(codeobject)
+            send_compile(ct, *codeobject);
+      }
+      auto [count_processed, bytes_remaining] = consume_compile_thread_queue();
+      if(count_processed)
+         check_eviction_threshold(bytes_remaining);
+      else
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   ilog("EOS VM OC warmup of ${c} contracts took ${t} ms; ${n} entries in code cache",
+        ("c", next)("t", (fc::time_point::now() - start).count() / 1000)("n", _cache_index.size()));
+}
+
 code_cache_sync::~code_cache_sync() {
    //it's exceedingly critical that we wait for the compile monitor to be done with all its work
    //This is easy in the sync case
@@ -175,12 +223,11 @@ code_cache_sync::~code_cache_sync() {
 }
 
 const code_descriptor* const code_cache_sync::get_descriptor_for_code_sync(const digest_type& code_id, const uint8_t& vm_version) {
+   _cache_index.advance_epoch();
+
    //check for entry in cache
-   code_cache_index::index<by_hash>::type::iterator it = _cache_index.get<by_hash>().find(boost::make_tuple(code_id, vm_version));
-   if(it != _cache_index.get<by_hash>().end()) {
-      _cache_index.relocate(_cache_index.begin(), _cache_index.project<0>(it));
-      return &*it;
-   }
+   if(const code_descriptor* cd = _cache_index.find(code_id, vm_version))
+      return cd;
 
    const code_object* const codeobject = _db.find<code_object,by_code_hash>(boost::make_tuple(code_id, 0, vm_version));
    if(!codeobject) //should be impossible right?
@@ -199,18 +246,23 @@ const code_descriptor* const code_cache_sync::get_descriptor_for_code_sync(const
 
    check_eviction_threshold(result.cache_free_bytes);
 
-   return &*_cache_index.push_front(std::move(std::get<code_descriptor>(result.result))).first;
+   const code_descriptor& cd = _cache_index.insert(std::move(std::get<code_descriptor>(result.result)));
+   export_code(cd);
+   return &cd;
 }
 
 code_cache_base::code_cache_base(const boost::filesystem::path data_dir, const eosvmoc::config& eosvmoc_config, const chainbase::database& db) :
    _db(db),
-   _cache_file_path(data_dir/"code_cache.bin")
+   _cache_file_path(data_dir/"code_cache.bin"),
+   _usage_file_path(data_dir/"code_cache_usage.bin"),
+   _tierup_executions(eosvmoc_config.tierup_executions),
+   _tierup_cpu_us(eosvmoc_config.tierup_cpu_us)
 {
    static_assert(sizeof(allocator_t) <= header_offset, "header offset intersects with allocator");
 
    bfs::create_directories(data_dir);
 
-   if(!bfs::exists(_cache_file_path)) {
+   auto create_cache_file = [&]() {
       EOS_ASSERT(eosvmoc_config.cache_size >= allocator_t::get_min_size(total_header_size), database_exception, "configured code cache size is too small");
       std::ofstream ofs(_cache_file_path.generic_string(), std::ofstream::trunc);
       EOS_ASSERT(ofs.good(), database_exception, "unable to create EOS VM Optimized Compiler code cache");
@@ -219,18 +271,31 @@ code_cache_base::code_cache_base(const boost::filesystem::path data_dir, const e
       bip::mapped_region creation_region(creation_mapping, bip::read_write);
       new (creation_region.get_address()) allocator_t(eosvmoc_config.cache_size, total_header_size);
       new ((char*)creation_region.get_address() + header_offset) code_cache_header;
-   }
+   };
 
-   code_cache_header cache_header;
-   {
+   auto read_cache_header = [&]() {
+      code_cache_header cache_header;
       char header_buff[total_header_size];
       std::ifstream hs(_cache_file_path.generic_string(), std::ifstream::binary);
       hs.read(header_buff, sizeof(header_buff));
       EOS_ASSERT(!hs.fail(), bad_database_version_exception, "failed to read code cache header");
       memcpy((char*)&cache_header, header_buff + header_offset, sizeof(cache_header));
-   }
+      return cache_header;
+   };
+
+   if(!bfs::exists(_cache_file_path))
+      create_cache_file();
+
+   code_cache_header cache_header = read_cache_header();
 
    EOS_ASSERT(cache_header.id == header_id, bad_database_version_exception, "existing EOS VM OC code cache not compatible with this version");
+   //after a crash the cache can't be trusted, but with an import directory it can be rebuilt without compiling
+   if(cache_header.dirty && !eosvmoc_config.import_dir.empty()) {
+      wlog("EOS VM OC code cache is dirty, recreating it from ${d}", ("d", eosvmoc_config.import_dir.generic_string()));
+      bfs::remove(_cache_file_path);
+      create_cache_file();
+      cache_header = read_cache_header();
+   }
    EOS_ASSERT(!cache_header.dirty, database_exception, "code cache is dirty");
 
    set_on_disk_region_dirty(true);
@@ -249,16 +314,20 @@ code_cache_base::code_cache_base(const boost::filesystem::path data_dir, const e
    _cache_fd = ::open(_cache_file_path.generic_string().c_str(), O_RDWR | O_CLOEXEC);
    EOS_ASSERT(_cache_fd >= 0, database_exception, "failure to open code cache");
 
+   _free_bytes_eviction_threshold = eosvmoc_config.cache_size * .1;
+
    //load up the previous cache index
    char* code_mapping = (char*)mmap(nullptr, eosvmoc_config.cache_size, PROT_READ|PROT_WRITE, MAP_SHARED, _cache_fd, 0);
    EOS_ASSERT(code_mapping != MAP_FAILED, database_exception, "failure to mmap code cache");
 
    allocator_t* allocator = reinterpret_cast<allocator_t*>(code_mapping);
 
+   std::vector<code_descriptor> loaded;
    if(cache_header.serialized_descriptor_index) {
       fc::datastream<const char*> ds(code_mapping + cache_header.serialized_descriptor_index, eosvmoc_config.cache_size - cache_header.serialized_descriptor_index);
       unsigned number_entries;
       fc::raw::unpack(ds, number_entries);
+      loaded.reserve(number_entries);
       for(unsigned i = 0; i < number_entries; ++i) {
          code_descriptor cd;
          fc::raw::unpack(ds, cd);
@@ -267,15 +336,33 @@ code_cache_base::code_cache_base(const boost::filesystem::path data_dir, const e
             allocator->deallocate(code_mapping + cd.initdata_begin);
             continue;
          }
-         _cache_index.push_back(std::move(cd));
+         loaded.push_back(std::move(cd));
       }
       allocator->deallocate(code_mapping + cache_header.serialized_descriptor_index);
 
       ilog("EOS VM Optimized Compiler code cache loaded with ${c} entries; ${f} of ${t} bytes free", ("c", number_entries)("f", allocator->get_free_memory())("t", allocator->get_size()));
    }
+   if(!eosvmoc_config.import_dir.empty())
+      import_code(eosvmoc_config.import_dir, code_mapping, loaded);
+   _cache_index.insert_by_recency(std::move(loaded));
    munmap(code_mapping, eosvmoc_config.cache_size);
 
-   _free_bytes_eviction_threshold = eosvmoc_config.cache_size * .1;
+   if(!eosvmoc_config.export_dir.empty()) {
+      _export_dir = exported_code_dir(eosvmoc_config.export_dir);
+      bfs::create_directories(_export_dir);
+      struct stat st;
+      EOS_ASSERT(fstat(_cache_fd, &st) == 0, database_exception, "failure to stat code cache");
+      _export_mapping_size = st.st_size;
+      _export_mapping = (char*)mmap(nullptr, _export_mapping_size, PROT_READ, MAP_SHARED, _cache_fd, 0);
+      EOS_ASSERT(_export_mapping != MAP_FAILED, database_exception, "failure to mmap code cache");
+      //entries compiled before exporting was enabled, or imported from elsewhere. Written here rather than queued
+      //for the export thread so that the copies of a full cache are not all held at once
+      for(const code_descriptor& cd : _cache_index.by_recency())
+         write_exported_code(_export_dir, make_exported_code_entry(cd));
+      _export_thread.emplace("ocexp", 1);
+   }
+
+   load_code_usage();
 
    wrapped_fd compile_monitor_conn = get_connection_to_compile_monitor(_cache_fd);
 
@@ -296,14 +383,21 @@ void code_cache_base::set_on_disk_region_dirty(bool dirty) {
 }
 
 template <typename T>
-void code_cache_base::serialize_cache_index(fc::datastream<T>& ds) {
-   unsigned entries = _cache_index.size();
+void code_cache_base::serialize_cache_index(fc::datastream<T>& ds, const std::vector<code_descriptor>& descriptors) {
+   unsigned entries = descriptors.size();
    fc::raw::pack(ds, entries);
-   for(const code_descriptor& cd : _cache_index)
+   for(const code_descriptor& cd : descriptors)
       fc::raw::pack(ds, cd);
 }
 
 code_cache_base::~code_cache_base() {
+   persist_code_usage();
+
+   //queued exports not written yet are dropped, entries still cached are exported again at the next start
+   _export_thread.reset();
+   if(_export_mapping)
+      munmap(_export_mapping, _export_mapping_size);
+
    //reopen the code cache in our process
    struct stat st;
    if(fstat(_cache_fd, &st))
@@ -314,28 +408,29 @@ code_cache_base::~code_cache_base() {
 
    allocator_t* allocator = reinterpret_cast<allocator_t*>(code_mapping);
 
-   //serialize out the cache index
-   fc::datastream<size_t> dssz;
-   serialize_cache_index(dssz);
-   size_t sz = dssz.tellp();
-
+   //serialize out the cache index, most recently used first
+   std::vector<code_descriptor> descriptors = _cache_index.by_recency();
    char* p = nullptr;
-   while(_cache_index.size()) {
+   size_t sz = 0;
+   while(descriptors.size()) {
+      fc::datastream<size_t> dssz;
+      serialize_cache_index(dssz, descriptors);
+      sz = dssz.tellp();
       p = (char*)allocator->allocate(sz);
       if(p != nullptr)
          break;
       //in theory, there could be too little free space avaiable to store the cache index
       //try to free up some space
-      for(unsigned int i = 0; i < 25 && _cache_index.size(); ++i) {
-         allocator->deallocate(code_mapping + _cache_index.back().code_begin);
-         allocator->deallocate(code_mapping + _cache_index.back().initdata_begin);
-         _cache_index.pop_back();
+      for(unsigned int i = 0; i < 25 && descriptors.size(); ++i) {
+         allocator->deallocate(code_mapping + descriptors.back().code_begin);
+         allocator->deallocate(code_mapping + descriptors.back().initdata_begin);
+         descriptors.pop_back();
       }
    }
 
    if(p) {
       fc::datastream<char*> ds(p, sz);
-      serialize_cache_index(ds);
+      serialize_cache_index(ds, descriptors);
 
       uintptr_t ptr_offset = p-code_mapping;
       *((uintptr_t*)(code_mapping+descriptor_ptr_from_file_start)) = ptr_offset;
@@ -351,14 +446,13 @@ code_cache_base::~code_cache_base() {
 }
 
 void code_cache_base::free_code(const digest_type& code_id, const uint8_t& vm_version) {
-   code_cache_index::index<by_hash>::type::iterator it = _cache_index.get<by_hash>().find(boost::make_tuple(code_id, vm_version));
-   if(it != _cache_index.get<by_hash>().end()) {
-      write_message_with_fds(_compile_monitor_write_socket, evict_wasms_message{ {*it} });
-      _cache_index.get<by_hash>().erase(it);
-   }
+   if(std::optional<code_descriptor> cd = _cache_index.erase({code_id, vm_version}))
+      write_message_with_fds(_compile_monitor_write_socket, evict_wasms_message{ {*cd} });
 
    //if it's in the queued list, erase it
    _queued_compiles.erase({code_id, vm_version});
+   _code_last_used.erase({code_id, vm_version});
+   _hotness.erase({code_id, vm_version});
 
    //however, if it's currently being compiled there is no way to cancel the compile,
    //so instead set a poison boolean that indicates not to insert the code in to the cache
@@ -368,12 +462,161 @@ void code_cache_base::free_code(const digest_type& code_id, const uint8_t& vm_ve
       compiling_it->second = true;
 }
 
+void code_cache_base::code_used(const digest_type& code_id, const uint8_t& vm_version, uint32_t block_num) {
+   _code_last_used[code_tuple{code_id, vm_version}] = block_num;
+   if(block_num >= _hotness_decayed_block_num + hotness_decay_interval_blocks) {
+      decay_hotness();
+      _hotness_decayed_block_num = block_num;
+   }
+   //also persisted on shutdown; periodically writing it out keeps the ranking useful after a crash
+   if(block_num >= _usage_persisted_block_num + usage_persist_interval_blocks) {
+      if(_usage_persisted_block_num)
+         persist_code_usage();
+      _usage_persisted_block_num = block_num;
+   }
+}
+
+void code_cache_base::add_baseline_cpu(const digest_type& code_id, const uint8_t& vm_version, uint64_t cpu_us) {
+   if(auto it = _hotness.find(code_tuple{code_id, vm_version}); it != _hotness.end())
+      it->second.cpu_us += cpu_us;
+}
+
+bool code_cache_base::tierup_ready(const code_tuple& ct) {
+   if(!tierup_thresholds_enabled())
+      return true;
+   code_hotness& h = _hotness[ct];
+   ++h.executions;
+   if((_tierup_executions && h.executions >= _tierup_executions) || (_tierup_cpu_us && h.cpu_us >= _tierup_cpu_us)) {
+      _hotness.erase(ct);
+      return true;
+   }
+   return false;
+}
+
+void code_cache_base::decay_hotness() {
+   for(auto it = _hotness.begin(); it != _hotness.end();) {
+      it->second.executions /= 2;
+      it->second.cpu_us /= 2;
+      if(it->second.executions == 0)
+         it = _hotness.erase(it);
+      else
+         ++it;
+   }
+}
+
+void code_cache_base::load_code_usage() {
+   if(!bfs::exists(_usage_file_path))
+      return;
+   try {
+      std::ifstream ifs(_usage_file_path.generic_string(), std::ifstream::binary);
+      std::vector<char> buff((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+      std::vector<code_usage_entry> entries;
+      fc::datastream<const char*> ds(buff.data(), buff.size());
+      fc::raw::unpack(ds, entries);
+      for(const code_usage_entry& e : entries)
+         _code_last_used[e.code] = e.last_block_num_used;
+   } catch(const fc::exception& e) {
+      wlog("failed to load EOS VM OC code usage from ${f}: ${e}", ("f", _usage_file_path.generic_string())("e", e.to_detail_string()));
+   } catch(const std::exception& e) {
+      wlog("failed to load EOS VM OC code usage from ${f}: ${e}", ("f", _usage_file_path.generic_string())("e", e.what()));
+   }
+}
+
+void code_cache_base::persist_code_usage() {
+   std::vector<code_usage_entry> entries;
+   entries.reserve(_code_last_used.size());
+   for(const auto& [ct, block_num] : _code_last_used)
+      entries.push_back(code_usage_entry{ct, block_num});
+
+   try {
+      //write then rename so a crash never leaves a truncated file behind
+      const bfs::path tmp_path = _usage_file_path.generic_string() + ".tmp";
+      {
+         std::ofstream ofs(tmp_path.generic_string(), std::ofstream::binary | std::ofstream::trunc);
+         const std::vector<char> buff = fc::raw::pack(entries);
+         ofs.write(buff.data(), buff.size());
+         EOS_ASSERT(ofs.good(), database_exception, "failed to write ${f}", ("f", tmp_path.generic_string()));
+      }
+      bfs::rename(tmp_path, _usage_file_path);
+   } catch(const fc::exception& e) {
+      wlog("failed to persist EOS VM OC code usage to ${f}: ${e}", ("f", _usage_file_path.generic_string())("e", e.to_detail_string()));
+   } catch(const std::exception& e) {
+      wlog("failed to persist EOS VM OC code usage to ${f}: ${e}", ("f", _usage_file_path.generic_string())("e", e.what()));
+   }
+}
+
+void code_cache_base::send_compile(const code_tuple& ct, const code_object& codeobject) {
+   _outstanding_compiles_and_poison.emplace(ct, false);
+   std::vector<wrapped_fd> fds_to_pass;
+   fds_to_pass.emplace_back(memfd_for_bytearray(codeobject.code));
+   FC_ASSERT(write_message_with_fds(_compile_monitor_write_socket, compile_wasm_message{ ct }, fds_to_pass), "EOS VM failed to communicate to OOP manager");
+}
+
+const code_descriptor& code_descriptor_table::insert(code_descriptor cd) {
+   const code_tuple ct{cd.code_hash, cd.vm_version};
+   return _table.emplace(ct, std::move(cd), _epoch.load(std::memory_order_relaxed)).descriptor;
+}
+
+void code_descriptor_table::insert_by_recency(std::vector<code_descriptor> cds) {
+   //give them the most recent epochs, counting down so that they keep their order
+   const uint64_t epoch = _epoch.load(std::memory_order_relaxed);
+   _epoch.store(epoch + cds.size(), std::memory_order_relaxed);
+   uint64_t e = epoch + cds.size();
+   for(code_descriptor& cd : cds) {
+      const code_tuple ct{cd.code_hash, cd.vm_version};
+      if(!_table.find(ct))
+         _table.emplace(ct, std::move(cd), --e);
+   }
+}
+
+std::optional<code_descriptor> code_descriptor_table::erase(const code_tuple& ct) {
+   const entry* e = _table.find(ct);
+   if(!e)
+      return {};
+   std::optional<code_descriptor> result = e->descriptor;
+   _table.erase(ct);
+   return result;
+}
+
+std::vector<code_descriptor> code_descriptor_table::evict(size_t n, size_t keep_at_least) {
+   std::vector<code_descriptor> evicted;
+   if(_table.size() <= keep_at_least)
+      return evicted;
+   n = std::min(n, _table.size() - keep_at_least);
+
+   std::vector<std::pair<uint64_t, const entry*>> by_epoch;
+   by_epoch.reserve(_table.size());
+   _table.for_each([&](const code_tuple&, const entry& e) {
+      by_epoch.emplace_back(e.last_used_epoch.load(std::memory_order_relaxed), &e);
+   });
+   std::nth_element(by_epoch.begin(), by_epoch.begin() + n, by_epoch.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+   evicted.reserve(n);
+   for(size_t i = 0; i < n; ++i)
+      evicted.push_back(by_epoch[i].second->descriptor);
+   for(const code_descriptor& cd : evicted)
+      _table.erase({cd.code_hash, cd.vm_version});
+   return evicted;
+}
+
+std::vector<code_descriptor> code_descriptor_table::by_recency() const {
+   std::vector<std::pair<uint64_t, const code_descriptor*>> by_epoch;
+   by_epoch.reserve(_table.size());
+   _table.for_each([&](const code_tuple&, const entry& e) {
+      by_epoch.emplace_back(e.last_used_epoch.load(std::memory_order_relaxed), &e.descriptor);
+   });
+   std::sort(by_epoch.begin(), by_epoch.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+   std::vector<code_descriptor> result;
+   result.reserve(by_epoch.size());
+   for(const auto& [epoch, cd] : by_epoch)
+      result.push_back(*cd);
+   return result;
+}
+
 void code_cache_base::run_eviction_round() {
    evict_wasms_message evict_msg;
-   for(unsigned int i = 0; i < 25 && _cache_index.size() > 1; ++i) {
-      evict_msg.codes.emplace_back(_cache_index.back());
-      _cache_index.pop_back();
-   }
+   evict_msg.codes = _cache_index.evict(25, 1);
    write_message_with_fds(_compile_monitor_write_socket, evict_msg);
 }
 
@@ -382,4 +625,129 @@ void code_cache_base::check_eviction_threshold(size_t free_bytes) {
       run_eviction_round();
 }
 
+bfs::path code_cache_base::exported_code_dir(const bfs::path& dir) {
+   return dir / (std::to_string(current_codegen_version) + "-" + exported_code_compiler);
+}
+
+exported_code_entry code_cache_base::make_exported_code_entry(const code_descriptor& cd) const {
+   const allocator_t* allocator = reinterpret_cast<const allocator_t*>(_export_mapping);
+   const char* code = _export_mapping + cd.code_begin;
+   const char* initdata = _export_mapping + cd.initdata_begin;
+
+   exported_code_entry e;
+   e.id = exported_code_id;
+   e.codegen_version = cd.codegen_version;
+   e.compiler = exported_code_compiler;
+   e.code = code_tuple{cd.code_hash, cd.vm_version};
+   e.start = cd.start;
+   e.apply_offset = cd.apply_offset;
+   e.starting_memory_pages = cd.starting_memory_pages;
+   e.initdata_prologue_size = cd.initdata_prologue_size;
+   e.code_bytes.assign(code, code + allocator->size(code));
+   e.initdata.assign(initdata, initdata + cd.initdata_size);
+   return e;
+}
+
+void code_cache_base::write_exported_code(const bfs::path& export_dir, const exported_code_entry& e) {
+   const bfs::path path = export_dir / (e.code.code_id.str() + "-" + std::to_string(e.code.vm_version) + exported_code_extension);
+   try {
+      //content addressed, an existing file holds the same code
+      if(bfs::exists(path))
+         return;
+
+      const std::vector<char> buff = fc::raw::pack(e);
+      const fc::sha256 checksum = fc::sha256::hash(buff.data(), buff.size());
+
+      //the directory may be shared with other nodes, possibly on other hosts; write to a randomly named file and
+      //rename it so readers never see a partial file
+      const bfs::path tmp_path = path.generic_string() + "." + bfs::unique_path().generic_string() + ".tmp";
+      {
+         std::ofstream ofs(tmp_path.generic_string(), std::ofstream::binary | std::ofstream::trunc);
+         ofs.write(buff.data(), buff.size());
+         ofs.write(checksum.data(), checksum.data_size());
+         EOS_ASSERT(ofs.good(), database_exception, "failed to write ${f}", ("f", tmp_path.generic_string()));
+      }
+      bfs::rename(tmp_path, path);
+   } catch(const fc::exception& e) {
+      wlog("failed to export EOS VM OC compiled code to ${f}: ${e}", ("f", path.generic_string())("e", e.to_detail_string()));
+   } catch(const std::exception& e) {
+      wlog("failed to export EOS VM OC compiled code to ${f}: ${e}", ("f", path.generic_string())("e", e.what()));
+   }
+}
+
+void code_cache_base::export_code(const code_descriptor& cd) {
+   if(!_export_mapping)
+      return;
+   //copied now, the space of the entry is reused once it is evicted. Writing the file is left to the export thread
+   auto e = std::make_shared<const exported_code_entry>(make_exported_code_entry(cd));
+   boost::asio::post(_export_thread->get_executor(), [export_dir=_export_dir, e]() {
+      write_exported_code(export_dir, *e);
+   });
+}
+
+void code_cache_base::import_code(const bfs::path& import_dir, char* code_mapping, std::vector<code_descriptor>& loaded) {
+   const bfs::path dir = exported_code_dir(import_dir);
+   if(!bfs::is_directory(dir)) {
+      ilog("no EOS VM OC compiled code for this version in ${d}", ("d", import_dir.generic_string()));
+      return;
+   }
+
+   allocator_t* allocator = reinterpret_cast<allocator_t*>(code_mapping);
+   std::unordered_set<code_tuple> present;
+   for(const code_descriptor& cd : loaded)
+      present.emplace(code_tuple{cd.code_hash, cd.vm_version});
+
+   size_t imported = 0;
+   for(const bfs::directory_entry& de : bfs::directory_iterator(dir)) {
+      if(de.path().extension() != exported_code_extension)
+         continue;
+      //leave room for new compiles, imported entries are least recently used
+      if(allocator->get_free_memory() < _free_bytes_eviction_threshold) {
+         wlog("EOS VM OC code cache is full, not importing any more compiled code");
+         break;
+      }
+      try {
+         std::ifstream ifs(de.path().generic_string(), std::ifstream::binary);
+         const std::vector<char> buff((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+         fc::sha256 checksum;
+         EOS_ASSERT(buff.size() > checksum.data_size(), database_exception, "truncated file");
+         const size_t size = buff.size() - checksum.data_size();
+         memcpy(checksum.data(), buff.data() + size, checksum.data_size());
+         EOS_ASSERT(fc::sha256::hash(buff.data(), size) == checksum, database_exception, "checksum mismatch");
+
+         exported_code_entry e;
+         fc::datastream<const char*> ds(buff.data(), size);
+         fc::raw::unpack(ds, e);
+         EOS_ASSERT(e.id == exported_code_id && e.codegen_version == current_codegen_version && e.compiler == exported_code_compiler,
+                    bad_database_version_exception, "compiled by an incompatible version");
+
+         if(!present.insert(e.code).second)
+            continue;
+
+         char* code = (char*)allocator->allocate(e.code_bytes.size());
+         char* initdata = code ? (char*)allocator->allocate(e.initdata.size()) : nullptr;
+         if(!initdata) {
+            if(code)
+               allocator->deallocate(code);
+            wlog("EOS VM OC code cache is full, not importing any more compiled code");
+            break;
+         }
+         memcpy(code, e.code_bytes.data(), e.code_bytes.size());
+         memcpy(initdata, e.initdata.data(), e.initdata.size());
+
+         loaded.push_back(code_descriptor{e.code.code_id, e.code.vm_version, e.codegen_version, (size_t)(code - code_mapping), e.start,
+                                          e.apply_offset, e.starting_memory_pages, (size_t)(initdata - code_mapping),
+                                          (unsigned)e.initdata.size(), e.initdata_prologue_size});
+         ++imported;
+      } catch(const fc::exception& e) {
+         wlog("failed to import EOS VM OC compiled code from ${f}: ${e}", ("f", de.path().generic_string())("e", e.to_detail_string()));
+      } catch(const std::exception& e) {
+         wlog("failed to import EOS VM OC compiled code from ${f}: ${e}", ("f", de.path().generic_string())("e", e.what()));
+      }
+   }
+
+   ilog("imported ${n} EOS VM OC compiled contracts from ${d}; ${f} of ${t} bytes free",
+        ("n", imported)("d", dir.generic_string())("f", allocator->get_free_memory())("t", allocator->get_size()));
+}
+
 }}}
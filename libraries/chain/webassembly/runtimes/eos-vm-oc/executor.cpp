@@ -173,11 +173,18 @@ void executor::execute(const code_descriptor& code, memory& mem, apply_context&
                   (code.starting_memory_pages - initial_page_offset) * eosio::chain::wasm_constraints::wasm_page_size, PROT_READ | PROT_WRITE);
       }
       arch_prctl(ARCH_SET_GS, (unsigned long*)(mem.zero_page_memory_base()+initial_page_offset*memory::stride));
-      memset(mem.full_page_memory_base(), 0, 64u*1024u*code.starting_memory_pages);
    }
    else
       arch_prctl(ARCH_SET_GS, (unsigned long*)mem.zero_page_memory_base());
 
+   //linear memory is left zeroed by the previous execution, so instead of clearing the initial memory up front only
+   //what this execution dirtied is cleared once it is done
+   control_block* const cb = mem.get_control_block();
+   cb->peak_linear_memory_pages = std::max(code.starting_memory_pages, 0);
+   auto reset_memory = fc::make_scoped_exit([cb, &mem=mem](){
+      mem.reset_linear_memory(cb->peak_linear_memory_pages);
+   });
+
    void* globals;
    if(code.initdata_prologue_size > memory::max_prologue_size) {
       globals_buffer.resize(code.initdata_prologue_size);
@@ -191,7 +198,6 @@ void executor::execute(const code_descriptor& code, memory& mem, apply_context&
       globals = mem.full_page_memory_base();
    }
 
-   control_block* const cb = mem.get_control_block();
    cb->magic = signal_sentinel;
    cb->execution_thread_code_start = (uintptr_t)code_mapping;
    cb->execution_thread_code_length = code_mapping_size;
@@ -44,8 +44,16 @@ int32_t eos_vm_oc_grow_memory(int32_t grow, int32_t max) {
    cb_ptr->current_linear_memory_pages += grow_amount;
    cb_ptr->first_invalid_memory_address += grow_amount*64*1024;
 
-   if(grow_amount > 0)
-      memset(cb_ptr->full_linear_memory_start + previous_page_count*64u*1024u, 0, grow_amount*64u*1024u);
+   if(grow_amount > 0) {
+      //only pages below the peak can hold data from earlier in this execution
+      int64_t dirty_pages = cb_ptr->peak_linear_memory_pages - (int64_t)previous_page_count;
+      if(dirty_pages > grow_amount)
+         dirty_pages = grow_amount;
+      if(dirty_pages > 0)
+         memset(cb_ptr->full_linear_memory_start + previous_page_count*64u*1024u, 0, dirty_pages*64u*1024u);
+      if(cb_ptr->current_linear_memory_pages > cb_ptr->peak_linear_memory_pages)
+         cb_ptr->peak_linear_memory_pages = cb_ptr->current_linear_memory_pages;
+   }
 
    return (int32_t)previous_page_count;
 }
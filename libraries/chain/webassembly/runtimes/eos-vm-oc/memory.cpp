@@ -4,6 +4,10 @@
 
 #include <fc/scoped_exit.hpp>
 
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <sys/mman.h>
@@ -14,9 +18,9 @@ namespace eosio { namespace chain { namespace eosvmoc {
 memory::memory(uint64_t max_pages) {
    uint64_t number_slices = max_pages + 1;
    uint64_t wasm_memory_size = max_pages * wasm_constraints::wasm_page_size;
-   int fd = syscall(SYS_memfd_create, "eosvmoc_mem", MFD_CLOEXEC);
+   fd = syscall(SYS_memfd_create, "eosvmoc_mem", MFD_CLOEXEC);
    FC_ASSERT(fd >= 0, "Failed to create memory memfd");
-   auto cleanup_fd = fc::make_scoped_exit([&fd](){close(fd);});
+   auto cleanup_fd = fc::make_scoped_exit([this](){close(fd);});
    int ret = ftruncate(fd, wasm_memory_size+memory_prologue_size);
    FC_ASSERT(!ret, "Failed to grow memory memfd");
 
@@ -42,20 +46,51 @@ memory::memory(uint64_t max_pages) {
    const intrinsic_map_t& intrinsics = get_intrinsic_map();
    for(const auto& intrinsic : intrinsics)
       intrinsic_jump_table[-intrinsic.second.ordinal] = (uintptr_t)intrinsic.second.function_ptr;
+
+   //kept open for reset_linear_memory()
+   cleanup_fd.cancel();
 }
 
 void memory::reset(uint64_t max_pages) {
    uint64_t old_max_pages = mapsize / memory::total_memory_per_slice - 1;
    if(max_pages == old_max_pages) return;
    memory new_memory{max_pages};
+   std::swap(fd, new_memory.fd);
    std::swap(mapbase, new_memory.mapbase);
    std::swap(mapsize, new_memory.mapsize);
    std::swap(zeropage_base, new_memory.zeropage_base);
    std::swap(fullpage_base, new_memory.fullpage_base);
 }
 
+void memory::reset_linear_memory(uint64_t pages) {
+   const uint64_t base_pages = mapsize / memory::total_memory_per_slice - 1;
+   const uint64_t memfd_pages = std::min(pages, base_pages);
+
+   if(memfd_pages <= zero_linear_memory_max_pages)
+      zero_linear_memory(memfd_pages);
+   else
+      release_linear_memory(memfd_pages);
+
+   //pages past the memfd are private anonymous memory in the last slice, dropping them zeroes them
+   if(pages > base_pages)
+      madvise(fullpage_base + base_pages * wasm_constraints::wasm_page_size, (pages - base_pages) * wasm_constraints::wasm_page_size, MADV_DONTNEED);
+}
+
+void memory::zero_linear_memory(uint64_t pages) {
+   memset(fullpage_base, 0, pages * wasm_constraints::wasm_page_size);
+}
+
+void memory::release_linear_memory(uint64_t pages) {
+   //A memfd only has pages where it has been touched, everything else is a hole that reads as zero. Punching a hole
+   //over the range frees the touched pages, including swapped out ones, and costs nothing for the holes
+   const uint64_t bytes = pages * wasm_constraints::wasm_page_size;
+   if(bytes && fallocate(fd, FALLOC_FL_PUNCH_HOLE|FALLOC_FL_KEEP_SIZE, memory_prologue_size, bytes))
+      memset(fullpage_base, 0, bytes);
+}
+
 memory::~memory() {
    munmap(mapbase, mapsize);
+   close(fd);
 }
 
 }}}
@@ -127,8 +127,13 @@ class eos_vm_instantiated_module : public wasm_instantiated_module_interface {
          _runtime(runtime),
          _instantiated_module(std::move(mod)) {}
 
+      ~eos_vm_instantiated_module() {
+         if(_memory)
+            --_runtime->_dedicated_memories;
+      }
+
       void apply(apply_context& context) override {
-         _instantiated_module->set_wasm_allocator(&context.control.get_wasm_allocator());
+         _instantiated_module->set_wasm_allocator(linear_memory(context));
          _runtime->_bkend = _instantiated_module.get();
          apply_options opts;
          if(context.control.is_builtin_activated(builtin_protocol_feature_t::configurable_wasm_limits)) {
@@ -158,8 +163,24 @@ class eos_vm_instantiated_module : public wasm_instantiated_module_interface {
       }
 
    private:
+      // Initializing the backend zeroes every page its allocator handed out last time, dirtied or not, and copies the
+      // data segments back in. With the allocator shared by every contract that means clearing whatever the previous
+      // contract used, however large. A hot contract instead keeps an allocator of its own, so each action clears
+      // this contract's own previous footprint, which stays mapped in between. That footprint is at least its
+      // initial memory, so a contract with a large initial memory gains nothing from it.
+      vm::wasm_allocator* linear_memory(apply_context& context) {
+         if(!_memory && ++_applies >= eos_vm_runtime<Impl>::dedicated_memory_threshold &&
+            _runtime->_dedicated_memories < eos_vm_runtime<Impl>::max_dedicated_memories) {
+            _memory = std::make_unique<vm::wasm_allocator>();
+            ++_runtime->_dedicated_memories;
+         }
+         return _memory ? _memory.get() : &context.control.get_wasm_allocator();
+      }
+
       eos_vm_runtime<Impl>*            _runtime;
       std::unique_ptr<backend_t> _instantiated_module;
+      std::unique_ptr<vm::wasm_allocator> _memory;
+      uint32_t                         _applies = 0;
 };
 
 #ifdef __x86_64__
@@ -1,8 +1,13 @@
 #include <eosio/chain_api_plugin/chain_api_plugin.hpp>
 #include <eosio/chain/exceptions.hpp>
+#include <eosio/chain/thread_utils.hpp>
 
 #include <fc/io/json.hpp>
 
+#include <boost/asio/post.hpp>
+
+#include <shared_mutex>
+
 namespace eosio {
 
 static appbase::abstract_plugin& _chain_api_plugin = app().register_plugin<chain_api_plugin>();
@@ -15,14 +20,31 @@ public:
       : db(db) {}
 
    controller& db;
+   uint16_t read_threads = 2;
+   /// runs the calls that read the chain under the controller state mutex, so waiting for it never parks http threads
+   std::optional<eosio::chain::named_thread_pool> read_thread_pool;
 };
 
 
 chain_api_plugin::chain_api_plugin(){}
 chain_api_plugin::~chain_api_plugin(){}
 
-void chain_api_plugin::set_program_options(options_description&, options_description&) {}
-void chain_api_plugin::plugin_initialize(const variables_map&) {}
+void chain_api_plugin::set_program_options(options_description&, options_description& cfg) {
+   cfg.add_options()
+         ("chain-api-read-threads", boost::program_options::value<uint16_t>()->default_value(2),
+          "Number of worker threads running the chain API calls that read the chain off the main thread, get_block, "
+          "get_account, get_table_rows and similar. They wait for the main thread between transactions.")
+         ;
+}
+
+void chain_api_plugin::plugin_initialize(const variables_map& options) {
+   try {
+      my.reset(new chain_api_plugin_impl(app().get_plugin<chain_plugin>().chain()));
+      my->read_threads = options.at("chain-api-read-threads").as<uint16_t>();
+      EOS_ASSERT( my->read_threads > 0, chain::plugin_config_exception,
+                  "chain-api-read-threads ${num} must be greater than 0", ("num", my->read_threads) );
+   } FC_LOG_AND_RETHROW()
+}
 
 struct async_result_visitor : public fc::visitor<fc::variant> {
    template<typename T>
@@ -61,6 +83,75 @@ parse_params<chain_apis::read_only::get_transaction_status_params, http_params_t
           } \
        }}
 
+// Same as CALL_WITH_400 for calls run on the read thread pool. The chain is read under a shared lock of the
+// controller state mutex, so it does not change underneath the call.
+#define CALL_LOCKED_WITH_400(api_name, api_handle, api_namespace, call_name, http_response_code, params_type) \
+{std::string("/v1/" #api_name "/" #call_name), \
+   [api_handle, &state_mutex, &read_threads](string, string body, url_response_callback cb) mutable { \
+          api_handle.validate(); \
+          try { \
+             auto params = parse_params<api_namespace::call_name ## _params, params_type>(body);\
+             boost::asio::post( read_threads, [api_handle, &state_mutex, params=std::move(params), body=std::move(body), cb=std::move(cb)]() mutable { \
+                try { \
+                   std::shared_lock<chain::writer_priority_mutex> g( state_mutex ); \
+                   auto result = api_handle.call_name( std::move(params) ); \
+                   g.unlock(); \
+                   cb(http_response_code, fc::variant( std::move(result) )); \
+                } catch (...) { \
+                   http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+                } \
+             }); \
+          } catch (...) { \
+             http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+          } \
+       }}
+
+// Same as CALL_LOCKED_WITH_400 for calls returning a block with its block_num. A response that never changes, see
+// is_immutable_block, is marked immutable for the http_plugin response cache.
+#define CALL_LOCKED_BLOCK_WITH_400(api_name, api_handle, api_namespace, call_name, http_response_code, params_type) \
+{std::string("/v1/" #api_name "/" #call_name), \
+   [api_handle, &state_mutex, &read_threads, max_response_time](string, string body, url_response_callback cb) mutable { \
+          api_handle.validate(); \
+          try { \
+             auto params = parse_params<api_namespace::call_name ## _params, params_type>(body);\
+             boost::asio::post( read_threads, [api_handle, &state_mutex, max_response_time, params=std::move(params), body=std::move(body), cb=std::move(cb)]() mutable { \
+                try { \
+                   std::shared_lock<chain::writer_priority_mutex> g( state_mutex ); \
+                   auto result = api_handle.call_name( std::move(params) ); \
+                   const bool immutable = api_handle.is_immutable_block( result ); \
+                   g.unlock(); \
+                   cb(http_response_code, json_body{ fc::json::to_string( result, fc::time_point::now() + max_response_time ), immutable }); \
+                } catch (...) { \
+                   http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+                } \
+             }); \
+          } catch (...) { \
+             http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+          } \
+       }}
+
+// call_name ## _stream copies what the response needs under the lock, its JSON is created and sent in pieces after
+#define CALL_LOCKED_STREAM_WITH_400(api_name, api_handle, api_namespace, call_name, http_response_code, params_type) \
+{std::string("/v1/" #api_name "/" #call_name), \
+   [api_handle, &state_mutex, &read_threads](string, string body, url_response_callback cb) mutable { \
+          api_handle.validate(); \
+          try { \
+             auto params = parse_params<api_namespace::call_name ## _params, params_type>(body);\
+             boost::asio::post( read_threads, [api_handle, &state_mutex, params=std::move(params), body=std::move(body), cb=std::move(cb)]() mutable { \
+                try { \
+                   std::shared_lock<chain::writer_priority_mutex> g( state_mutex ); \
+                   auto stream = api_handle.call_name ## _stream( std::move(params) ); \
+                   g.unlock(); \
+                   cb(http_response_code, chunked_body{ std::move(stream.next), false, stream.held_bytes }); \
+                } catch (...) { \
+                   http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+                } \
+             }); \
+          } catch (...) { \
+             http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+          } \
+       }}
+
 #define CALL_ASYNC_WITH_400(api_name, api_handle, api_namespace, call_name, call_result, http_response_code, params_type) \
 {std::string("/v1/" #api_name "/" #call_name), \
    [api_handle](string, string body, url_response_callback cb) mutable { \
@@ -86,6 +177,9 @@ parse_params<chain_apis::read_only::get_transaction_status_params, http_params_t
 }
 
 #define CHAIN_RO_CALL(call_name, http_response_code, params_type) CALL_WITH_400(chain, ro_api, chain_apis::read_only, call_name, http_response_code, params_type)
+#define CHAIN_RO_CALL_LOCKED(call_name, http_response_code, params_type) CALL_LOCKED_WITH_400(chain, ro_api, chain_apis::read_only, call_name, http_response_code, params_type)
+#define CHAIN_RO_CALL_LOCKED_BLOCK(call_name, http_response_code, params_type) CALL_LOCKED_BLOCK_WITH_400(chain, ro_api, chain_apis::read_only, call_name, http_response_code, params_type)
+#define CHAIN_RO_CALL_LOCKED_STREAM(call_name, http_response_code, params_type) CALL_LOCKED_STREAM_WITH_400(chain, ro_api, chain_apis::read_only, call_name, http_response_code, params_type)
 #define CHAIN_RW_CALL(call_name, http_response_code, params_type) CALL_WITH_400(chain, rw_api, chain_apis::read_write, call_name, http_response_code, params_type)
 #define CHAIN_RO_CALL_ASYNC(call_name, call_result, http_response_code, params_type) CALL_ASYNC_WITH_400(chain, ro_api, chain_apis::read_only, call_name, call_result, http_response_code, params_type)
 #define CHAIN_RW_CALL_ASYNC(call_name, call_result, http_response_code, params_type) CALL_ASYNC_WITH_400(chain, rw_api, chain_apis::read_write, call_name, call_result, http_response_code, params_type)
@@ -94,30 +188,27 @@ parse_params<chain_apis::read_only::get_transaction_status_params, http_params_t
 
 void chain_api_plugin::plugin_startup() {
    ilog( "starting chain_api_plugin" );
-   my.reset(new chain_api_plugin_impl(app().get_plugin<chain_plugin>().chain()));
    auto& chain = app().get_plugin<chain_plugin>();
    auto ro_api = chain.get_read_only_api();
    auto rw_api = chain.get_read_write_api();
 
    auto& _http_plugin = app().get_plugin<http_plugin>();
    ro_api.set_shorten_abi_errors( !_http_plugin.verbose_errors() );
+   auto& state_mutex = chain.chain().get_state_mutex();
+   my->read_thread_pool.emplace( "chapi", my->read_threads );
+   auto& read_threads = my->read_thread_pool->get_executor();
+   const auto max_response_time = _http_plugin.get_max_response_time();
 
    _http_plugin.add_api( {
       CHAIN_RO_CALL(get_info, 200, http_params_types::no_params)}, appbase::priority::medium_high);
    _http_plugin.add_api({
       CHAIN_RO_CALL(get_activated_protocol_features, 200, http_params_types::possible_no_params),
-      CHAIN_RO_CALL(get_block, 200, http_params_types::params_required),
-      CHAIN_RO_CALL(get_block_info, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_block_header_state, 200, http_params_types::params_required),
-      CHAIN_RO_CALL(get_account, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_code, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_code_hash, 200, http_params_types::params_required),
-      CHAIN_RO_CALL(get_abi, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_raw_code_and_abi, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_raw_abi, 200, http_params_types::params_required),
-      CHAIN_RO_CALL(get_table_rows, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_table_by_scope, 200, http_params_types::params_required),
-      CHAIN_RO_CALL(get_currency_balance, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_currency_stats, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_producers, 200, http_params_types::params_required),
       CHAIN_RO_CALL(get_producer_schedule, 200, http_params_types::no_params),
@@ -135,6 +226,27 @@ void chain_api_plugin::plugin_startup() {
       CHAIN_RO_CALL(get_consensus_parameters, 200, http_params_types::no_params)
    });
 
+   // read only calls that do not need the main thread, they run on the read thread pool alongside block application
+   _http_plugin.add_async_api({
+      CHAIN_RO_CALL_LOCKED_BLOCK(get_block, 200, http_params_types::params_required),
+      CHAIN_RO_CALL_LOCKED_BLOCK(get_block_info, 200, http_params_types::params_required),
+      CHAIN_RO_CALL_LOCKED(get_account, 200, http_params_types::params_required),
+      CHAIN_RO_CALL_LOCKED(get_accounts, 200, http_params_types::params_required),
+      CHAIN_RO_CALL_LOCKED(get_abi, 200, http_params_types::params_required),
+      CHAIN_RO_CALL_LOCKED_STREAM(get_table_rows, 200, http_params_types::params_required),
+      CHAIN_RO_CALL_LOCKED_STREAM(get_table_rows_batch, 200, http_params_types::params_required),
+      CHAIN_RO_CALL_LOCKED(get_currency_balance, 200, http_params_types::params_required)
+   });
+
+   for( const char* url : { "/v1/chain/get_block", "/v1/chain/get_block_info" } ) {
+      _http_plugin.add_cached_url( url );
+   }
+
+   for( const char* url : { "/v1/chain/push_transaction", "/v1/chain/push_transactions",
+                            "/v1/chain/send_transaction", "/v1/chain/send_transaction2" } ) {
+      _http_plugin.add_rate_limited_url( url );
+   }
+
    if (chain.account_queries_enabled()) {
       _http_plugin.add_async_api({
          CHAIN_RO_CALL_WITH_400(get_accounts_by_authorizers, 200, http_params_types::params_required),
@@ -148,6 +260,11 @@ void chain_api_plugin::plugin_startup() {
    }
 }
 
-void chain_api_plugin::plugin_shutdown() {}
+void chain_api_plugin::plugin_shutdown() {
+   // before the http thread pool the responses are posted to is stopped
+   if( my && my->read_thread_pool ) {
+      my->read_thread_pool->stop();
+   }
+}
 
 }
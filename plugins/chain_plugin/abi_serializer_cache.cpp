@@ -0,0 +1,55 @@
+#include <eosio/chain_plugin/abi_serializer_cache.hpp>
+#include <eosio/chain/account_object.hpp>
+
+#include <string_view>
+
+namespace eosio::chain_apis {
+
+using namespace eosio::chain;
+
+abi_serializer_cache::abi_serializer_cache( size_t max_entries )
+: _entries( max_entries )
+{
+}
+
+abi_serializer_cache::cached_abi_ptr
+abi_serializer_cache::get( const chainbase::database& db, account_name account, const abi_serializer::yield_function_t& yield ) {
+   const auto* accnt = db.find<account_object, by_name>( account );
+   if( accnt == nullptr )
+      return {};
+   const auto& metadata = db.get<account_metadata_object, by_name>( account );
+   const auto& packed_abi = accnt->abi;
+   const size_t abi_hash = std::hash<std::string_view>()( std::string_view( packed_abi.data(), packed_abi.size() ) );
+
+   if( auto cached = _entries.get( account ) ) {
+      if( (*cached)->abi_sequence == metadata.abi_sequence && (*cached)->abi_hash == abi_hash )
+         return (*cached)->abi;
+   }
+
+   // build without holding the lock, it can take milliseconds for a large ABI
+   abi_def abi;
+   if( !abi_serializer::to_abi( packed_abi, abi ) )
+      return {};
+   auto result = std::make_shared<const cached_abi>( std::move(abi), yield );
+
+   _entries.put( account, std::make_shared<const entry>( entry{ metadata.abi_sequence, abi_hash, result } ), 1 );
+   return result;
+}
+
+std::shared_ptr<const abi_serializer>
+abi_serializer_cache::get_serializer( const chainbase::database& db, account_name account, const abi_serializer::yield_function_t& yield ) {
+   auto abi = get( db, account, yield );
+   if( !abi )
+      return {};
+   return std::shared_ptr<const abi_serializer>( abi, &abi->serializer );
+}
+
+size_t abi_serializer_cache::size()const {
+   return _entries.get_stats().entries;
+}
+
+void abi_serializer_cache::clear() {
+   _entries.clear();
+}
+
+} // namespace eosio::chain_apis
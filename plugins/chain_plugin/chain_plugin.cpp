@@ -17,6 +17,7 @@
 #include <eosio/chain/permission_link_object.hpp>
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/eosio_contract.hpp>
+#include <eosio/chain/recovered_key_cache.hpp>
 
 #include <eosio/resource_monitor_plugin/resource_monitor_plugin.hpp>
 
@@ -152,6 +153,7 @@ public:
    flat_map<uint32_t,block_id_type> loaded_checkpoints;
    bool                             accept_transactions = false;
    bool                             api_accept_transactions = true;
+   uint32_t                         api_max_batch_size = chain_apis::read_only::default_max_batch_size;
    bool                             account_queries_enabled = false;
 
    std::optional<controller::config> chain_config;
@@ -193,6 +195,8 @@ public:
 
 
    std::optional<chain_apis::account_query_db>                        _account_query_db;
+   std::shared_ptr<chain_apis::abi_serializer_cache>                  _abi_serializer_cache = std::make_shared<chain_apis::abi_serializer_cache>();
+   std::shared_ptr<chain_apis::get_block_cache>                       _get_block_cache = std::make_shared<chain_apis::get_block_cache>();
    const producer_plugin* producer_plug;
    std::optional<chain_apis::trx_retry_db>                            _trx_retry_db;
    chain_apis::trx_finality_status_processing_ptr                     _trx_finality_status_processing;
@@ -254,12 +258,17 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
           "The name of an account whose code will be profiled")
          ("abi-serializer-max-time-ms", bpo::value<uint32_t>()->default_value(config::default_abi_serializer_max_time_us / 1000),
           "Override default maximum ABI serialization time allowed in ms")
+         ("get-block-cache-size", bpo::value<uint32_t>()->default_value(chain_apis::get_block_cache::default_max_entries),
+          "Number of irreversible blocks kept decoded for get_block. A block is decoded again once the ABI of one of its contracts changes. 0 disables the cache.")
          ("chain-state-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_size / (1024  * 1024)), "Maximum size (in MiB) of the chain state database")
          ("chain-state-db-guard-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_guard_size / (1024  * 1024)), "Safely shut down node when free space remaining in the chain state database drops below this size (in MiB).")
          ("signature-cpu-billable-pct", bpo::value<uint32_t>()->default_value(config::default_sig_cpu_bill_pct / config::percent_1),
           "Percentage of actual signature recovery cpu to bill. Whole number percentages, e.g. 50 for 50%")
          ("chain-threads", bpo::value<uint16_t>()->default_value(config::default_controller_thread_pool_size),
           "Number of worker threads in controller thread pool")
+         ("recovered-key-cache-size", bpo::value<uint32_t>()->default_value(recovered_key_cache::default_capacity),
+          "Number of public keys recovered from signatures to keep, so that signatures seen again, such as those of a transaction "
+          "arriving in a block or verified by contracts, are not recovered again. 0 disables the cache")
          ("contracts-console", bpo::bool_switch()->default_value(false),
           "print contract's output to console")
          ("deep-mind", bpo::bool_switch()->default_value(false),
@@ -286,6 +295,8 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
           "In \"irreversible\" mode: database contains state changes by only transactions in the blockchain up to the last irreversible block; transactions received via the P2P network are not relayed and transactions cannot be pushed via the chain API.\n"
           )
          ( "api-accept-transactions", bpo::value<bool>()->default_value(true), "Allow API transactions to be evaluated and relayed if valid.")
+         ( "api-max-batch-size", bpo::value<uint32_t>()->default_value(chain_apis::read_only::default_max_batch_size),
+          "Maximum number of queries of a batch API call such as get_accounts or get_table_rows_batch.")
          ("validation-mode", boost::program_options::value<eosio::chain::validation_mode>()->default_value(eosio::chain::validation_mode::FULL),
           "Chain validation mode (\"full\" or \"light\").\n"
           "In \"full\" mode all incoming blocks will be fully validated.\n"
@@ -317,6 +328,22 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
                }
          }), "Number of threads to use for EOS VM OC tier-up")
          ("eos-vm-oc-enable", bpo::bool_switch(), "Enable EOS VM OC tier-up runtime")
+         ("eos-vm-oc-warmup-contracts", bpo::value<uint32_t>()->default_value(eosvmoc::config().warmup_contracts),
+          "Number of most recently used contracts to compile with EOS VM OC at startup, before any block is applied. "
+          "Contracts already in the code cache are not recompiled. 0 disables warmup")
+         ("eos-vm-oc-tierup-executions", bpo::value<uint32_t>()->default_value(eosvmoc::config().tierup_executions),
+          "Number of executions on the base WASM runtime after which a contract is compiled with EOS VM OC. "
+          "Counts decay over time so rarely used contracts are never compiled. 0 to not require a number of executions")
+         ("eos-vm-oc-tierup-cpu-us", bpo::value<uint64_t>()->default_value(eosvmoc::config().tierup_cpu_us),
+          "Cumulative CPU time (in microseconds) on the base WASM runtime after which a contract is compiled with EOS VM OC. "
+          "When both this and eos-vm-oc-tierup-executions are 0 every contract is compiled on first use")
+         ("eos-vm-oc-export-dir", bpo::value<bfs::path>(),
+          "Directory EOS VM OC compiled code is written to, one content addressed file per contract. May be shared by several nodes. "
+          "If a relative path is specified, it is relative to the data directory")
+         ("eos-vm-oc-import-dir", bpo::value<bfs::path>(),
+          "Directory of EOS VM OC compiled code, as written by eos-vm-oc-export-dir, loaded in to the code cache at startup. "
+          "Also allows a code cache left dirty by a crash to be rebuilt. Compiled code is executed natively, only import from trusted sources. "
+          "If a relative path is specified, it is relative to the data directory")
 #endif
          ("enable-account-queries", bpo::value<bool>()->default_value(false), "enable queries to find accounts by various metadata.")
          ("max-nonprivileged-inline-action-size", bpo::value<uint32_t>()->default_value(config::default_max_nonprivileged_inline_action_size), "maximum allowed size (in bytes) of an inline action for a nonprivileged account")
@@ -767,6 +794,8 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
       if(options.count("abi-serializer-max-time-ms"))
          my->abi_serializer_max_time_us = fc::microseconds(options.at("abi-serializer-max-time-ms").as<uint32_t>() * 1000);
 
+      my->_get_block_cache->set_max_entries( options.at( "get-block-cache-size" ).as<uint32_t>() );
+
       my->chain_config->blocks_dir = my->blocks_dir;
       my->chain_config->state_dir = app().data_dir() / config::default_state_dir_name;
       my->chain_config->read_only = my->readonly;
@@ -801,6 +830,8 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
                      "chain-threads ${num} must be greater than 0", ("num", my->chain_config->thread_pool_size) );
       }
 
+      recovered_key_cache::instance().set_capacity( options.at( "recovered-key-cache-size" ).as<uint32_t>() );
+
       my->chain_config->sig_cpu_bill_pct = options.at("signature-cpu-billable-pct").as<uint32_t>();
       EOS_ASSERT( my->chain_config->sig_cpu_bill_pct >= 0 && my->chain_config->sig_cpu_bill_pct <= 100, plugin_config_exception,
                   "signature-cpu-billable-pct must be 0 - 100, ${pct}", ("pct", my->chain_config->sig_cpu_bill_pct) );
@@ -1059,6 +1090,7 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
          my->chain_config->read_mode = options.at("read-mode").as<db_read_mode>();
       }
       my->api_accept_transactions = options.at( "api-accept-transactions" ).as<bool>();
+      my->api_max_batch_size = options.at( "api-max-batch-size" ).as<uint32_t>();
 
       if( my->chain_config->read_mode == db_read_mode::IRREVERSIBLE || my->chain_config->read_mode == db_read_mode::READ_ONLY ) {
          if( my->chain_config->read_mode == db_read_mode::READ_ONLY ) {
@@ -1087,6 +1119,20 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
          my->chain_config->eosvmoc_config.threads = options.at("eos-vm-oc-compile-threads").as<uint64_t>();
       if( options["eos-vm-oc-enable"].as<bool>() )
          my->chain_config->eosvmoc_tierup = true;
+      if( options.count("eos-vm-oc-warmup-contracts") )
+         my->chain_config->eosvmoc_config.warmup_contracts = options.at("eos-vm-oc-warmup-contracts").as<uint32_t>();
+      if( options.count("eos-vm-oc-tierup-executions") )
+         my->chain_config->eosvmoc_config.tierup_executions = options.at("eos-vm-oc-tierup-executions").as<uint32_t>();
+      if( options.count("eos-vm-oc-tierup-cpu-us") )
+         my->chain_config->eosvmoc_config.tierup_cpu_us = options.at("eos-vm-oc-tierup-cpu-us").as<uint64_t>();
+      if( options.count( "eos-vm-oc-export-dir" )) {
+         auto d = options.at( "eos-vm-oc-export-dir" ).as<bfs::path>();
+         my->chain_config->eosvmoc_config.export_dir = d.is_relative() ? app().data_dir() / d : d;
+      }
+      if( options.count( "eos-vm-oc-import-dir" )) {
+         auto d = options.at( "eos-vm-oc-import-dir" ).as<bfs::path>();
+         my->chain_config->eosvmoc_config.import_dir = d.is_relative() ? app().data_dir() / d : d;
+      }
 #endif
 
       my->account_queries_enabled = options.at("enable-account-queries").as<bool>();
@@ -1321,11 +1367,13 @@ void chain_plugin::handle_sighup() {
    _deep_mind_log.update_logger( deep_mind_logger_name );
 }
 
-chain_apis::read_write::read_write(controller& db, std::optional<trx_retry_db>& trx_retry, const fc::microseconds& abi_serializer_max_time, bool api_accept_transactions)
+chain_apis::read_write::read_write(controller& db, std::optional<trx_retry_db>& trx_retry, const fc::microseconds& abi_serializer_max_time, bool api_accept_transactions,
+                                   std::shared_ptr<abi_serializer_cache> abi_cache)
 : db(db)
 , trx_retry(trx_retry)
 , abi_serializer_max_time(abi_serializer_max_time)
 , api_accept_transactions(api_accept_transactions)
+, abi_cache(abi_cache ? std::move(abi_cache) : std::make_shared<abi_serializer_cache>())
 {
 }
 
@@ -1335,11 +1383,14 @@ void chain_apis::read_write::validate() const {
 }
 
 chain_apis::read_write chain_plugin::get_read_write_api() {
-   return chain_apis::read_write(chain(), my->_trx_retry_db, get_abi_serializer_max_time(), api_accept_transactions());
+   return chain_apis::read_write(chain(), my->_trx_retry_db, get_abi_serializer_max_time(), api_accept_transactions(), my->_abi_serializer_cache);
 }
 
 chain_apis::read_only chain_plugin::get_read_only_api() const {
-   return chain_apis::read_only(chain(), my->_account_query_db, get_abi_serializer_max_time(), my->producer_plug, my->_trx_finality_status_processing.get());
+   chain_apis::read_only ro_api(chain(), my->_account_query_db, get_abi_serializer_max_time(), my->producer_plug, my->_trx_finality_status_processing.get(),
+                                my->_abi_serializer_cache, my->_get_block_cache);
+   ro_api.set_max_batch_size(my->api_max_batch_size);
+   return ro_api;
 }
 
 
@@ -1677,15 +1728,6 @@ string convert_to_string(const float128_t& source, const string& key_type, const
    } FC_RETHROW_EXCEPTIONS(warn, "Could not convert ${desc} from '${source}' to string.", ("desc", desc)("source",source) )
 }
 
-abi_def get_abi( const controller& db, const name& account ) {
-   const auto &d = db.db();
-   const account_object *code_accnt = d.find<account_object, by_name>(account);
-   EOS_ASSERT(code_accnt != nullptr, chain::account_query_exception, "Fail to retrieve account for ${account}", ("account", account) );
-   abi_def abi;
-   abi_serializer::to_abi(code_accnt->abi, abi);
-   return abi;
-}
-
 string get_table_type( const abi_def& abi, const name& table_name ) {
    for( const auto& t : abi.tables ) {
       if( t.name == table_name ){
@@ -1695,8 +1737,226 @@ string get_table_type( const abi_def& abi, const name& table_name ) {
    EOS_ASSERT( false, chain::contract_table_query_exception, "Table ${table} is not specified in the ABI", ("table",table_name) );
 }
 
+abi_serializer_cache::cached_abi_ptr read_only::get_cached_abi( const name& account )const {
+   auto yield = abi_serializer::create_yield_function( abi_serializer_max_time );
+   auto abi = abi_cache->get( db.db(), account, yield );
+   if( !abi ) {
+      EOS_ASSERT( db.db().find<account_object, by_name>(account) != nullptr, chain::account_query_exception,
+                  "Fail to retrieve account for ${account}", ("account", account) );
+      abi = std::make_shared<const abi_serializer_cache::cached_abi>( abi_def(), yield );
+   }
+   return abi;
+}
+
+/// row of a keys_only query
+static fc::variant table_row_keys( const read_only::get_table_rows_params& p, const read_only::get_table_rows_raw_result::row& row ) {
+   fc::mutable_variant_object keys( "primary_key", std::to_string( row.primary_key ) );
+   if( !row.secondary_key.empty() )
+      keys( "secondary_key", row.secondary_key );
+   if( p.show_payer && *p.show_payer )
+      keys( "payer", row.payer );
+   return fc::variant( std::move(keys) );
+}
+
+/// appends the JSON of a row of get_table_rows
+static void append_table_row_json( string& out, const read_only::get_table_rows_params& p, const vector<string>& fields,
+                                   const abi_serializer& abis, const read_only::get_table_rows_raw_result::row& row,
+                                   const fc::microseconds& max_serialization_time, bool shorten_abi_errors ) {
+   if( p.keys_only && *p.keys_only ) {
+      out += fc::json::to_string( table_row_keys( p, row ), fc::time_point::maximum() );
+      return;
+   }
+   const bool show_payer = p.show_payer && *p.show_payer;
+   if( show_payer )
+      out += "{\"data\":";
+   if( p.json ) {
+      fc::datastream<const char*> ds( row.data.data(), row.data.size() );
+      if( fields.empty() )
+         abis.binary_to_json( abis.get_table_type(p.table), ds, out, abi_serializer::create_yield_function( max_serialization_time ), shorten_abi_errors );
+      else
+         abis.binary_to_json( abis.get_table_type(p.table), ds, out, fields, abi_serializer::create_yield_function( max_serialization_time ), shorten_abi_errors );
+   } else {
+      out += fc::json::to_string( fc::variant( row.data ), fc::time_point::maximum() );
+   }
+   if( show_payer ) {
+      out += ",\"payer\":\"";
+      out += row.payer.to_string();
+      out += "\"}";
+   }
+}
+
 read_only::get_table_rows_result read_only::get_table_rows( const read_only::get_table_rows_params& p )const {
-   const abi_def abi = eosio::chain_apis::get_abi( db, p.code );
+   auto cached_abi = get_cached_abi( p.code );
+   auto raw = get_table_rows_impl( p, cached_abi, walk_deadline() );
+   const abi_serializer& abis = cached_abi->serializer;
+
+   get_table_rows_result result;
+   result.more = raw.more;
+   result.next_key = std::move( raw.next_key );
+   result.rows.reserve( raw.rows.size() );
+   string json;
+   for( const auto& row : raw.rows ) {
+      if( p.keys_only && *p.keys_only ) {
+         result.rows.emplace_back( table_row_keys( p, row ) );
+         continue;
+      }
+      fc::variant data_var;
+      if( p.json && raw.fields.empty() ) {
+         data_var = abis.binary_to_variant( abis.get_table_type(p.table), row.data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
+      } else if( p.json ) {
+         json.clear();
+         fc::datastream<const char*> ds( row.data.data(), row.data.size() );
+         abis.binary_to_json( abis.get_table_type(p.table), ds, json, raw.fields, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
+         data_var = fc::json::from_string( json );
+      } else {
+         data_var = fc::variant( row.data );
+      }
+
+      if( p.show_payer && *p.show_payer ) {
+         result.rows.emplace_back( fc::mutable_variant_object("data", std::move(data_var))("payer", row.payer) );
+      } else {
+         result.rows.emplace_back( std::move(data_var) );
+      }
+   }
+   return result;
+}
+
+string read_only::get_table_rows_json( const read_only::get_table_rows_params& p )const {
+   auto stream = get_table_rows_stream( p );
+   string json;
+   while( stream.next( json ) ) {}
+   return json;
+}
+
+read_only::json_stream read_only::get_table_rows_stream( const read_only::get_table_rows_params& p )const {
+   return get_table_rows_stream( p, get_cached_abi( p.code ), walk_deadline() );
+}
+
+read_only::json_stream read_only::get_table_rows_stream( const read_only::get_table_rows_params& p,
+                                                         abi_serializer_cache::cached_abi_ptr cached_abi,
+                                                         const fc::time_point& deadline )const {
+   auto result = get_table_rows_impl( p, cached_abi, deadline );
+   size_t held_bytes = sizeof(result) + result.next_key.size();
+   for( const auto& row : result.rows )
+      held_bytes += sizeof(row) + row.data.size() + row.secondary_key.size();
+
+   auto next = [p, cached_abi=std::move(cached_abi), result=std::move(result), next_row=size_t(0), started=false,
+           max_time=abi_serializer_max_time, shorten_abi_errors=shorten_abi_errors]( string& out ) mutable {
+      const size_t start = out.size();
+      if( !started ) {
+         out += "{\"rows\":[";
+         started = true;
+      }
+      for( ; next_row < result.rows.size() && out.size() - start < table_rows_piece_size; ++next_row ) {
+         if( next_row > 0 )
+            out += ',';
+         auto& row = result.rows[next_row];
+         append_table_row_json( out, p, result.fields, cached_abi->serializer, row, max_time, shorten_abi_errors );
+         vector<char>().swap( row.data ); // written, release it
+      }
+      if( next_row < result.rows.size() )
+         return true;
+
+      out += "],\"more\":";
+      out += result.more ? "true" : "false";
+      out += ",\"next_key\":";
+      out += fc::json::to_string( fc::variant( result.next_key ), fc::time_point::maximum() );
+      out += '}';
+      return false;
+   };
+   return { std::move(next), held_bytes };
+}
+
+string read_only::get_table_rows_batch_json( const read_only::get_table_rows_batch_params& p )const {
+   auto stream = get_table_rows_batch_stream( p );
+   string json;
+   while( stream.next( json ) ) {}
+   return json;
+}
+
+read_only::json_stream read_only::get_table_rows_batch_stream( const read_only::get_table_rows_batch_params& p )const {
+   EOS_ASSERT( p.queries.size() <= max_batch_size, chain::invalid_http_request,
+               "At most ${max} queries per batch, got ${n}", ("max", max_batch_size)("n", p.queries.size()) );
+
+   const auto deadline = walk_deadline();
+   std::map<name, abi_serializer_cache::cached_abi_ptr> cached_abis;
+   vector<std::function<bool(string&)>> queries;
+   size_t held_bytes = 0;
+   queries.reserve( p.queries.size() );
+   for( const auto& q : p.queries ) {
+      auto& cached_abi = cached_abis[q.code];
+      if( !cached_abi )
+         cached_abi = get_cached_abi( q.code );
+      auto stream = get_table_rows_stream( q, cached_abi, deadline );
+      queries.push_back( std::move(stream.next) );
+      held_bytes += stream.held_bytes;
+   }
+
+   auto next = [queries=std::move(queries), next_query=size_t(0), started=false, query_started=false]( string& out ) mutable {
+      const size_t start = out.size();
+      if( !started ) {
+         out += "{\"results\":[";
+         started = true;
+      }
+      while( next_query < queries.size() && out.size() - start < table_rows_piece_size ) {
+         if( !query_started ) {
+            if( next_query > 0 )
+               out += ',';
+            query_started = true;
+         }
+         if( !queries[next_query]( out ) ) {
+            queries[next_query] = nullptr; // written, release its rows
+            ++next_query;
+            query_started = false;
+         }
+      }
+      if( next_query < queries.size() )
+         return true;
+
+      out += "]}";
+      return false;
+   };
+   return { std::move(next), held_bytes };
+}
+
+/// @return fields of p, each checked to be a field of the table struct or one of its bases, without duplicates
+static vector<string> selected_table_fields( const read_only::get_table_rows_params& p, const abi_def& abi, const abi_serializer& abis ) {
+   vector<string> result;
+   if( p.fields.empty() )
+      return result;
+   get_table_type( abi, p.table ); // throws for a table not in the ABI
+   const auto table_type = abis.get_table_type( p.table );
+   result.reserve( p.fields.size() );
+   for( const auto& f : p.fields ) {
+      if( std::find( result.begin(), result.end(), f ) != result.end() )
+         continue;
+      bool found = false;
+      for( const struct_def* st = &abis.get_struct( table_type ); ; st = &abis.get_struct( st->base ) ) {
+         found = std::any_of( st->fields.begin(), st->fields.end(), [&]( const field_def& fd ) { return fd.name == f; } );
+         if( found || st->base.empty() )
+            break;
+      }
+      EOS_ASSERT( found, chain::contract_table_query_exception, "Unknown field ${f} of table ${t}", ("f", f)("t", p.table) );
+      result.push_back( f );
+   }
+   return result;
+}
+
+read_only::get_table_rows_raw_result read_only::get_table_rows_impl( const read_only::get_table_rows_params& p,
+                                                                     const abi_serializer_cache::cached_abi_ptr& cached_abi,
+                                                                     const fc::time_point& deadline )const {
+   const bool keys_only = p.keys_only && *p.keys_only;
+   EOS_ASSERT( !keys_only || p.fields.empty(), chain::contract_table_query_exception, "fields cannot be selected with keys_only" );
+   EOS_ASSERT( p.json || p.fields.empty(), chain::contract_table_query_exception, "fields can only be selected with json" );
+   auto fields = selected_table_fields( p, cached_abi->abi, cached_abi->serializer );
+   auto result = get_table_rows_of_index( p, cached_abi->abi, deadline );
+   result.fields = std::move( fields );
+   return result;
+}
+
+read_only::get_table_rows_raw_result read_only::get_table_rows_of_index( const read_only::get_table_rows_params& p,
+                                                                         const abi_def& abi,
+                                                                         const fc::time_point& deadline )const {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wstrict-aliasing"
    bool primary = false;
@@ -1705,43 +1965,43 @@ read_only::get_table_rows_result read_only::get_table_rows( const read_only::get
       EOS_ASSERT( p.table == table_with_index, chain::contract_table_query_exception, "Invalid table name ${t}", ( "t", p.table ));
       auto table_type = get_table_type( abi, p.table );
       if( table_type == KEYi64 || p.key_type == "i64" || p.key_type == "name" ) {
-         return get_table_rows_ex<key_value_index>(p,abi);
+         return get_table_rows_ex<key_value_index>(p, deadline);
       }
       EOS_ASSERT( false, chain::contract_table_query_exception,  "Invalid table type ${type}", ("type",table_type)("abi",abi));
    } else {
       EOS_ASSERT( !p.key_type.empty(), chain::contract_table_query_exception, "key type required for non-primary index" );
 
       if (p.key_type == chain_apis::i64 || p.key_type == "name") {
-         return get_table_rows_by_seckey<index64_index, uint64_t>(p, abi, [](uint64_t v)->uint64_t {
+         return get_table_rows_by_seckey<index64_index, uint64_t>(p, deadline, [](uint64_t v)->uint64_t {
             return v;
          });
       }
       else if (p.key_type == chain_apis::i128) {
-         return get_table_rows_by_seckey<index128_index, uint128_t>(p, abi, [](uint128_t v)->uint128_t {
+         return get_table_rows_by_seckey<index128_index, uint128_t>(p, deadline, [](uint128_t v)->uint128_t {
             return v;
          });
       }
       else if (p.key_type == chain_apis::i256) {
          if ( p.encode_type == chain_apis::hex) {
             using  conv = keytype_converter<chain_apis::sha256,chain_apis::hex>;
-            return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, abi, conv::function());
+            return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, deadline, conv::function());
          }
          using  conv = keytype_converter<chain_apis::i256>;
-         return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, abi, conv::function());
+         return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, deadline, conv::function());
       }
       else if (p.key_type == chain_apis::float64) {
-         return get_table_rows_by_seckey<index_double_index, double>(p, abi, [](double v)->float64_t {
+         return get_table_rows_by_seckey<index_double_index, double>(p, deadline, [](double v)->float64_t {
             float64_t f = *(float64_t *)&v;
             return f;
          });
       }
       else if (p.key_type == chain_apis::float128) {
          if ( p.encode_type == chain_apis::hex) {
-            return get_table_rows_by_seckey<index_long_double_index, uint128_t>(p, abi, [](uint128_t v)->float128_t{
+            return get_table_rows_by_seckey<index_long_double_index, uint128_t>(p, deadline, [](uint128_t v)->float128_t{
                return *reinterpret_cast<float128_t *>(&v);
             });
          }
-         return get_table_rows_by_seckey<index_long_double_index, double>(p, abi, [](double v)->float128_t{
+         return get_table_rows_by_seckey<index_long_double_index, double>(p, deadline, [](double v)->float128_t{
             float64_t f = *(float64_t *)&v;
             float128_t f128;
             f64_to_f128M(f, &f128);
@@ -1750,11 +2010,11 @@ read_only::get_table_rows_result read_only::get_table_rows( const read_only::get
       }
       else if (p.key_type == chain_apis::sha256) {
          using  conv = keytype_converter<chain_apis::sha256,chain_apis::hex>;
-         return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, abi, conv::function());
+         return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, deadline, conv::function());
       }
       else if(p.key_type == chain_apis::ripemd160) {
          using  conv = keytype_converter<chain_apis::ripemd160,chain_apis::hex>;
-         return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, abi, conv::function());
+         return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, deadline, conv::function());
       }
       EOS_ASSERT(false, chain::contract_table_query_exception,  "Unsupported secondary index type: ${t}", ("t", p.key_type));
    }
@@ -1811,8 +2071,7 @@ read_only::get_table_by_scope_result read_only::get_table_by_scope( const read_o
 
 vector<asset> read_only::get_currency_balance( const read_only::get_currency_balance_params& p )const {
 
-   const abi_def abi = eosio::chain_apis::get_abi( db, p.code );
-   (void)get_table_type( abi, name("accounts") );
+   (void)get_table_type( get_cached_abi( p.code )->abi, name("accounts") );
 
    vector<asset> results;
    walk_key_value_table(p.code, p.account, "accounts"_n, [&](const key_value_object& obj){
@@ -1838,8 +2097,7 @@ vector<asset> read_only::get_currency_balance( const read_only::get_currency_bal
 fc::variant read_only::get_currency_stats( const read_only::get_currency_stats_params& p )const {
    fc::mutable_variant_object results;
 
-   const abi_def abi = eosio::chain_apis::get_abi( db, p.code );
-   (void)get_table_type( abi, name("stat") );
+   (void)get_table_type( get_cached_abi( p.code )->abi, name("stat") );
 
    uint64_t scope = ( eosio::chain::string_to_symbol( 0, boost::algorithm::to_upper_copy(p.symbol).c_str() ) >> 8 );
 
@@ -1877,9 +2135,10 @@ fc::variant get_global_row( const database& db, const abi_def& abi, const abi_se
 }
 
 read_only::get_producers_result read_only::get_producers( const read_only::get_producers_params& p ) const try {
-   const abi_def abi = eosio::chain_apis::get_abi(db, config::system_account_name);
+   const auto cached_abi = get_cached_abi( config::system_account_name );
+   const abi_def& abi = cached_abi->abi;
    const auto table_type = get_table_type(abi, "producers"_n);
-   const abi_serializer abis{ abi, abi_serializer::create_yield_function( abi_serializer_max_time ) };
+   const abi_serializer& abis = cached_abi->serializer;
    EOS_ASSERT(table_type == KEYi64, chain::contract_table_query_exception, "Invalid table type ${type} for table producers", ("type",table_type));
 
    const auto& d = db.db();
@@ -1962,22 +2221,15 @@ read_only::get_producer_schedule_result read_only::get_producer_schedule( const
 
 
 struct resolver_factory {
-    static auto make(const controller& control, abi_serializer::yield_function_t yield) {
-        return [&control, yield{std::move(yield)}](const account_name &name) -> std::optional<abi_serializer> {
-            const auto* accnt = control.db().template find<account_object, by_name>(name);
-            if (accnt != nullptr) {
-                abi_def abi;
-                if (abi_serializer::to_abi(accnt->abi, abi)) {
-                    return abi_serializer(abi, yield);
-                }
-            }
-            return std::optional<abi_serializer>();
+    static auto make(const controller& control, std::shared_ptr<abi_serializer_cache> cache, abi_serializer::yield_function_t yield) {
+        return [&control, cache{std::move(cache)}, yield{std::move(yield)}](const account_name &name) -> std::shared_ptr<const abi_serializer> {
+            return cache->get_serializer(control.db(), name, yield);
         };
     }
 };
 
-auto make_resolver(const controller& control, abi_serializer::yield_function_t yield) {
-    return resolver_factory::make(control, std::move( yield ));
+auto make_resolver(const controller& control, std::shared_ptr<abi_serializer_cache> cache, abi_serializer::yield_function_t yield) {
+    return resolver_factory::make(control, std::move( cache ), std::move( yield ));
 }
 
 read_only::get_scheduled_transactions_result
@@ -2012,7 +2264,7 @@ read_only::get_scheduled_transactions( const read_only::get_scheduled_transactio
 
    read_only::get_scheduled_transactions_result result;
 
-   auto resolver = make_resolver(db, abi_serializer::create_yield_function( abi_serializer_max_time ));
+   auto resolver = make_resolver(db, abi_cache, abi_serializer::create_yield_function( abi_serializer_max_time ));
 
    uint32_t remaining = p.limit;
    auto time_limit = fc::time_point::now() + fc::microseconds(1000 * 10); /// 10ms max time
@@ -2056,6 +2308,7 @@ read_only::get_scheduled_transactions( const read_only::get_scheduled_transactio
 fc::variant read_only::get_block(const read_only::get_block_params& params) const {
    signed_block_ptr block;
    std::optional<uint64_t> block_num;
+   std::optional<block_id_type> block_id;
 
    EOS_ASSERT( !params.block_num_or_id.empty() && params.block_num_or_id.size() <= 64,
                chain::block_id_type_exception,
@@ -2066,27 +2319,66 @@ fc::variant read_only::get_block(const read_only::get_block_params& params) cons
       block_num = fc::to_uint64(params.block_num_or_id);
    } catch( ... ) {}
 
-   if( block_num ) {
+   if( !block_num ) {
+      try {
+         block_id = fc::variant(params.block_num_or_id).as<block_id_type>();
+      } EOS_RETHROW_EXCEPTIONS(chain::block_id_type_exception, "Invalid block ID: ${block_num_or_id}", ("block_num_or_id", params.block_num_or_id))
+   }
+
+   // a block past the last irreversible block can still be replaced by a fork, it is not cached
+   const uint64_t num = block_num ? *block_num : block_header::num_from_id( *block_id );
+   const bool cacheable = num > 0 && num <= db.last_irreversible_block_num();
+
+   const auto yield = abi_serializer::create_yield_function( abi_serializer_max_time );
+   const auto get_abi = [&]( account_name account ) { return abi_cache->get( db.db(), account, yield ); };
+
+   get_block_cache::cached_block_ptr cached;
+   if( cacheable ) {
+      cached = block_cache->get( num );
+      if( cached && block_id && cached->id != *block_id )
+         cached.reset();
+   }
+   if( cached ) {
+      if( get_block_cache::is_current( *cached, get_abi ) )
+         return cached->result;
+      block = cached->block;
+   } else if( block_num ) {
       block = db.fetch_block_by_number( *block_num );
    } else {
       try {
-         block = db.fetch_block_by_id( fc::variant(params.block_num_or_id).as<block_id_type>() );
+         block = db.fetch_block_by_id( *block_id );
       } EOS_RETHROW_EXCEPTIONS(chain::block_id_type_exception, "Invalid block ID: ${block_num_or_id}", ("block_num_or_id", params.block_num_or_id))
    }
 
    EOS_ASSERT( block, unknown_block_exception, "Could not find block: ${block}", ("block", params.block_num_or_id));
 
+   // the ABIs used are recorded, the result stays valid for as long as they do not change
+   std::vector<std::pair<account_name, abi_serializer_cache::cached_abi_ptr>> abis;
+   auto resolver = [&]( const account_name& account ) -> std::shared_ptr<const abi_serializer> {
+      auto itr = std::find_if( abis.begin(), abis.end(), [&]( const auto& a ) { return a.first == account; } );
+      if( itr == abis.end() )
+         itr = abis.emplace( abis.end(), account, get_abi( account ) );
+      if( !itr->second )
+         return {};
+      return std::shared_ptr<const abi_serializer>( itr->second, &itr->second->serializer );
+   };
+
    fc::variant pretty_output;
-   abi_serializer::to_variant(*block, pretty_output, make_resolver(db, abi_serializer::create_yield_function( abi_serializer_max_time )),
-                              abi_serializer::create_yield_function( abi_serializer_max_time ));
+   abi_serializer::to_variant(*block, pretty_output, resolver, yield);
 
-   const auto block_id = block->calculate_id();
-   uint32_t ref_block_prefix = block_id._hash[1];
+   const auto id = block->calculate_id();
+   uint32_t ref_block_prefix = id._hash[1];
 
-   return fc::mutable_variant_object(pretty_output.get_object())
-           ("id", block_id)
+   fc::variant result = fc::mutable_variant_object(pretty_output.get_object())
+           ("id", id)
            ("block_num",block->block_num())
            ("ref_block_prefix", ref_block_prefix);
+
+   if( cacheable ) {
+      block_cache->put( num, std::make_shared<const get_block_cache::cached_block>(
+            get_block_cache::cached_block{ block, id, result, std::move( abis ) } ) );
+   }
+   return result;
 }
 
 fc::variant read_only::get_block_info(const read_only::get_block_info_params& params) const {
@@ -2118,6 +2410,14 @@ fc::variant read_only::get_block_info(const read_only::get_block_info_params& pa
          ("ref_block_prefix", ref_block_prefix);
 }
 
+bool read_only::is_immutable_block(const fc::variant& result) const {
+   const auto& obj = result.get_object();
+   if( obj["block_num"].as<uint32_t>() > db.last_irreversible_block_num() )
+      return false;
+   auto trxs = obj.find( "transactions" );
+   return trxs == obj.end() || trxs->value().get_array().empty();
+}
+
 fc::variant read_only::get_block_header_state(const get_block_header_state_params& params) const {
    block_state_ptr b;
    std::optional<uint64_t> block_num;
@@ -2155,7 +2455,7 @@ void read_write::push_block(read_write::push_block_params&& params, next_functio
 void read_write::push_transaction(const read_write::push_transaction_params& params, next_function<read_write::push_transaction_results> next) {
    try {
       auto pretty_input = std::make_shared<packed_transaction>();
-      auto resolver = make_resolver(db, abi_serializer::create_yield_function( abi_serializer_max_time ));
+      auto resolver = make_resolver(db, abi_cache, abi_serializer::create_yield_function( abi_serializer_max_time ));
       try {
          abi_serializer::from_variant(params, *pretty_input, std::move( resolver ), abi_serializer::create_yield_function( abi_serializer_max_time ));
       } EOS_RETHROW_EXCEPTIONS(chain::packed_transaction_type_exception, "Invalid packed transaction")
@@ -2274,7 +2574,7 @@ void read_write::send_transaction(const read_write::send_transaction_params& par
 
    try {
       auto pretty_input = std::make_shared<packed_transaction>();
-      auto resolver = make_resolver(db, abi_serializer::create_yield_function( abi_serializer_max_time ));
+      auto resolver = make_resolver(db, abi_cache, abi_serializer::create_yield_function( abi_serializer_max_time ));
       try {
          abi_serializer::from_variant(params, *pretty_input, resolver, abi_serializer::create_yield_function( abi_serializer_max_time ));
       } EOS_RETHROW_EXCEPTIONS(chain::packed_transaction_type_exception, "Invalid packed transaction")
@@ -2309,7 +2609,7 @@ void read_write::send_transaction(const read_write::send_transaction_params& par
 void read_write::send_transaction2(const read_write::send_transaction2_params& params, next_function<read_write::send_transaction_results> next) {
    try {
       auto ptrx = std::make_shared<packed_transaction>();
-      auto resolver = make_resolver(db, abi_serializer::create_yield_function( abi_serializer_max_time ));
+      auto resolver = make_resolver(db, abi_cache, abi_serializer::create_yield_function( abi_serializer_max_time ));
       try {
          abi_serializer::from_variant(params.transaction, *ptrx, resolver, abi_serializer::create_yield_function( abi_serializer_max_time ));
       } EOS_RETHROW_EXCEPTIONS(chain::packed_transaction_type_exception, "Invalid packed transaction")
@@ -2442,6 +2742,37 @@ read_only::get_raw_abi_results read_only::get_raw_abi( const get_raw_abi_params&
 }
 
 read_only::get_account_results read_only::get_account( const get_account_params& params )const {
+   const auto system_abi = abi_cache->get( db.db(), config::system_account_name, abi_serializer::create_yield_function( abi_serializer_max_time ) );
+   symbol core_symbol;
+   if( system_abi )
+      core_symbol = params.expected_core_symbol ? *params.expected_core_symbol : extract_core_symbol();
+   return get_account( params, system_abi, core_symbol );
+}
+
+read_only::get_accounts_results read_only::get_accounts( const get_accounts_params& params )const {
+   EOS_ASSERT( params.account_names.size() <= max_batch_size, chain::invalid_http_request,
+               "At most ${max} accounts per batch, got ${n}", ("max", max_batch_size)("n", params.account_names.size()) );
+
+   const auto system_abi = abi_cache->get( db.db(), config::system_account_name, abi_serializer::create_yield_function( abi_serializer_max_time ) );
+   symbol core_symbol;
+   if( system_abi )
+      core_symbol = params.expected_core_symbol ? *params.expected_core_symbol : extract_core_symbol();
+
+   const auto deadline = walk_deadline();
+   get_accounts_results result;
+   result.accounts.reserve( params.account_names.size() );
+   for( const auto& account_name : params.account_names ) {
+      if( !result.accounts.empty() && fc::time_point::now() > deadline ) {
+         result.more = account_name;
+         break;
+      }
+      result.accounts.push_back( get_account( get_account_params{ account_name, params.expected_core_symbol }, system_abi, core_symbol ) );
+   }
+   return result;
+}
+
+read_only::get_account_results read_only::get_account( const get_account_params& params, const abi_serializer_cache::cached_abi_ptr& system_abi,
+                                                       const symbol& core_symbol )const {
    get_account_results result;
    result.account_name = params.account_name;
 
@@ -2526,19 +2857,11 @@ read_only::get_account_results read_only::get_account( const get_account_params&
    // add eosio.any linked authorizations
    result.eosio_any_linked_actions = get_linked_actions(chain::config::eosio_any_name);
 
-   const auto& code_account = db.db().get<account_object,by_name>( config::system_account_name );
-
-   abi_def abi;
-   if( abi_serializer::to_abi(code_account.abi, abi) ) {
-      abi_serializer abis( abi, abi_serializer::create_yield_function( abi_serializer_max_time ) );
+   if( system_abi ) {
+      const abi_serializer& abis = system_abi->serializer;
 
       const auto token_code = "eosio.token"_n;
 
-      auto core_symbol = extract_core_symbol();
-
-      if (params.expected_core_symbol)
-         core_symbol = *(params.expected_core_symbol);
-
       const auto* t_id = d.find<chain::table_id_object, chain::by_code_scope_table>(boost::make_tuple( token_code, params.account_name, "accounts"_n ));
       if( t_id != nullptr ) {
          const auto &idx = d.get_index<key_value_index, by_scope_primary>();
@@ -2625,9 +2948,9 @@ read_only::abi_json_to_bin_result read_only::abi_json_to_bin( const read_only::a
    const auto code_account = db.db().find<account_object,by_name>( params.code );
    EOS_ASSERT(code_account != nullptr, contract_query_exception, "Contract can't be found ${contract}", ("contract", params.code));
 
-   abi_def abi;
-   if( abi_serializer::to_abi(code_account->abi, abi) ) {
-      abi_serializer abis( abi, abi_serializer::create_yield_function( abi_serializer_max_time ) );
+   if( const auto cached_abi = abi_cache->get( db.db(), params.code, abi_serializer::create_yield_function( abi_serializer_max_time ) ) ) {
+      const abi_def& abi = cached_abi->abi;
+      const abi_serializer& abis = cached_abi->serializer;
       auto action_type = abis.get_action_type(params.action);
       EOS_ASSERT(!action_type.empty(), action_validate_exception, "Unknown action ${action} in contract ${contract}", ("action", params.action)("contract", params.code));
       try {
@@ -2644,10 +2967,9 @@ read_only::abi_json_to_bin_result read_only::abi_json_to_bin( const read_only::a
 
 read_only::abi_bin_to_json_result read_only::abi_bin_to_json( const read_only::abi_bin_to_json_params& params )const {
    abi_bin_to_json_result result;
-   const auto& code_account = db.db().get<account_object,by_name>( params.code );
-   abi_def abi;
-   if( abi_serializer::to_abi(code_account.abi, abi) ) {
-      abi_serializer abis( abi, abi_serializer::create_yield_function( abi_serializer_max_time ) );
+   db.db().get<account_object,by_name>( params.code );
+   if( const auto cached_abi = abi_cache->get( db.db(), params.code, abi_serializer::create_yield_function( abi_serializer_max_time ) ) ) {
+      const abi_serializer& abis = cached_abi->serializer;
       result.args = abis.binary_to_variant( abis.get_action_type( params.action ), params.binargs, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
    } else {
       EOS_ASSERT(false, abi_not_found_exception, "No ABI found for ${contract}", ("contract", params.code));
@@ -2657,7 +2979,7 @@ read_only::abi_bin_to_json_result read_only::abi_bin_to_json( const read_only::a
 
 read_only::get_required_keys_result read_only::get_required_keys( const get_required_keys_params& params )const {
    transaction pretty_input;
-   auto resolver = make_resolver(db, abi_serializer::create_yield_function( abi_serializer_max_time ));
+   auto resolver = make_resolver(db, abi_cache, abi_serializer::create_yield_function( abi_serializer_max_time ));
    try {
       abi_serializer::from_variant(params.transaction, pretty_input, resolver, abi_serializer::create_yield_function( abi_serializer_max_time ));
    } EOS_RETHROW_EXCEPTIONS(chain::transaction_type_exception, "Invalid transaction")
@@ -2671,7 +2993,7 @@ void read_only::compute_transaction(const compute_transaction_params& params, ne
 
     try {
         auto pretty_input = std::make_shared<packed_transaction>();
-        auto resolver = make_resolver(db, abi_serializer::create_yield_function( abi_serializer_max_time ));
+        auto resolver = make_resolver(db, abi_cache, abi_serializer::create_yield_function( abi_serializer_max_time ));
         try {
             abi_serializer::from_variant(params.transaction, *pretty_input, resolver, abi_serializer::create_yield_function( abi_serializer_max_time ));
         } EOS_RETHROW_EXCEPTIONS(chain::packed_transaction_type_exception, "Invalid packed transaction")
@@ -2768,7 +3090,7 @@ fc::variant chain_plugin::get_log_trx_trace(const transaction_trace_ptr& trx_tra
     fc::variant pretty_output;
     try {
         abi_serializer::to_log_variant(trx_trace, pretty_output,
-                                       chain_apis::make_resolver(chain(), abi_serializer::create_yield_function(get_abi_serializer_max_time())),
+                                       chain_apis::make_resolver(chain(), my->_abi_serializer_cache, abi_serializer::create_yield_function(get_abi_serializer_max_time())),
                                        abi_serializer::create_yield_function(get_abi_serializer_max_time()));
     } catch (...) {
         pretty_output = trx_trace;
@@ -2780,7 +3102,7 @@ fc::variant chain_plugin::get_log_trx(const transaction& trx) const {
     fc::variant pretty_output;
     try {
         abi_serializer::to_log_variant(trx, pretty_output,
-                                       chain_apis::make_resolver(chain(), abi_serializer::create_yield_function(get_abi_serializer_max_time())),
+                                       chain_apis::make_resolver(chain(), my->_abi_serializer_cache, abi_serializer::create_yield_function(get_abi_serializer_max_time())),
                                        abi_serializer::create_yield_function(get_abi_serializer_max_time()));
     } catch (...) {
         pretty_output = trx;
@@ -0,0 +1,42 @@
+#include <eosio/chain_plugin/get_block_cache.hpp>
+
+namespace eosio::chain_apis {
+
+using namespace eosio::chain;
+
+get_block_cache::get_block_cache( size_t max_entries )
+: _entries( max_entries )
+{
+}
+
+void get_block_cache::set_max_entries( size_t max_entries ) {
+   _entries.set_max_bytes( max_entries );
+}
+
+get_block_cache::cached_block_ptr get_block_cache::get( uint32_t block_num ) {
+   if( auto cached = _entries.get( block_num ) )
+      return std::move( *cached );
+   return {};
+}
+
+void get_block_cache::put( uint32_t block_num, cached_block_ptr block ) {
+   _entries.put( block_num, std::move( block ), 1 );
+}
+
+bool get_block_cache::is_current( const cached_block& block, const abi_lookup& get_abi ) {
+   for( const auto& [account, abi] : block.abis ) {
+      if( get_abi( account ) != abi )
+         return false;
+   }
+   return true;
+}
+
+size_t get_block_cache::size()const {
+   return _entries.get_stats().entries;
+}
+
+void get_block_cache::clear() {
+   _entries.clear();
+}
+
+} // namespace eosio::chain_apis
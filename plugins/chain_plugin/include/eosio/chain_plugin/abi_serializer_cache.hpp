@@ -0,0 +1,59 @@
+#pragma once
+#include <eosio/chain/abi_serializer.hpp>
+#include <eosio/chain/lru_cache.hpp>
+#include <eosio/chain/types.hpp>
+
+#include <memory>
+
+namespace eosio::chain_apis {
+
+/**
+ * Thread safe cache of the ABIs set on accounts, unpacked and with their abi_serializer built, shared by the API
+ * requests so that each request does not rebuild them.
+ *
+ * Entries are keyed by account and hold the abi_sequence and a hash of the packed ABI they were built from. setabi
+ * increments abi_sequence, so the first request after an ABI change replaces the entry. The hash is compared as well,
+ * since the same abi_sequence may carry a different ABI on another fork. The least recently used entry is evicted
+ * when the cache is full.
+ */
+class abi_serializer_cache {
+public:
+   struct cached_abi {
+      cached_abi( chain::abi_def&& a, const chain::abi_serializer::yield_function_t& yield )
+      : abi( std::move(a) ), serializer( abi, yield ) {}
+
+      const chain::abi_def         abi;
+      const chain::abi_serializer  serializer;
+   };
+   using cached_abi_ptr = std::shared_ptr<const cached_abi>;
+
+   static constexpr size_t default_max_entries = 1024;
+
+   explicit abi_serializer_cache( size_t max_entries = default_max_entries );
+
+   /**
+    * @param yield - limits building the serializer, only used if not already cached
+    * @return ABI of account, nullptr if the account does not exist or has no ABI
+    */
+   cached_abi_ptr get( const chainbase::database& db, chain::account_name account,
+                       const chain::abi_serializer::yield_function_t& yield );
+
+   /// same as get, for use as the resolver of abi_serializer::to_variant and from_variant
+   std::shared_ptr<const chain::abi_serializer> get_serializer( const chainbase::database& db, chain::account_name account,
+                                                                const chain::abi_serializer::yield_function_t& yield );
+
+   size_t size()const;
+   void clear();
+
+private:
+   struct entry {
+      uint64_t            abi_sequence = 0;
+      size_t              abi_hash = 0;
+      cached_abi_ptr      abi;
+   };
+
+   /// each entry has size 1, so the budget is the number of entries
+   mutable chain::lru_cache<chain::account_name, std::shared_ptr<const entry>>  _entries;
+};
+
+} // namespace eosio::chain_apis
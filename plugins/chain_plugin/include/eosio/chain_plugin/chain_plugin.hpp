@@ -16,7 +16,9 @@
 #include <boost/container/flat_set.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include <eosio/chain_plugin/abi_serializer_cache.hpp>
 #include <eosio/chain_plugin/account_query_db.hpp>
+#include <eosio/chain_plugin/get_block_cache.hpp>
 #include <eosio/chain_plugin/trx_retry_db.hpp>
 #include <eosio/chain_plugin/trx_finality_status_processing.hpp>
 
@@ -92,20 +94,30 @@ class read_only {
    const std::optional<account_query_db>& aqdb;
    const fc::microseconds abi_serializer_max_time;
    bool  shorten_abi_errors = true;
+   size_t max_batch_size = default_max_batch_size;
    const producer_plugin* producer_plug;
    const trx_finality_status_processing* trx_finality_status_proc;
+   std::shared_ptr<abi_serializer_cache> abi_cache;
+   std::shared_ptr<get_block_cache> block_cache;
 
 public:
    static const string KEYi64;
 
-   read_only(const controller& db, const std::optional<account_query_db>& aqdb, const fc::microseconds& abi_serializer_max_time, const producer_plugin* producer_plug, const trx_finality_status_processing* trx_finality_status_proc)
-      : db(db), aqdb(aqdb), abi_serializer_max_time(abi_serializer_max_time), producer_plug(producer_plug), trx_finality_status_proc(trx_finality_status_proc) {
+   read_only(const controller& db, const std::optional<account_query_db>& aqdb, const fc::microseconds& abi_serializer_max_time, const producer_plugin* producer_plug, const trx_finality_status_processing* trx_finality_status_proc,
+             std::shared_ptr<abi_serializer_cache> abi_cache = {}, std::shared_ptr<get_block_cache> block_cache = {})
+      : db(db), aqdb(aqdb), abi_serializer_max_time(abi_serializer_max_time), producer_plug(producer_plug), trx_finality_status_proc(trx_finality_status_proc)
+      , abi_cache(abi_cache ? std::move(abi_cache) : std::make_shared<abi_serializer_cache>())
+      , block_cache(block_cache ? std::move(block_cache) : std::make_shared<get_block_cache>()) {
    }
 
    void validate() const {}
 
    void set_shorten_abi_errors( bool f ) { shorten_abi_errors = f; }
 
+   /// maximum number of queries of a batch call such as get_accounts
+   void set_max_batch_size( size_t n ) { max_batch_size = n; }
+   size_t get_max_batch_size()const { return max_batch_size; }
+
    using get_info_params = empty;
 
    struct get_info_results {
@@ -231,6 +243,24 @@ public:
    };
    get_account_results get_account( const get_account_params& params )const;
 
+   static constexpr size_t default_max_batch_size = 1000;
+
+   struct get_accounts_params {
+      vector<name>          account_names;
+      std::optional<symbol> expected_core_symbol;
+   };
+
+   struct get_accounts_results {
+      vector<get_account_results> accounts;
+      std::optional<name>         more; ///< first account not looked up within the time limit, request it and the ones after it again
+   };
+
+   /**
+    * get_account of each account, with the system contract ABI and core symbol looked up once. The accounts share the
+    * time limit of one call, the ones not looked up in it are left to another call, see more.
+    */
+   get_accounts_results get_accounts( const get_accounts_params& params )const;
+
 
    struct get_code_results {
       name                   account_name;
@@ -345,6 +375,12 @@ public:
 
    fc::variant get_block_info(const get_block_info_params& params) const;
 
+   /**
+    * @return true if result of get_block or get_block_info never changes: its block is irreversible and it has no
+    * transactions, whose actions get_block decodes with the current ABIs of their contracts
+    */
+   bool is_immutable_block(const fc::variant& result) const;
+
    struct get_block_header_state_params {
       string block_num_or_id;
    };
@@ -365,6 +401,8 @@ public:
       string               encode_type{"dec"}; //dec, hex , default=dec
       std::optional<bool>  reverse;
       std::optional<bool>  show_payer; // show RAM pyer
+      std::optional<bool>  keys_only; // rows of primary_key and secondary_key, without reading or decoding the row data
+      vector<string>       fields; // with json, only these fields of each row
     };
 
    struct get_table_rows_result {
@@ -375,6 +413,57 @@ public:
 
    get_table_rows_result get_table_rows( const get_table_rows_params& params )const;
 
+   /// get_table_rows_result with the rows copied out of the database, to be converted without access to the chain
+   struct get_table_rows_raw_result {
+      struct row {
+         vector<char>     data;
+         name             payer;
+         uint64_t         primary_key = 0; ///< only set with keys_only
+         string           secondary_key;   ///< only set with keys_only, of a secondary index
+      };
+
+      vector<row>         rows;
+      bool                more = false;
+      string              next_key;
+      vector<string>      fields;   ///< params fields checked against the table struct, without duplicates
+   };
+
+   /// JSON of get_table_rows( params ), without building a variant of each row, see abi_serializer::binary_to_json
+   string get_table_rows_json( const get_table_rows_params& params )const;
+
+   /// JSON created a piece at a time, each call of next appends the next piece and returns false once it is complete
+   struct json_stream {
+      std::function<bool(string&)> next;
+      size_t                       held_bytes = 0; ///< memory held by next until it is complete
+   };
+
+   /**
+    * Same JSON as get_table_rows_json, produced a piece at a time.
+    *
+    * The rows are copied out of the database by this call. Each call of the returned next converts the next rows
+    * and appends them to its argument, it returns false once the JSON is complete. It does not access the chain, so it
+    * may run after the chain has changed, and throws the same exceptions as get_table_rows for data the ABI cannot
+    * decode.
+    */
+   json_stream get_table_rows_stream( const get_table_rows_params& params )const;
+
+   /// size after which get_table_rows_stream ends a piece
+   static constexpr size_t table_rows_piece_size = 64*1024;
+
+   struct get_table_rows_batch_params {
+      vector<get_table_rows_params> queries;
+   };
+
+   /**
+    * JSON of {"results":[...]} with the get_table_rows_json of each query, queries of the same contract share its ABI.
+    * The queries share the time limit of one get_table_rows, a query that runs out of it returns the rows it found
+    * so far, possibly none, with more and next_key.
+    */
+   string get_table_rows_batch_json( const get_table_rows_batch_params& params )const;
+
+   /// get_table_rows_batch_json a piece at a time, see get_table_rows_stream
+   json_stream get_table_rows_batch_stream( const get_table_rows_batch_params& params )const;
+
    struct get_table_by_scope_params {
       name                 code; // mandatory
       name                 table; // optional, act as filter
@@ -493,15 +582,36 @@ public:
 
    static uint64_t get_table_index_name(const read_only::get_table_rows_params& p, bool& primary);
 
+   /// ABI of account from abi_cache, an empty ABI if account has none, throws if account does not exist
+   abi_serializer_cache::cached_abi_ptr get_cached_abi( const name& account )const;
+
+   get_account_results get_account( const get_account_params& params, const abi_serializer_cache::cached_abi_ptr& system_abi,
+                                    const symbol& core_symbol )const;
+
+   /// time limit of walking the database in one call, shared by the queries of a batch
+   static fc::time_point walk_deadline() {
+      return fc::time_point::now() + fc::microseconds(1000 * 10); /// 10ms max time
+   }
+
+   json_stream get_table_rows_stream( const get_table_rows_params& p, abi_serializer_cache::cached_abi_ptr cached_abi,
+                                      const fc::time_point& deadline )const;
+
+   get_table_rows_raw_result get_table_rows_impl( const get_table_rows_params& p, const abi_serializer_cache::cached_abi_ptr& cached_abi,
+                                                  const fc::time_point& deadline )const;
+   get_table_rows_raw_result get_table_rows_of_index( const get_table_rows_params& p, const abi_def& abi,
+                                                      const fc::time_point& deadline )const;
+
+   /**
+    * The rows in range, copied out of the database without decoding them so that the time limit is spent on finding
+    * rows. They are decoded afterwards, each within abi_serializer_max_time.
+    */
    template <typename IndexType, typename SecKeyType, typename ConvFn>
-   read_only::get_table_rows_result get_table_rows_by_seckey( const read_only::get_table_rows_params& p, const abi_def& abi, ConvFn conv )const {
-      read_only::get_table_rows_result result;
+   get_table_rows_raw_result get_table_rows_by_seckey( const read_only::get_table_rows_params& p, const fc::time_point& deadline, ConvFn conv )const {
+      get_table_rows_raw_result result;
       const auto& d = db.db();
 
       name scope{ convert_to_type<uint64_t>(p.scope, "scope") };
 
-      abi_serializer abis;
-      abis.set_abi(abi, abi_serializer::create_yield_function( abi_serializer_max_time ) );
       bool primary = false;
       const uint64_t table_with_index = get_table_index_name(p, primary);
       const auto* t_id = d.find<chain::table_id_object, chain::by_code_scope_table>(boost::make_tuple(p.code, scope, p.table));
@@ -549,26 +659,22 @@ public:
          if( upper_bound_lookup_tuple < lower_bound_lookup_tuple )
             return result;
 
+         const bool keys_only = p.keys_only && *p.keys_only;
          auto walk_table_row_range = [&]( auto itr, auto end_itr ) {
             auto cur_time = fc::time_point::now();
-            auto end_time = cur_time + fc::microseconds(1000 * 10); /// 10ms max time
-            vector<char> data;
-            for( unsigned int count = 0; cur_time <= end_time && count < p.limit && itr != end_itr; ++itr, cur_time = fc::time_point::now() ) {
-               const auto* itr2 = d.find<chain::key_value_object, chain::by_scope_primary>( boost::make_tuple(t_id->id, itr->primary_key) );
-               if( itr2 == nullptr ) continue;
-               copy_inline_row(*itr2, data);
-
-               fc::variant data_var;
-               if( p.json ) {
-                  data_var = abis.binary_to_variant( abis.get_table_type(p.table), data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
+            for( unsigned int count = 0; cur_time <= deadline && count < p.limit && itr != end_itr; ++itr, cur_time = fc::time_point::now() ) {
+               const auto& obj = *itr; // a reverse iterator steps back on each dereference, do it once
+               if( keys_only ) {
+                  auto& row = result.rows.emplace_back();
+                  row.payer = obj.payer;
+                  row.primary_key = obj.primary_key;
+                  row.secondary_key = convert_to_string(obj.secondary_key, p.key_type, p.encode_type, "secondary_key");
                } else {
-                  data_var = fc::variant( data );
-               }
-
-               if( p.show_payer && *p.show_payer ) {
-                  result.rows.emplace_back( fc::mutable_variant_object("data", std::move(data_var))("payer", itr->payer) );
-               } else {
-                  result.rows.emplace_back( std::move(data_var) );
+                  const auto* itr2 = d.find<chain::key_value_object, chain::by_scope_primary>( boost::make_tuple(t_id->id, obj.primary_key) );
+                  if( itr2 == nullptr ) continue;
+                  auto& row = result.rows.emplace_back();
+                  row.payer = obj.payer;
+                  copy_inline_row(*itr2, row.data);
                }
 
                ++count;
@@ -590,15 +696,14 @@ public:
       return result;
    }
 
+   /// see get_table_rows_by_seckey
    template <typename IndexType>
-   read_only::get_table_rows_result get_table_rows_ex( const read_only::get_table_rows_params& p, const abi_def& abi )const {
-      read_only::get_table_rows_result result;
+   get_table_rows_raw_result get_table_rows_ex( const read_only::get_table_rows_params& p, const fc::time_point& deadline )const {
+      get_table_rows_raw_result result;
       const auto& d = db.db();
 
       uint64_t scope = convert_to_type<uint64_t>(p.scope, "scope");
 
-      abi_serializer abis;
-      abis.set_abi(abi, abi_serializer::create_yield_function( abi_serializer_max_time ));
       const auto* t_id = d.find<chain::table_id_object, chain::by_code_scope_table>(boost::make_tuple(p.code, name(scope), p.table));
       if( t_id != nullptr ) {
          const auto& idx = d.get_index<IndexType, chain::by_scope_primary>();
@@ -628,25 +733,17 @@ public:
          if( upper_bound_lookup_tuple < lower_bound_lookup_tuple  )
             return result;
 
+         const bool keys_only = p.keys_only && *p.keys_only;
          auto walk_table_row_range = [&]( auto itr, auto end_itr ) {
             auto cur_time = fc::time_point::now();
-            auto end_time = cur_time + fc::microseconds(1000 * 10); /// 10ms max time
-            vector<char> data;
-            for( unsigned int count = 0; cur_time <= end_time && count < p.limit && itr != end_itr; ++count, ++itr, cur_time = fc::time_point::now() ) {
-               copy_inline_row(*itr, data);
-
-               fc::variant data_var;
-               if( p.json ) {
-                  data_var = abis.binary_to_variant( abis.get_table_type(p.table), data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
-               } else {
-                  data_var = fc::variant( data );
-               }
-
-               if( p.show_payer && *p.show_payer ) {
-                  result.rows.emplace_back( fc::mutable_variant_object("data", std::move(data_var))("payer", itr->payer) );
-               } else {
-                  result.rows.emplace_back( std::move(data_var) );
-               }
+            for( unsigned int count = 0; cur_time <= deadline && count < p.limit && itr != end_itr; ++count, ++itr, cur_time = fc::time_point::now() ) {
+               const auto& obj = *itr; // a reverse iterator steps back on each dereference, do it once
+               auto& row = result.rows.emplace_back();
+               row.payer = obj.payer;
+               if( keys_only )
+                  row.primary_key = obj.primary_key;
+               else
+                  copy_inline_row(obj, row.data);
             }
             if( itr != end_itr ) {
                result.more = true;
@@ -684,8 +781,10 @@ class read_write {
    std::optional<trx_retry_db>& trx_retry;
    const fc::microseconds abi_serializer_max_time;
    const bool api_accept_transactions;
+   std::shared_ptr<abi_serializer_cache> abi_cache;
 public:
-   read_write(controller& db, std::optional<trx_retry_db>& trx_retry, const fc::microseconds& abi_serializer_max_time, bool api_accept_transactions);
+   read_write(controller& db, std::optional<trx_retry_db>& trx_retry, const fc::microseconds& abi_serializer_max_time, bool api_accept_transactions,
+              std::shared_ptr<abi_serializer_cache> abi_cache = {});
    void validate() const;
 
    using push_block_params = chain::signed_block;
@@ -864,8 +963,9 @@ FC_REFLECT(eosio::chain_apis::read_only::get_block_header_state_params, (block_n
 FC_REFLECT( eosio::chain_apis::read_write::push_transaction_results, (transaction_id)(processed) )
 FC_REFLECT( eosio::chain_apis::read_write::send_transaction2_params, (return_failure_trace)(retry_trx)(retry_trx_num_blocks)(transaction) )
 
-FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_params, (json)(code)(scope)(table)(table_key)(lower_bound)(upper_bound)(limit)(key_type)(index_position)(encode_type)(reverse)(show_payer) )
+FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_params, (json)(code)(scope)(table)(table_key)(lower_bound)(upper_bound)(limit)(key_type)(index_position)(encode_type)(reverse)(show_payer)(keys_only)(fields) )
 FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_result, (rows)(more)(next_key) );
+FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_batch_params, (queries) )
 
 FC_REFLECT( eosio::chain_apis::read_only::get_table_by_scope_params, (code)(table)(lower_bound)(upper_bound)(limit)(reverse) )
 FC_REFLECT( eosio::chain_apis::read_only::get_table_by_scope_result_row, (code)(scope)(table)(payer)(count));
@@ -895,6 +995,8 @@ FC_REFLECT( eosio::chain_apis::read_only::get_code_results, (account_name)(code_
 FC_REFLECT( eosio::chain_apis::read_only::get_code_hash_results, (account_name)(code_hash) )
 FC_REFLECT( eosio::chain_apis::read_only::get_abi_results, (account_name)(abi) )
 FC_REFLECT( eosio::chain_apis::read_only::get_account_params, (account_name)(expected_core_symbol) )
+FC_REFLECT( eosio::chain_apis::read_only::get_accounts_params, (account_names)(expected_core_symbol) )
+FC_REFLECT( eosio::chain_apis::read_only::get_accounts_results, (accounts)(more) )
 FC_REFLECT( eosio::chain_apis::read_only::get_code_params, (account_name)(code_as_wasm) )
 FC_REFLECT( eosio::chain_apis::read_only::get_code_hash_params, (account_name) )
 FC_REFLECT( eosio::chain_apis::read_only::get_abi_params, (account_name) )
@@ -0,0 +1,60 @@
+#pragma once
+#include <eosio/chain_plugin/abi_serializer_cache.hpp>
+#include <eosio/chain/block.hpp>
+#include <eosio/chain/lru_cache.hpp>
+
+#include <fc/variant.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace eosio::chain_apis {
+
+/**
+ * Thread safe cache of the get_block results of irreversible blocks, shared by the API requests.
+ *
+ * A result holds the action data of the block decoded with the ABIs of the contracts at the time, which setabi can
+ * change after the block is irreversible. Each entry keeps the ABIs it was decoded with, as returned by
+ * abi_serializer_cache, and its result is only used while abi_serializer_cache returns the same ABIs for all of those
+ * contracts. The signed block is used either way, so a result outdated by setabi is decoded again without reading
+ * the block log. The least recently used entry is evicted when the cache is full.
+ */
+class get_block_cache {
+public:
+   struct cached_block {
+      chain::signed_block_ptr                                                           block;
+      chain::block_id_type                                                              id;
+      fc::variant                                                                       result;
+      /// ABI of each contract the block was decoded with, nullptr for a contract without ABI
+      std::vector<std::pair<chain::account_name, abi_serializer_cache::cached_abi_ptr>>  abis;
+   };
+   using cached_block_ptr = std::shared_ptr<const cached_block>;
+
+   /// @return current ABI of a contract
+   using abi_lookup = std::function<abi_serializer_cache::cached_abi_ptr(chain::account_name)>;
+
+   static constexpr size_t default_max_entries = 128;
+
+   explicit get_block_cache( size_t max_entries = default_max_entries );
+
+   /// Not thread safe, call before use. 0 disables the cache.
+   void set_max_entries( size_t max_entries );
+
+   /// @return entry of block_num, nullptr if not cached
+   cached_block_ptr get( uint32_t block_num );
+
+   void put( uint32_t block_num, cached_block_ptr block );
+
+   /// @return whether get_abi returns the ABIs the result of block was decoded with
+   static bool is_current( const cached_block& block, const abi_lookup& get_abi );
+
+   size_t size()const;
+   void clear();
+
+private:
+   /// each entry has size 1, so the budget is the number of entries
+   chain::lru_cache<uint32_t, cached_block_ptr>  _entries;
+};
+
+} // namespace eosio::chain_apis
@@ -0,0 +1,78 @@
+#define BOOST_TEST_MODULE abi_serializer_cache
+#include <boost/test/included/unit_test.hpp>
+#include <eosio/testing/tester.hpp>
+#include <eosio/chain_plugin/abi_serializer_cache.hpp>
+#include <contracts.hpp>
+
+#ifdef NON_VALIDATING_TEST
+#define TESTER tester
+#else
+#define TESTER validating_tester
+#endif
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+using namespace eosio::chain_apis;
+
+BOOST_AUTO_TEST_SUITE(abi_serializer_cache_tests)
+
+BOOST_FIXTURE_TEST_CASE(get_test, TESTER) { try {
+   abi_serializer_cache cache;
+   const auto yield = abi_serializer::create_yield_function( fc::microseconds::maximum() );
+   const auto& db = control->db();
+
+   create_accounts( { "eosio.token"_n, "alice"_n } );
+   produce_block();
+
+   BOOST_TEST( !cache.get( db, "nobody"_n, yield ) );
+   BOOST_TEST( !cache.get( db, "alice"_n, yield ) ); // no ABI set
+   BOOST_TEST( cache.size() == 0u );
+
+   set_abi( "eosio.token"_n, contracts::eosio_token_abi().data() );
+   produce_block();
+
+   const auto token_abi = cache.get( db, "eosio.token"_n, yield );
+   BOOST_REQUIRE( token_abi );
+   BOOST_TEST( token_abi->serializer.get_action_type( "transfer"_n ) == "transfer" );
+   BOOST_TEST( cache.get( db, "eosio.token"_n, yield ) == token_abi );
+   BOOST_TEST( cache.get_serializer( db, "eosio.token"_n, yield ).get() == &token_abi->serializer );
+   BOOST_TEST( cache.size() == 1u );
+
+   // setabi replaces the entry
+   set_abi( "eosio.token"_n, contracts::eosio_system_abi().data() );
+   produce_block();
+   const auto system_abi = cache.get( db, "eosio.token"_n, yield );
+   BOOST_REQUIRE( system_abi );
+   BOOST_TEST( system_abi != token_abi );
+   BOOST_TEST( system_abi->serializer.get_action_type( "transfer"_n ).empty() );
+   BOOST_TEST( cache.size() == 1u );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_FIXTURE_TEST_CASE(bounded_test, TESTER) { try {
+   abi_serializer_cache cache( 2 );
+   const auto yield = abi_serializer::create_yield_function( fc::microseconds::maximum() );
+
+   const std::vector<account_name> accounts = { "alice"_n, "bob"_n, "carol"_n };
+   create_accounts( accounts );
+   for( const auto& a : accounts ) {
+      set_abi( a, contracts::eosio_token_abi().data() );
+   }
+   produce_block();
+
+   for( const auto& a : accounts ) {
+      BOOST_TEST( cache.get( control->db(), a, yield ) );
+      BOOST_TEST( cache.size() <= 2u );
+   }
+
+   // the least recently used entry is evicted
+   const auto alice_abi = cache.get( control->db(), "alice"_n, yield );
+   const auto carol_abi = cache.get( control->db(), "carol"_n, yield );
+   BOOST_TEST( cache.get( control->db(), "bob"_n, yield ) ); // evicts alice
+   BOOST_TEST( cache.get( control->db(), "carol"_n, yield ) == carol_abi );
+   BOOST_TEST( cache.get( control->db(), "alice"_n, yield ) != alice_abi );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -508,4 +508,43 @@ BOOST_FIXTURE_TEST_CASE(account_results_rex_info_test, chain_plugin_tester) { tr
 
 } FC_LOG_AND_RETHROW() }
 
+// get_block of an irreversible block is served from the cache until the ABI the block was decoded with changes
+BOOST_FIXTURE_TEST_CASE(get_block_cache_test, TESTER) { try {
+    create_accounts( { "eosio.token"_n } );
+    set_code( "eosio.token"_n, contracts::eosio_token_wasm() );
+    set_abi( "eosio.token"_n, contracts::eosio_token_abi().data() );
+    produce_block();
+
+    auto trace = push_action( "eosio.token"_n, "create"_n, "eosio.token"_n,
+                              mvo()("issuer", "eosio.token")("maximum_supply", "1000000.0000 TOK") );
+    const uint32_t block_num = trace->block_num;
+    produce_blocks( 2 );
+    BOOST_REQUIRE( control->last_irreversible_block_num() >= block_num );
+
+    auto block_cache = std::make_shared<get_block_cache>();
+    chain_apis::read_only plugin( *control, {}, fc::microseconds::maximum(), {}, {}, {}, block_cache );
+    const auto action_data = [&]( const fc::variant& block ) {
+       return block["transactions"][size_t(0)]["trx"]["transaction"]["actions"][size_t(0)]["data"];
+    };
+
+    const read_only::get_block_params params{ std::to_string( block_num ) };
+    BOOST_TEST( action_data( plugin.get_block( params ) ).is_object() );
+    BOOST_TEST( block_cache->size() == 1u );
+    const auto cached = block_cache->get( block_num );
+    BOOST_REQUIRE( cached );
+    BOOST_TEST( cached->abis.size() == 1u );
+
+    // by id the same entry is used
+    BOOST_TEST( plugin.get_block( { cached->id.str() } )["block_num"].as<uint32_t>() == block_num );
+    BOOST_TEST( block_cache->get( block_num ) == cached );
+
+    // an ABI without the create action leaves the data undecoded, the cached result is not used anymore
+    set_abi( "eosio.token"_n, contracts::eosio_system_abi().data() );
+    produce_block();
+    BOOST_TEST( action_data( plugin.get_block( params ) ).is_string() );
+    BOOST_TEST( block_cache->get( block_num ) != cached );
+    BOOST_TEST( block_cache->size() == 1u );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -1,7 +1,12 @@
 #include <eosio/http_plugin/http_plugin.hpp>
 #include <eosio/http_plugin/local_endpoint.hpp>
+#include <eosio/http_plugin/content_encoding.hpp>
+#include <eosio/http_plugin/queue_delay_predictor.hpp>
 #include <eosio/chain/exceptions.hpp>
 #include <eosio/chain/thread_utils.hpp>
+#include <eosio/chain/token_bucket_limiter.hpp>
+#include <eosio/chain/lru_cache.hpp>
+#include <eosio/chain/fair_queue.hpp>
 
 #include <fc/network/ip.hpp>
 #include <fc/log/logger_config.hpp>
@@ -12,6 +17,7 @@
 
 #include <boost/asio.hpp>
 #include <boost/optional.hpp>
+#include <boost/algorithm/string.hpp>
 
 #include <websocketpp/config/asio_client.hpp>
 #include <websocketpp/config/asio.hpp>
@@ -127,12 +133,17 @@ namespace eosio {
       /**
        * virtualized wrapper for the various underlying connection functions needed in req/resp processng
        */
-      struct abstract_conn {
+      struct abstract_conn : std::enable_shared_from_this<abstract_conn> {
          virtual ~abstract_conn() = default;
          virtual bool verify_max_bytes_in_flight() = 0;
          virtual bool verify_max_requests_in_flight() = 0;
          virtual void handle_exception() = 0;
+         virtual std::string remote_address() = 0;
          virtual void send_response(std::optional<std::string> body, int code) = 0;
+         /// sends json, the cached response of key, in the encoding the request accepts
+         virtual void send_cached_response(const std::string& key, std::shared_ptr<const std::string> json) = 0;
+         /// sends first, then the pieces of body while more, see chunked_body
+         virtual void send_chunked_response(std::string first, bool more, chunked_body body, int code) = 0;
       };
 
       using abstract_conn_ptr = std::shared_ptr<abstract_conn>;
@@ -168,6 +179,43 @@ namespace eosio {
          return 0;
       }
 
+      static size_t in_flight_sizeof( const json_body& b ) {
+         return b.json.size();
+      }
+
+      /// what next holds for the pieces to come, the pieces themselves are tracked as they are written
+      static size_t in_flight_sizeof( const chunked_body& b ) {
+         return b.held_bytes;
+      }
+
+      static size_t in_flight_sizeof( const response_body& b ) {
+         return std::visit( []( const auto& v ) { return in_flight_sizeof( v ); }, b );
+      }
+
+      /**
+       * Helper method to normalize a request for use as a cache key
+       * @param v - the parsed request body
+       * @return v with the members of its objects sorted by name
+       */
+      static fc::variant sorted_variant( const fc::variant& v ) {
+         if( v.is_object() ) {
+            std::map<string, fc::variant> members;
+            for( const auto& e : v.get_object() )
+               members[e.key()] = sorted_variant( e.value() );
+            fc::mutable_variant_object result;
+            for( auto& m : members )
+               result( m.first, std::move( m.second ) );
+            return fc::variant( std::move( result ) );
+         }
+         if( v.is_array() ) {
+            fc::variants result;
+            for( const auto& e : v.get_array() )
+               result.emplace_back( sorted_variant( e ) );
+            return fc::variant( std::move( result ) );
+         }
+         return v;
+      }
+
       /**
        * Helper method to calculate the "in flight" size of a std::optional<T>
        * When the optional doesn't contain value, it will return the size of 0
@@ -220,6 +268,19 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
          size_t                                      max_bytes_in_flight = 0;
          int32_t                                     max_requests_in_flight = -1;
          fc::microseconds                            max_response_time{30*1000};
+         int                                         compression_level = 6; // 0 disables compression
+         size_t                                      compression_min_size = 1024;
+         set<string>                                 rate_limited_urls;
+         fc::microseconds                            max_queue_delay; // 0 disables load shedding
+         detail::queue_delay_predictor               app_queue_delay; // of the requests posted to the app thread
+
+         /// requests waiting for the app thread, taking turns between remote addresses
+         using app_queue = chain::fair_queue<string, std::function<void()>>;
+         map<int, std::shared_ptr<app_queue>>        app_queues; // by priority
+         set<string>                                 cached_urls;
+         size_t                                      response_cache_size = 0;
+         chain::lru_cache<string, std::shared_ptr<const string>> response_cache; // thread safe, keyed by response_cache_key
+         chain::token_bucket_limiter<string>         ip_limiter; // thread safe, keyed by remote address
 
          std::optional<tcp::endpoint>  https_listen_endpoint;
          string                        https_cert_chain;
@@ -355,6 +416,25 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
             con->send_http_response();
          }
 
+         template<class T>
+         static string remote_address( const detail::connection_ptr<T>& con ) {
+            boost::system::error_code ec;
+            auto rep = con->get_socket().lowest_layer().remote_endpoint( ec );
+            return ec ? string() : rep.address().to_string();
+         }
+
+         template<class T>
+         bool verify_rate_limit( const detail::connection_ptr<T>& con, const string& resource ) {
+            if( !ip_limiter.enabled() || rate_limited_urls.find( resource ) == rate_limited_urls.end() )
+               return true;
+            const string address = remote_address<T>( con );
+            if( address.empty() || ip_limiter.try_consume( address, fc::time_point::now() ) )
+               return true;
+            fc_dlog( logger, "429 - rate limit exceeded for ${a} on ${r}", ("a", address)("r", resource) );
+            report_429_error( con, "Too many requests from " + address + ". Try again later." );
+            return false;
+         }
+
          template<typename T>
          bool verify_max_bytes_in_flight( const T& con ) {
             auto bytes_in_flight_size = bytes_in_flight.load();
@@ -383,65 +463,95 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
             return true;
          }
 
+         /// larger requests are not looked up in the response cache
+         static constexpr size_t max_cached_request_size = 1024;
+
          /**
-          * child struct, implementing abstract connection for various underlying connection types
-          * that ties it to an http_plugin_impl
-          *
-          * @tparam T - The downstream parameter for the connection_ptr
+          * @return key of the response to body in response_cache, nothing if responses of resource are not cached
           */
-         template<typename T>
-         struct abstract_conn_impl : public detail::abstract_conn {
-            abstract_conn_impl(detail::connection_ptr<T> conn, http_plugin_impl_ptr impl)
-            :_conn(std::move(conn))
-            ,_impl(std::move(impl))
-            {
-                _impl->requests_in_flight += 1;
-            }
-
-            ~abstract_conn_impl() override {
-                _impl->requests_in_flight -= 1;
-            }
-
-            // No copy constructor and no move
-            abstract_conn_impl(const abstract_conn_impl&) = delete;
-            abstract_conn_impl(abstract_conn_impl&&) = delete;
-            abstract_conn_impl& operator=(const abstract_conn_impl&) = delete;
-            abstract_conn_impl& operator=(abstract_conn_impl&&) noexcept = default;
-
-            bool verify_max_bytes_in_flight() override {
-               return _impl->verify_max_bytes_in_flight(_conn);
-            }
-
-            bool verify_max_requests_in_flight() override {
-               return _impl->verify_max_requests_in_flight(_conn);
-            }
-
-            void handle_exception()override {
-               http_plugin_impl::handle_exception<T>(_conn);
+         std::optional<string> response_cache_key( const string& resource, const string& body ) const {
+            if( !response_cache.enabled() || body.size() > max_cached_request_size ||
+                cached_urls.find( resource ) == cached_urls.end() )
+               return {};
+            // requests that only differ in whitespace or member order get the same key
+            string key = resource;
+            key += '\n';
+            if( !make_trimmed_string_view( body ).empty() ) {
+               try {
+                  key += fc::json::to_string( detail::sorted_variant( fc::json::from_string( body ) ), fc::time_point::maximum() );
+               } catch( ... ) {
+                  return {}; // invalid, left to the handler to report
+               }
             }
+            return key;
+         }
 
-            void send_response(std::optional<std::string> body, int code) override {
-               if( body ) {
-                  _conn->set_body( std::move( *body ) );
+         /// wraps next to add the response it creates to response_cache once complete
+         std::function<bool(string&)> cache_chunked_response( string key, std::function<bool(string&)> next ) {
+            return [my=shared_from_this(), key=std::move(key), next=std::move(next), json=std::make_shared<string>()]( string& out ) mutable {
+               const size_t start = out.size();
+               const bool more = next( out );
+               if( json ) {
+                  json->append( out, start, string::npos );
+                  if( json->size() + key.size() > my->response_cache_size ) {
+                     json.reset(); // too large to cache, stop collecting it
+                  } else if( !more ) {
+                     const size_t size = json->size() + key.size();
+                     my->response_cache.put( key, std::move( json ), size );
+                  }
                }
-               _conn->set_status( websocketpp::http::status_code::value( code ) );
-               _conn->send_http_response();
-            }
+               return more;
+            };
+         }
 
-            detail::connection_ptr<T> _conn;
-            http_plugin_impl_ptr _impl;
-         };
+         /**
+          * @param key - key of json in response_cache
+          * @return json compressed in encoding, which is done once and then kept in response_cache next to json
+          */
+         std::shared_ptr<const string> encoded_cached_response( const string& key, const string& json, detail::content_encoding encoding ) {
+            string encoded_key = key;
+            encoded_key += '\n';
+            encoded_key += detail::to_string( encoding );
+            if( auto cached = response_cache.get( encoded_key ) )
+               return std::move( *cached );
+            detail::response_compressor compressor( encoding, compression_level );
+            auto encoded = std::make_shared<string>( compressor.write( json ) );
+            *encoded += compressor.finish();
+            response_cache.put( encoded_key, encoded, encoded->size() + encoded_key.size() );
+            return encoded;
+         }
 
          /**
-          * Helper to construct an abstract_conn_impl for a given connection and instance of http_plugin_impl
-          * @tparam T - The downstream parameter for the connection_ptr
-          * @param conn - existing connection_ptr<T>
-          * @param impl - the owning http_plugin_impl
-          * @return abstract_conn_ptr backed by type specific implementations of the methods
+          * @param req - the request being responded to
+          * @param size - size of the response body, or at least the size of its first piece
+          * @return the encoding to compress the response with
           */
-         template<typename T>
-         static detail::abstract_conn_ptr make_abstract_conn_ptr( detail::connection_ptr<T> conn, http_plugin_impl_ptr impl ) {
-            return std::make_shared<abstract_conn_impl<T>>(std::move(conn), std::move(impl));
+         template<typename Request>
+         detail::content_encoding response_encoding( const Request& req, size_t size ) const {
+            if( compression_level == 0 || size < compression_min_size )
+               return detail::content_encoding::identity;
+            return detail::select_content_encoding( req.get_header( "Accept-Encoding" ) );
+         }
+
+         /**
+          * Sheds load when the app thread is behind: returns 503 if the queued app thread requests are predicted to take
+          * longer than max_queue_delay to run.
+          * @return true if the request may be queued
+          */
+         bool verify_queue_delay( const detail::abstract_conn_ptr& conn ) {
+            if( max_queue_delay.count() == 0 )
+               return true;
+            const auto predicted_delay = fc::microseconds( app_queue_delay.predicted_delay_us() );
+            if( predicted_delay <= max_queue_delay )
+               return true;
+            fc_dlog( logger, "503 - predicted queue delay ${d}us", ("d", predicted_delay.count()) );
+            error_results::error_info ei;
+            ei.code = websocketpp::http::status_code::service_unavailable;
+            ei.name = "Busy";
+            ei.what = "Predicted wait of " + std::to_string( predicted_delay.count() / 1000 ) + "ms for the main thread. Try again later.";
+            error_results results{websocketpp::http::status_code::service_unavailable, "Service Unavailable", ei};
+            conn->send_response( fc::json::to_string( results, fc::time_point::maximum() ), websocketpp::http::status_code::service_unavailable );
+            return false;
          }
 
          /**
@@ -514,6 +624,196 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
             return std::make_shared<in_flight<T>>(std::forward<T>(object), std::move(impl));
          }
 
+         /**
+          * child struct, implementing abstract connection for various underlying connection types
+          * that ties it to an http_plugin_impl
+          *
+          * @tparam T - The downstream parameter for the connection_ptr
+          */
+         template<typename T>
+         struct abstract_conn_impl : public detail::abstract_conn {
+            abstract_conn_impl(detail::connection_ptr<T> conn, http_plugin_impl_ptr impl)
+            :_conn(std::move(conn))
+            ,_impl(std::move(impl))
+            {
+                _impl->requests_in_flight += 1;
+            }
+
+            ~abstract_conn_impl() override {
+                _impl->requests_in_flight -= 1;
+            }
+
+            // No copy constructor and no move
+            abstract_conn_impl(const abstract_conn_impl&) = delete;
+            abstract_conn_impl(abstract_conn_impl&&) = delete;
+            abstract_conn_impl& operator=(const abstract_conn_impl&) = delete;
+            abstract_conn_impl& operator=(abstract_conn_impl&&) noexcept = default;
+
+            bool verify_max_bytes_in_flight() override {
+               return _impl->verify_max_bytes_in_flight(_conn);
+            }
+
+            bool verify_max_requests_in_flight() override {
+               return _impl->verify_max_requests_in_flight(_conn);
+            }
+
+            void handle_exception()override {
+               http_plugin_impl::handle_exception<T>(_conn);
+            }
+
+            std::string remote_address() override {
+               return http_plugin_impl::remote_address<T>(_conn);
+            }
+
+            void send_response(std::optional<std::string> body, int code) override {
+               if( body ) {
+                  const auto encoding = set_response_encoding( body->size() );
+                  if( encoding != detail::content_encoding::identity ) {
+                     detail::response_compressor compressor( encoding, _impl->compression_level );
+                     std::string compressed = compressor.write( *body );
+                     compressed += compressor.finish();
+                     body = std::move( compressed );
+                  }
+                  _conn->set_body( std::move( *body ) );
+               }
+               _conn->set_status( websocketpp::http::status_code::value( code ) );
+               _conn->send_http_response();
+            }
+
+            void send_cached_response(const std::string& key, std::shared_ptr<const std::string> json) override {
+               const auto encoding = set_response_encoding( json->size() );
+               if( encoding != detail::content_encoding::identity )
+                  json = _impl->encoded_cached_response( key, *json, encoding );
+               _conn->set_body( *json );
+               _conn->set_status( websocketpp::http::status_code::ok );
+               _conn->send_http_response();
+            }
+
+            void send_chunked_response(std::string first, bool more, chunked_body body, int code) override {
+               // counted until the last piece is written
+               auto tracked_body = make_in_flight( std::move( body ), _impl );
+               if( !more || _conn->get_request().get_version() != "HTTP/1.1" ) {
+                  // no chunked encoding before HTTP/1.1, send it as one body
+                  while( more )
+                     more = tracked_body->obj().next( first );
+                  send_response( std::move( first ), code );
+                  return;
+               }
+
+               // websocketpp only sends complete bodies, the status line, headers and chunks are written to its socket
+               // here while it waits for the deferred response. Once done the connection is terminated through
+               // websocketpp, as it does after each of its own HTTP responses.
+               _conn->set_status( websocketpp::http::status_code::value( code ) );
+               _conn->replace_header( "Transfer-Encoding", "chunked" );
+               _conn->replace_header( "Connection", "close" );
+               const auto encoding = set_response_encoding( first.size() );
+               if( encoding != detail::content_encoding::identity )
+                  _compressor = std::make_unique<detail::response_compressor>( encoding, _impl->compression_level );
+               std::string out = _conn->get_response().raw();
+               append_chunk( out, encode( std::move( first ), more ) );
+               write_chunk( std::move( out ), more, std::move( tracked_body ) );
+            }
+
+            /**
+             * Sets the headers for a response of at least size bytes, Content-Encoding if it is compressed
+             * @return the encoding to compress the response with
+             */
+            detail::content_encoding set_response_encoding( size_t size ) {
+               const auto encoding = _impl->response_encoding( _conn->get_request(), size );
+               // whether a response is compressed depends on its size as well, caches must key all of them on it
+               if( _impl->compression_level != 0 )
+                  _conn->append_header( "Vary", "Accept-Encoding" );
+               if( encoding != detail::content_encoding::identity )
+                  _conn->replace_header( "Content-Encoding", detail::to_string( encoding ) );
+               return encoding;
+            }
+
+            /// compresses a piece of a chunked response when compressing
+            std::string encode( std::string piece, bool more ) {
+               if( !_compressor )
+                  return piece;
+               piece = _compressor->write( piece );
+               if( !more )
+                  piece += _compressor->finish();
+               return piece;
+            }
+
+            static void append_chunk( std::string& out, const std::string& piece ) {
+               // an empty chunk would end the body
+               if( piece.empty() )
+                  return;
+               char size[20];
+               out.append( size, snprintf( size, sizeof(size), "%zx\r\n", piece.size() ) );
+               out += piece;
+               out += "\r\n";
+            }
+
+            void write_chunk( std::string out, bool more, std::shared_ptr<in_flight<chunked_body>> body ) {
+               if( !more )
+                  out += "0\r\n\r\n";
+               auto tracked_out = make_in_flight( std::move( out ), _impl );
+               auto self = std::static_pointer_cast<abstract_conn_impl<T>>( shared_from_this() );
+               boost::asio::async_write( _conn->get_socket(), boost::asio::buffer( tracked_out->obj() ),
+                                         [self, tracked_out, more, body]( const boost::system::error_code& ec, std::size_t ) {
+                  if( ec ) {
+                     fc_dlog( logger, "Error writing chunked response: ${e}", ("e", ec.message()) );
+                     self->abort_chunked_response();
+                     return;
+                  }
+                  if( !more ) {
+                     self->_conn->terminate( websocketpp::error::make_error_code( websocketpp::error::http_connection_ended ) );
+                     return;
+                  }
+                  std::string piece;
+                  bool next_more = false;
+                  try {
+                     next_more = body->obj().next( piece );
+                  } catch( const fc::exception& e ) {
+                     fc_elog( logger, "Error creating chunked response, aborting connection: ${e}", ("e", e.to_detail_string()) );
+                     self->abort_chunked_response();
+                     return;
+                  } catch( const std::exception& e ) {
+                     fc_elog( logger, "Error creating chunked response, aborting connection: ${e}", ("e", e.what()) );
+                     self->abort_chunked_response();
+                     return;
+                  } catch( ... ) {
+                     fc_elog( logger, "Unknown error creating chunked response, aborting connection" );
+                     self->abort_chunked_response();
+                     return;
+                  }
+                  std::string next_out;
+                  append_chunk( next_out, self->encode( std::move( piece ), next_more ) );
+                  self->write_chunk( std::move( next_out ), next_more, body );
+               } );
+            }
+
+            /**
+             * Ends a chunked response that cannot be completed. The terminating chunk is not sent and the connection is
+             * reset, so that the client sees an incomplete response instead of a complete but truncated one.
+             */
+            void abort_chunked_response() {
+               boost::system::error_code ec;
+               _conn->get_socket().lowest_layer().set_option( boost::asio::socket_base::linger( true, 0 ), ec );
+               _conn->terminate( websocketpp::error::make_error_code( websocketpp::error::general ) );
+            }
+
+            detail::connection_ptr<T> _conn;
+            http_plugin_impl_ptr _impl;
+            std::unique_ptr<detail::response_compressor> _compressor; // of a chunked response
+         };
+
+         /**
+          * Helper to construct an abstract_conn_impl for a given connection and instance of http_plugin_impl
+          * @tparam T - The downstream parameter for the connection_ptr
+          * @param conn - existing connection_ptr<T>
+          * @param impl - the owning http_plugin_impl
+          * @return abstract_conn_ptr backed by type specific implementations of the methods
+          */
+         template<typename T>
+         static detail::abstract_conn_ptr make_abstract_conn_ptr( detail::connection_ptr<T> conn, http_plugin_impl_ptr impl ) {
+            return std::make_shared<abstract_conn_impl<T>>(std::move(conn), std::move(impl));
+         }
+
          /**
           * Make an internal_url_handler that will run the url_handler on the app() thread and then
           * return to the http thread pool for response processing
@@ -526,26 +826,41 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
           */
          static detail::internal_url_handler make_app_thread_url_handler( int priority, url_handler next, http_plugin_impl_ptr my ) {
             auto next_ptr = std::make_shared<url_handler>(std::move(next));
-            return [my=std::move(my), priority, next_ptr=std::move(next_ptr)]
+            auto& queue = my->app_queues[priority];
+            if( !queue )
+               queue = std::make_shared<app_queue>();
+            return [my=std::move(my), priority, next_ptr=std::move(next_ptr), queue]
                        ( detail::abstract_conn_ptr conn, string r, string b, url_response_callback then ) {
                auto tracked_b = make_in_flight<string>(std::move(b), my);
-               if (!conn->verify_max_bytes_in_flight()) {
+               if (!conn->verify_max_bytes_in_flight() || !my->verify_queue_delay(conn)) {
                   return;
                }
 
-               url_response_callback wrapped_then = [tracked_b, then=std::move(then)](int code, std::optional<fc::variant> resp) {
+               url_response_callback wrapped_then = [tracked_b, then=std::move(then)](int code, std::optional<response_body> resp) {
                   then(code, std::move(resp));
                };
 
-               // post to the app thread taking shared ownership of next (via std::shared_ptr),
+               // queue taking shared ownership of next (via std::shared_ptr),
                // sole ownership of the tracked body and the passed in parameters
-               app().post( priority, [next_ptr, conn=std::move(conn), r=std::move(r), tracked_b, wrapped_then=std::move(wrapped_then)]() mutable {
+               const string address = conn->remote_address();
+               queue->push( address, [my, next_ptr, conn=std::move(conn), r=std::move(r), tracked_b, wrapped_then=std::move(wrapped_then)]() mutable {
+                  const auto start = fc::time_point::now();
                   try {
                      // call the `next` url_handler and wrap the response handler
                      (*next_ptr)( std::move( r ), std::move(tracked_b->obj()), std::move(wrapped_then)) ;
                   } catch( ... ) {
                      conn->handle_exception();
                   }
+                  my->app_queue_delay.record_run_time( ( fc::time_point::now() - start ).count() );
+               } );
+
+               // one post per queued request, each runs the request whose turn it is so that a client sending many
+               // requests gets one through per round instead of filling the app queue ahead of everyone else
+               my->app_queue_delay.push();
+               app().post( priority, [my, queue]() {
+                  my->app_queue_delay.pop();
+                  if( auto request = queue->pop() )
+                     (*request)();
                } );
             };
          }
@@ -575,8 +890,8 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
           * @return lambda suitable for url_response_callback
           */
          template<typename T>
-         auto make_http_response_handler( const detail::abstract_conn_ptr& abstract_conn_ptr) {
-            return [my=shared_from_this(), abstract_conn_ptr]( int code, std::optional<fc::variant> response ) {
+         auto make_http_response_handler( const detail::abstract_conn_ptr& abstract_conn_ptr, std::optional<string> cache_key ) {
+            return [my=shared_from_this(), abstract_conn_ptr, cache_key=std::move(cache_key)]( int code, std::optional<response_body> response ) {
                auto tracked_response = make_in_flight(std::move(response), my);
                if (!abstract_conn_ptr->verify_max_bytes_in_flight()) {
                   return;
@@ -584,10 +899,26 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
 
                // post  back to an HTTP thread to to allow the response handler to be called from any thread
                boost::asio::post( my->thread_pool->get_executor(),
-                                  [my, abstract_conn_ptr, code, tracked_response=std::move(tracked_response)]() {
+                                  [my, abstract_conn_ptr, code, cache_key, tracked_response=std::move(tracked_response)]() {
                   try {
                      if( tracked_response->obj().has_value() ) {
-                        std::string json = fc::json::to_string( *tracked_response->obj(), fc::time_point::now() + my->max_response_time );
+                        if( auto* body = std::get_if<chunked_body>( &*tracked_response->obj() ) ) {
+                           if( cache_key && code == websocketpp::http::status_code::ok && body->immutable )
+                              body->next = my->cache_chunked_response( *cache_key, std::move( body->next ) );
+                           // the first piece is created before any headers are sent, its errors are reported as usual
+                           std::string first;
+                           bool more = body->next( first );
+                           abstract_conn_ptr->send_chunked_response( std::move( first ), more, std::move( *body ), code );
+                           return;
+                        }
+                        std::string json;
+                        if( auto* body = std::get_if<json_body>( &*tracked_response->obj() ) ) {
+                           json = std::move( body->json );
+                           if( cache_key && code == websocketpp::http::status_code::ok && body->immutable )
+                              my->response_cache.put( *cache_key, std::make_shared<const string>( json ), json.size() + cache_key->size() );
+                        } else {
+                           json = fc::json::to_string( std::get<fc::variant>( *tracked_response->obj() ), fc::time_point::now() + my->max_response_time );
+                        }
                         auto tracked_json = make_in_flight( std::move( json ), my );
                         abstract_conn_ptr->send_response( std::move( tracked_json->obj() ), code );
                      } else {
@@ -635,8 +966,16 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
                std::string resource = con->get_uri()->get_resource();
                auto handler_itr = url_handlers.find( resource );
                if( handler_itr != url_handlers.end()) {
+                  if( !verify_rate_limit<T>( con, resource ) ) return;
                   std::string body = con->get_request_body();
-                  handler_itr->second( abstract_conn_ptr, std::move( resource ), std::move( body ), make_http_response_handler<T>(abstract_conn_ptr) );
+                  auto cache_key = response_cache_key( resource, body );
+                  if( cache_key ) {
+                     if( auto cached = response_cache.get( *cache_key ) ) {
+                        abstract_conn_ptr->send_cached_response( *cache_key, std::move( *cached ) );
+                        return;
+                     }
+                  }
+                  handler_itr->second( abstract_conn_ptr, std::move( resource ), std::move( body ), make_http_response_handler<T>(abstract_conn_ptr, std::move( cache_key )) );
                } else {
                   fc_dlog( logger, "404 - not found: ${ep}", ("ep", resource) );
                   error_results results{websocketpp::http::status_code::not_found,
@@ -682,6 +1021,12 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
       return true;
    }
 
+   // local clients are not rate limited
+   template<>
+   string http_plugin_impl::remote_address<detail::asio_local_with_stub_log>(const detail::connection_ptr<detail::asio_local_with_stub_log>& con) {
+      return {};
+   }
+
    http_plugin::http_plugin():my(new http_plugin_impl()){
       app().register_config_type<https_ecdh_curve_t>();
    }
@@ -756,6 +1101,10 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
              "Maximum number of requests http_plugin should use for processing http requests. 429 error response when exceeded." )
             ("http-max-response-time-ms", bpo::value<uint32_t>()->default_value(30),
              "Maximum time for processing a request.")
+            ("http-rate-limit-per-ip", bpo::value<uint32_t>()->default_value(0),
+             "Maximum sustained number of requests per second to rate limited endpoints (such as push_transaction) from a single remote IP address, 0 to disable. 429 error response when exceeded.")
+            ("http-rate-limit-burst-per-ip", bpo::value<uint32_t>()->default_value(0),
+             "Number of requests a remote IP address may send in a burst above http-rate-limit-per-ip. Defaults to the rate when 0.")
             ("verbose-http-errors", bpo::bool_switch()->default_value(false),
              "Append the error log to HTTP responses")
             ("http-validate-host", boost::program_options::value<bool>()->default_value(true),
@@ -764,6 +1113,14 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
              "Additionaly acceptable values for the \"Host\" header of incoming HTTP requests, can be specified multiple times.  Includes http/s_server_address by default.")
             ("http-threads", bpo::value<uint16_t>()->default_value( my->thread_pool_size ),
              "Number of worker threads in http thread pool")
+            ("http-max-queue-delay-ms", bpo::value<uint32_t>()->default_value(0),
+             "Maximum predicted wait in milliseconds of a request for the main thread, from the number of queued requests and their average run time. 503 error response when exceeded, 0 to disable.")
+            ("http-compression-level", bpo::value<int>()->default_value( my->compression_level ),
+             "gzip/deflate compression level, 1 (fastest) to 9 (smallest), of responses to requests that accept it. 0 disables compression. Compression is done on the http thread pool.")
+            ("http-compression-min-size", bpo::value<uint32_t>()->default_value( my->compression_min_size ),
+             "Minimum size in bytes of a response body to compress it.")
+            ("http-response-cache-size-mb", bpo::value<uint32_t>()->default_value(0),
+             "Maximum size in megabytes of the cache of responses that never change, such as get_block_info of irreversible blocks. Compressed responses are cached as well. Served from the http thread pool. 0 disables the cache.")
             ;
    }
 
@@ -779,6 +1136,18 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
          my->max_bytes_in_flight = options.at( "http-max-bytes-in-flight-mb" ).as<uint32_t>() * 1024 * 1024;
          my->max_requests_in_flight = options.at( "http-max-in-flight-requests" ).as<int32_t>();
          my->max_response_time = fc::microseconds( options.at("http-max-response-time-ms").as<uint32_t>() * 1000 );
+         my->max_queue_delay = fc::milliseconds( options.at( "http-max-queue-delay-ms" ).as<uint32_t>() );
+         my->compression_level = options.at( "http-compression-level" ).as<int>();
+         EOS_ASSERT( my->compression_level >= 0 && my->compression_level <= 9, chain::plugin_config_exception,
+                     "http-compression-level ${l} must be between 0 and 9", ("l", my->compression_level));
+         my->compression_min_size = options.at( "http-compression-min-size" ).as<uint32_t>();
+         my->response_cache_size = size_t( options.at( "http-response-cache-size-mb" ).as<uint32_t>() ) * 1024 * 1024;
+         my->response_cache.set_max_bytes( my->response_cache_size );
+         {
+            const auto rate = options.at( "http-rate-limit-per-ip" ).as<uint32_t>();
+            const auto burst = options.at( "http-rate-limit-burst-per-ip" ).as<uint32_t>();
+            my->ip_limiter.configure( rate, burst > 0 ? burst : rate );
+         }
          
          my->validate_host = options.at("http-validate-host").as<bool>();
          if( options.count( "http-alias" )) {
@@ -931,6 +1300,20 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
                   }
                }
             }});
+
+            if (my->response_cache.enabled()) {
+               add_async_api({{
+                  std::string("/v1/node/get_response_cache_stats"),
+                  [&](const string&, string body, url_response_callback cb) mutable {
+                     try {
+                        auto result = (*this).get_response_cache_stats();
+                        cb(200, fc::variant(result));
+                     } catch (...) {
+                        handle_exception("node", "get_response_cache_stats", body, cb);
+                     }
+                  }
+               }});
+            }
          } catch (...) {
             fc_elog(logger, "http_plugin startup fails, shutting down");
             app().shutdown();
@@ -971,6 +1354,14 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
       my->url_handlers[url] = my->make_http_thread_url_handler(handler);
    }
 
+   void http_plugin::add_cached_url(const string& url) {
+      my->cached_urls.insert(url);
+   }
+
+   void http_plugin::add_rate_limited_url(const string& url) {
+      my->rate_limited_urls.insert(url);
+   }
+
    void http_plugin::handle_exception( const char *api_name, const char *call_name, const string& body, url_response_callback cb ) {
       try {
          try {
@@ -1038,6 +1429,11 @@ class http_plugin_impl : public std::enable_shared_from_this<http_plugin_impl> {
       return result;
    }
 
+   http_plugin::get_response_cache_stats_result http_plugin::get_response_cache_stats()const {
+      const auto stats = my->response_cache.get_stats();
+      return { stats.hits, stats.misses, stats.entries, stats.bytes };
+   }
+
    fc::microseconds http_plugin::get_max_response_time()const {
       return my->max_response_time;
    }
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <boost/algorithm/string.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace detail {
+
+   enum class content_encoding {
+      identity,
+      gzip,
+      deflate
+   };
+
+   inline const char* to_string( content_encoding e ) {
+      switch( e ) {
+         case content_encoding::gzip:     return "gzip";
+         case content_encoding::deflate:  return "deflate";
+         case content_encoding::identity: break;
+      }
+      return "identity";
+   }
+
+   /**
+    * Helper method to pick the compression of a response from the Accept-Encoding header of its request
+    *
+    * A coding named in the header gets its own q value, a coding not named gets the q value of "*" if present.
+    * So "gzip;q=0, *" refuses gzip and accepts deflate.
+    * @param accept_encoding - the Accept-Encoding header, e.g. "deflate, gzip;q=1.0, *;q=0.5"
+    * @return the acceptable one of gzip and deflate with the higher q value, gzip on a tie, else identity
+    */
+   inline content_encoding select_content_encoding( const std::string& accept_encoding ) {
+      std::optional<double> gzip_q;
+      std::optional<double> deflate_q;
+      std::optional<double> any_q;
+      std::vector<std::string> codings;
+      boost::algorithm::split( codings, accept_encoding, boost::algorithm::is_any_of( "," ) );
+      for( auto& coding : codings ) {
+         double q = 1.0;
+         auto semi = coding.find( ';' );
+         if( semi != std::string::npos ) {
+            auto q_pos = coding.find( "q=", semi );
+            if( q_pos != std::string::npos )
+               q = std::strtod( coding.c_str() + q_pos + 2, nullptr );
+            coding.resize( semi );
+         }
+         boost::algorithm::trim( coding );
+         boost::algorithm::to_lower( coding );
+         if( coding == "gzip" || coding == "x-gzip" )
+            gzip_q = q;
+         else if( coding == "deflate" )
+            deflate_q = q;
+         else if( coding == "*" )
+            any_q = q;
+      }
+      const double gzip = gzip_q.value_or( any_q.value_or( 0 ) );
+      const double deflate = deflate_q.value_or( any_q.value_or( 0 ) );
+      if( gzip > 0 && gzip >= deflate )
+         return content_encoding::gzip;
+      if( deflate > 0 )
+         return content_encoding::deflate;
+      return content_encoding::identity;
+   }
+
+   /**
+    * Compresses a response body that is written in one or more pieces
+    */
+   class response_compressor {
+   public:
+      response_compressor( content_encoding encoding, int level ) {
+         namespace bio = boost::iostreams;
+         if( encoding == content_encoding::gzip ) {
+            _stream.push( bio::gzip_compressor( bio::gzip_params( level ) ) );
+         } else {
+            _stream.push( bio::zlib_compressor( bio::zlib_params( level ) ) );
+         }
+         _stream.push( bio::back_inserter( _out ) );
+      }
+
+      /// @return the compressed bytes available so far, possibly none
+      std::string write( const std::string& in ) {
+         _stream.write( in.data(), in.size() );
+         return take();
+      }
+
+      /// ends the compressed stream
+      /// @return the remaining compressed bytes
+      std::string finish() {
+         boost::iostreams::close( _stream );
+         return take();
+      }
+
+   private:
+      std::string take() {
+         std::string result;
+         result.swap( _out );
+         return result;
+      }
+
+      std::string                             _out;
+      boost::iostreams::filtering_ostream     _stream;
+   };
+
+} } // eosio::detail
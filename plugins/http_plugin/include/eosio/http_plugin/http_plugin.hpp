@@ -5,16 +5,51 @@
 #include <fc/io/json.hpp>
 #include <eosio/chain/exceptions.hpp>
 
+#include <functional>
+#include <optional>
+#include <variant>
+
 namespace eosio {
    using namespace appbase;
 
+   /**
+    * @brief A response body the handler already serialized to JSON
+    *
+    * Sent as is, for handlers that write large responses directly instead of
+    * building an fc::variant that is then serialized.
+    */
+   struct json_body {
+      std::string json;
+      /// the request always gets this response, it is cached for urls added with add_cached_url
+      bool immutable = false;
+   };
+
+   /**
+    * @brief JSON response body created in pieces
+    *
+    * Each call of next appends the next piece to out and returns false after the last one. Pieces are sent as
+    * they are created using chunked transfer encoding, so that a large response is never held in memory at once.
+    * next is called on the http thread pool and must not access chain state. An error in the first piece is
+    * reported as usual. An error in a later one aborts the connection without the terminating chunk, so that the
+    * client sees an incomplete response.
+    */
+   struct chunked_body {
+      std::function<bool(std::string& out)> next;
+      /// same as json_body::immutable
+      bool immutable = false;
+      /// memory held by next for the pieces still to come, counted in http-max-bytes-in-flight until they are sent
+      size_t held_bytes = 0;
+   };
+
+   using response_body = std::variant<fc::variant, json_body, chunked_body>;
+
    /**
     * @brief A callback function provided to a URL handler to
     * allow it to specify the HTTP response code and body
     *
     * Arguments: response_code, response_body
     */
-   using url_response_callback = std::function<void(int,std::optional<fc::variant>)>;
+   using url_response_callback = std::function<void(int,std::optional<response_body>)>;
 
    /**
     * @brief Callback type for a URL handler
@@ -90,6 +125,13 @@ namespace eosio {
               add_async_handler(call.first, call.second);
         }
 
+        /// subject url to the http-rate-limit-per-ip limit, must be called before plugin_startup
+        void add_rate_limited_url(const string& url);
+
+        /// cache the immutable responses of url in the http-response-cache-size-mb cache, must be called before
+        /// plugin_startup. Entries are keyed by url and request body.
+        void add_cached_url(const string& url);
+
         // standard exception handling for api handlers
         static void handle_exception( const char *api_name, const char *call_name, const string& body, url_response_callback cb );
 
@@ -104,6 +146,15 @@ namespace eosio {
 
         get_supported_apis_result get_supported_apis()const;
 
+        struct get_response_cache_stats_result {
+           uint64_t hits = 0;
+           uint64_t misses = 0;
+           uint64_t entries = 0;
+           uint64_t bytes = 0;
+        };
+
+        get_response_cache_stats_result get_response_cache_stats()const;
+
         /// @return the configured http-max-response-time-ms
         fc::microseconds get_max_response_time()const;
 
@@ -251,3 +302,4 @@ FC_REFLECT(eosio::error_results::error_info::error_detail, (message)(file)(line_
 FC_REFLECT(eosio::error_results::error_info, (code)(name)(what)(details))
 FC_REFLECT(eosio::error_results, (code)(message)(error))
 FC_REFLECT(eosio::http_plugin::get_supported_apis_result, (apis))
+FC_REFLECT(eosio::http_plugin::get_response_cache_stats_result, (hits)(misses)(entries)(bytes))
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace eosio { namespace detail {
+
+   /**
+    * Predicts how long a request waits in a queue served by one thread, from the number of queued requests and
+    * the moving average of their run times.
+    *
+    * The average is exponentially weighted, each run time counts 1/8. It is kept in 1/256 microseconds, so that
+    * integer division does not hold it below run times of a few microseconds.
+    */
+   class queue_delay_predictor {
+   public:
+      /// thread safe, a request was queued
+      void push() { ++_queued; }
+
+      /// thread safe, a queued request was taken from the queue
+      void pop() { --_queued; }
+
+      /// called only by the thread serving the queue once a request ran for run_time_us
+      void record_run_time( int64_t run_time_us ) {
+         const int64_t avg = _avg_run_time.load( std::memory_order_relaxed );
+         _avg_run_time.store( avg + ( run_time_us * fraction - avg ) / weight, std::memory_order_relaxed );
+      }
+
+      /// thread safe
+      int64_t average_run_time_us() const {
+         return _avg_run_time.load( std::memory_order_relaxed ) / fraction;
+      }
+
+      /// thread safe @return predicted wait of a request queued now, before it starts to run
+      int64_t predicted_delay_us() const {
+         return _queued.load( std::memory_order_relaxed ) * _avg_run_time.load( std::memory_order_relaxed ) / fraction;
+      }
+
+   private:
+      static constexpr int64_t fraction = 256;
+      static constexpr int64_t weight = 8;
+
+      std::atomic<int64_t> _queued{0};
+      std::atomic<int64_t> _avg_run_time{0}; // in 1/fraction microseconds
+   };
+
+} } // eosio::detail
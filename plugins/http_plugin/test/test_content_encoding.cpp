@@ -0,0 +1,82 @@
+#define BOOST_TEST_MODULE content_encoding
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/http_plugin/content_encoding.hpp>
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+
+using namespace eosio::detail;
+
+namespace {
+
+std::string decompress( content_encoding encoding, const std::string& in ) {
+   namespace bio = boost::iostreams;
+   bio::filtering_istream s;
+   if( encoding == content_encoding::gzip )
+      s.push( bio::gzip_decompressor() );
+   else
+      s.push( bio::zlib_decompressor() );
+   s.push( bio::array_source( in.data(), in.size() ) );
+   std::string out;
+   bio::copy( s, bio::back_inserter( out ) );
+   return out;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(content_encoding_tests)
+
+BOOST_AUTO_TEST_CASE(select_content_encoding_test) {
+   BOOST_TEST( to_string( select_content_encoding( "" ) ) == "identity" );
+   BOOST_TEST( to_string( select_content_encoding( "gzip" ) ) == "gzip" );
+   BOOST_TEST( to_string( select_content_encoding( "x-gzip" ) ) == "gzip" );
+   BOOST_TEST( to_string( select_content_encoding( "deflate" ) ) == "deflate" );
+   BOOST_TEST( to_string( select_content_encoding( "br, identity" ) ) == "identity" );
+   BOOST_TEST( to_string( select_content_encoding( "deflate, gzip" ) ) == "gzip" );
+   BOOST_TEST( to_string( select_content_encoding( " GZIP ; q=0.5, Deflate" ) ) == "deflate" );
+   BOOST_TEST( to_string( select_content_encoding( "deflate;q=0.5, gzip;q=0.8" ) ) == "gzip" );
+   BOOST_TEST( to_string( select_content_encoding( "gzip;q=0, deflate" ) ) == "deflate" );
+   BOOST_TEST( to_string( select_content_encoding( "gzip;q=0, deflate;q=0" ) ) == "identity" );
+
+   // the wildcard covers the codings not named
+   BOOST_TEST( to_string( select_content_encoding( "*" ) ) == "gzip" );
+   BOOST_TEST( to_string( select_content_encoding( "*;q=0" ) ) == "identity" );
+   BOOST_TEST( to_string( select_content_encoding( "gzip;q=0, *" ) ) == "deflate" );
+   BOOST_TEST( to_string( select_content_encoding( "*, gzip;q=0" ) ) == "deflate" );
+   BOOST_TEST( to_string( select_content_encoding( "gzip;q=0, deflate;q=0, *" ) ) == "identity" );
+   BOOST_TEST( to_string( select_content_encoding( "deflate, *;q=0" ) ) == "deflate" );
+   BOOST_TEST( to_string( select_content_encoding( "deflate, *;q=0.5" ) ) == "deflate" );
+}
+
+BOOST_AUTO_TEST_CASE(response_compressor_round_trip) {
+   std::string body;
+   for( int i = 0; i < 10000; ++i )
+      body += "{\"row\":" + std::to_string( i ) + "},";
+
+   for( auto encoding : { content_encoding::gzip, content_encoding::deflate } ) {
+      BOOST_TEST_CONTEXT( to_string( encoding ) ) {
+         // in one piece
+         response_compressor whole( encoding, 6 );
+         std::string compressed = whole.write( body );
+         compressed += whole.finish();
+         BOOST_TEST( compressed.size() < body.size() );
+         BOOST_TEST( decompress( encoding, compressed ) == body );
+
+         // in pieces, as a chunked response
+         response_compressor pieces( encoding, 1 );
+         compressed.clear();
+         for( size_t pos = 0; pos < body.size(); pos += 1000 )
+            compressed += pieces.write( body.substr( pos, 1000 ) );
+         compressed += pieces.finish();
+         BOOST_TEST( decompress( encoding, compressed ) == body );
+
+         // empty body
+         response_compressor empty( encoding, 6 );
+         compressed = empty.finish();
+         BOOST_TEST( decompress( encoding, compressed ).empty() );
+      }
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
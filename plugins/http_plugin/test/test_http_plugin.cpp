@@ -0,0 +1,323 @@
+#define BOOST_TEST_MODULE http_plugin
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/http_plugin/http_plugin.hpp>
+
+#include <appbase/application.hpp>
+
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <atomic>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+using namespace eosio;
+namespace bfs = boost::filesystem;
+namespace asio = boost::asio;
+
+constexpr const char* max_bytes_in_flight_mb = "1";
+
+/// runs the http_plugin listening on a unix socket in a temporary data dir for all of the tests
+struct http_plugin_fixture {
+   http_plugin_fixture() {
+      std::promise<void> started;
+      app_thread = std::thread( [&]() {
+         std::vector<const char*> argv =
+               {"test", "--data-dir", temp.c_str(), "--config-dir", temp.c_str(),
+                "--http-server-address", "", "--unix-socket-path", "http.sock",
+                "--http-max-bytes-in-flight-mb", max_bytes_in_flight_mb, "--http-response-cache-size-mb", "1",
+                "--http-max-queue-delay-ms", "50"};
+         appbase::app().initialize<http_plugin>( argv.size(), (char**) &argv[0] );
+         register_handlers( appbase::app().get_plugin<http_plugin>() );
+         appbase::app().startup();
+         started.set_value();
+         appbase::app().exec();
+      } );
+      started.get_future().wait();
+   }
+
+   ~http_plugin_fixture() {
+      appbase::app().quit();
+      app_thread.join();
+      bfs::remove_all( temp );
+   }
+
+   static void register_handlers( http_plugin& http ) {
+      // run on the app thread
+      http.add_handler( "/v1/test/slow", []( string, string, url_response_callback cb ) {
+         std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+         cb( 200, fc::variant( "slow" ) );
+      } );
+      http.add_async_handler( "/v1/test/small", []( string, string, url_response_callback cb ) {
+         cb( 200, fc::variant( "small" ) );
+      } );
+      http.add_async_handler( "/v1/test/chunked", []( string, string, url_response_callback cb ) {
+         auto n = std::make_shared<int>( 0 );
+         cb( 200, chunked_body{ [n]( std::string& out ) {
+            out += *n == 0 ? "[" : ",";
+            out += std::to_string( ++*n );
+            if( *n < 3 )
+               return true;
+            out += "]";
+            return false;
+         } } );
+      } );
+      http.add_async_handler( "/v1/test/chunked_error", []( string, string, url_response_callback cb ) {
+         auto n = std::make_shared<int>( 0 );
+         cb( 200, chunked_body{ [n]( std::string& out ) {
+            if( ++*n > 1 )
+               throw std::runtime_error( "failed piece" );
+            out += "[1";
+            return true;
+         } } );
+      } );
+      // the response tells how often the handler was called, it is immutable unless the request has "mutable"
+      http.add_async_handler( "/v1/test/cached", []( string, string body, url_response_callback cb ) {
+         cb( 200, json_body{ "{\"call\":" + std::to_string( ++calls ) + ",\"pad\":\"" + std::string( 2000, 'x' ) + "\"}",
+                             body.find( "mutable" ) == std::string::npos } );
+      } );
+      http.add_async_handler( "/v1/test/cached_chunked", []( string, string, url_response_callback cb ) {
+         auto n = std::make_shared<int>( 0 );
+         cb( 200, chunked_body{ [n, call=++calls]( std::string& out ) {
+            out += ++*n == 1 ? "[" + std::to_string( call ) : ",2]";
+            return *n == 1;
+         }, true } );
+      } );
+      http.add_cached_url( "/v1/test/cached" );
+      http.add_cached_url( "/v1/test/cached_chunked" );
+      http.add_async_handler( "/v1/test/chunked_held", []( string, string, url_response_callback cb ) {
+         cb( 200, chunked_body{ []( std::string& out ) {
+            out += "[]";
+            return false;
+         }, false, 2 * 1024 * 1024 } ); // over max_bytes_in_flight_mb
+      } );
+   }
+
+   bfs::path temp = bfs::temp_directory_path() / bfs::unique_path();
+   std::thread app_thread;
+   static inline std::atomic<int> calls = 0;
+};
+
+BOOST_TEST_GLOBAL_FIXTURE( http_plugin_fixture );
+
+struct http_response {
+   std::string status_line;
+   std::string headers;
+   std::string body;
+
+   bool has_header( const std::string& header ) const {
+      return headers.find( "\r\n" + header + "\r\n" ) != std::string::npos;
+   }
+};
+
+using socket_type = asio::local::stream_protocol::socket;
+
+/// sends a request for url over the unix socket
+socket_type send_request( const std::string& url, const std::string& body = "", const std::string& headers = "",
+                          const std::string& version = "HTTP/1.1" ) {
+   static asio::io_context ctx; // only synchronous operations, never run
+   const auto sock_path = ( appbase::app().data_dir() / "http.sock" ).string();
+   socket_type s( ctx );
+   // the socket is opened by a task the plugin posts on startup
+   for( int i = 0; ; ++i ) {
+      boost::system::error_code ec;
+      s.connect( asio::local::stream_protocol::endpoint( sock_path ), ec );
+      if( !ec )
+         break;
+      BOOST_REQUIRE_MESSAGE( i < 100, "cannot connect to " << sock_path << ": " << ec.message() );
+      s.close();
+      std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+   }
+   const std::string req = "POST " + url + " " + version + "\r\nHost: localhost\r\n" + headers +
+                           "Content-Length: " + std::to_string( body.size() ) + "\r\n\r\n" + body;
+   asio::write( s, asio::buffer( req ) );
+   return s;
+}
+
+/// reads everything until the server ends the connection
+http_response read_response( socket_type& s ) {
+   std::string raw;
+   boost::system::error_code ec;
+   asio::read( s, asio::dynamic_buffer( raw ), ec ); // eof, or a reset when the response is aborted
+   BOOST_REQUIRE( ec == asio::error::eof || ec == asio::error::connection_reset );
+
+   http_response r;
+   const auto status_end = raw.find( "\r\n" );
+   const auto headers_end = raw.find( "\r\n\r\n" );
+   BOOST_REQUIRE( status_end != std::string::npos && headers_end != std::string::npos );
+   r.status_line = raw.substr( 0, status_end );
+   r.headers = raw.substr( status_end, headers_end + 2 - status_end );
+   r.body = raw.substr( headers_end + 4 );
+   return r;
+}
+
+http_response request( const std::string& url, const std::string& body = "", const std::string& headers = "",
+                       const std::string& version = "HTTP/1.1" ) {
+   auto s = send_request( url, body, headers, version );
+   return read_response( s );
+}
+
+std::string decompress_gzip( const std::string& in ) {
+   namespace bio = boost::iostreams;
+   bio::filtering_istream s;
+   s.push( bio::gzip_decompressor() );
+   s.push( bio::array_source( in.data(), in.size() ) );
+   std::string out;
+   bio::copy( s, bio::back_inserter( out ) );
+   return out;
+}
+
+/// @return the body of a chunked response, or nothing if the terminating chunk is missing
+std::optional<std::string> decode_chunked( const std::string& raw ) {
+   std::string body;
+   size_t pos = 0;
+   while( true ) {
+      const auto size_end = raw.find( "\r\n", pos );
+      if( size_end == std::string::npos )
+         return {};
+      const size_t size = std::stoul( raw.substr( pos, size_end - pos ), nullptr, 16 );
+      if( size == 0 )
+         return raw.compare( size_end, 4, "\r\n\r\n" ) == 0 ? std::optional<std::string>( body ) : std::nullopt;
+      if( raw.size() < size_end + 2 + size + 2 )
+         return {};
+      body += raw.substr( size_end + 2, size );
+      pos = size_end + 2 + size + 2;
+   }
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(http_plugin_tests)
+
+BOOST_AUTO_TEST_CASE(chunked_response) {
+   auto r = request( "/v1/test/chunked" );
+   BOOST_TEST( r.status_line == "HTTP/1.1 200 OK" );
+   BOOST_TEST( r.has_header( "Transfer-Encoding: chunked" ) );
+   BOOST_TEST( decode_chunked( r.body ).value_or( "incomplete" ) == "[1,2,3]" );
+}
+
+BOOST_AUTO_TEST_CASE(chunked_response_http_1_0) {
+   // sent as one body, chunked encoding is HTTP/1.1 only
+   auto r = request( "/v1/test/chunked", "", "", "HTTP/1.0" );
+   BOOST_TEST( r.status_line.substr( r.status_line.find( ' ' ) ) == " 200 OK" );
+   BOOST_TEST( !r.has_header( "Transfer-Encoding: chunked" ) );
+   BOOST_TEST( r.has_header( "Content-Length: 7" ) );
+   BOOST_TEST( r.body == "[1,2,3]" );
+}
+
+BOOST_AUTO_TEST_CASE(chunked_response_error) {
+   // the status is sent with the first piece, an error in a later one must not look like a complete response
+   auto r = request( "/v1/test/chunked_error" );
+   BOOST_TEST( r.status_line == "HTTP/1.1 200 OK" );
+   BOOST_TEST( r.has_header( "Transfer-Encoding: chunked" ) );
+   BOOST_TEST( r.body.find( "[1" ) != std::string::npos );
+   BOOST_TEST( !decode_chunked( r.body ).has_value() );
+
+   // the server goes on after the aborted response
+   BOOST_TEST( decode_chunked( request( "/v1/test/chunked" ).body ).value_or( "incomplete" ) == "[1,2,3]" );
+}
+
+BOOST_AUTO_TEST_CASE(chunked_response_held_bytes) {
+   // what next holds for the pieces still to come counts in http-max-bytes-in-flight-mb
+   auto r = request( "/v1/test/chunked_held" );
+   BOOST_TEST( r.status_line.find( " 429 " ) != std::string::npos );
+   BOOST_TEST( decode_chunked( request( "/v1/test/chunked" ).body ).value_or( "incomplete" ) == "[1,2,3]" );
+}
+
+BOOST_AUTO_TEST_CASE(vary_accept_encoding) {
+   // too small to compress, but a larger response of the same url would be
+   auto r = request( "/v1/test/small", "", "Accept-Encoding: gzip\r\n" );
+   BOOST_TEST( r.status_line == "HTTP/1.1 200 OK" );
+   BOOST_TEST( r.has_header( "Vary: Accept-Encoding" ) );
+   BOOST_TEST( r.headers.find( "Content-Encoding" ) == std::string::npos );
+   BOOST_TEST( r.body == "\"small\"" );
+}
+
+BOOST_AUTO_TEST_CASE(response_cache) {
+   // requests that only differ in whitespace and member order get the cached response
+   const auto first = request( "/v1/test/cached", R"({"a":1,"b":[1,2]})" );
+   BOOST_TEST( first.status_line == "HTTP/1.1 200 OK" );
+   BOOST_TEST( request( "/v1/test/cached", R"({"a":1,"b":[1,2]})" ).body == first.body );
+   BOOST_TEST( request( "/v1/test/cached", R"( { "b" : [ 1, 2 ], "a" : 1 } )" ).body == first.body );
+   BOOST_TEST( request( "/v1/test/cached", R"({"a":2,"b":[1,2]})" ).body != first.body );
+
+   // responses that are not immutable are not cached
+   const auto not_immutable = request( "/v1/test/cached", R"({"mutable":true})" );
+   BOOST_TEST( request( "/v1/test/cached", R"({"mutable":true})" ).body != not_immutable.body );
+}
+
+BOOST_AUTO_TEST_CASE(response_cache_chunked) {
+   // the pieces of a chunked response are collected, a cache hit sends them as one body
+   auto first = request( "/v1/test/cached_chunked" );
+   BOOST_TEST( first.has_header( "Transfer-Encoding: chunked" ) );
+   const auto body = decode_chunked( first.body ).value_or( "incomplete" );
+   BOOST_TEST( body.find( ",2]" ) != std::string::npos );
+   auto cached = request( "/v1/test/cached_chunked" );
+   BOOST_TEST( !cached.has_header( "Transfer-Encoding: chunked" ) );
+   BOOST_TEST( cached.body == body );
+}
+
+BOOST_AUTO_TEST_CASE(response_cache_encoded) {
+   auto& http = appbase::app().get_plugin<http_plugin>();
+   const std::string req = R"({"encoded":true})";
+   const std::string gzip = "Accept-Encoding: gzip\r\n";
+
+   const auto first = request( "/v1/test/cached", req, gzip );
+   BOOST_TEST( first.has_header( "Content-Encoding: gzip" ) );
+   const auto json = decompress_gzip( first.body );
+   const auto entries = http.get_response_cache_stats().entries;
+
+   // the first hit compresses the cached response and keeps it compressed, the next one sends it as is
+   const auto hit = request( "/v1/test/cached", req, gzip );
+   BOOST_TEST( hit.has_header( "Content-Encoding: gzip" ) );
+   BOOST_TEST( decompress_gzip( hit.body ) == json );
+   BOOST_TEST( http.get_response_cache_stats().entries == entries + 1 );
+   BOOST_TEST( request( "/v1/test/cached", req, gzip ).body == hit.body );
+   BOOST_TEST( http.get_response_cache_stats().entries == entries + 1 );
+
+   // and still has it uncompressed
+   const auto identity = request( "/v1/test/cached", req );
+   BOOST_TEST( identity.headers.find( "Content-Encoding" ) == std::string::npos );
+   BOOST_TEST( identity.body == json );
+}
+
+BOOST_AUTO_TEST_CASE(queue_delay_shedding) {
+   // each request keeps the app thread busy for 100ms, the average run time grows towards it
+   for( int i = 0; i < 8; ++i )
+      BOOST_TEST( request( "/v1/test/slow" ).status_line == "HTTP/1.1 200 OK" );
+
+   // the first one runs, the second one is predicted to wait 0ms behind it as the running request is not counted,
+   // the others are predicted to wait over the 50ms of http-max-queue-delay-ms
+   std::vector<socket_type> sockets;
+   for( int i = 0; i < 6; ++i )
+      sockets.push_back( send_request( "/v1/test/slow" ) );
+   size_t ok = 0;
+   size_t busy = 0;
+   for( auto& s : sockets ) {
+      const auto r = read_response( s );
+      if( r.status_line == "HTTP/1.1 200 OK" )
+         ++ok;
+      else if( r.status_line.find( " 503 " ) != std::string::npos && r.body.find( "Busy" ) != std::string::npos )
+         ++busy;
+   }
+   BOOST_TEST( ok >= 1u );
+   BOOST_TEST( busy >= 1u );
+   BOOST_TEST( ok + busy == sockets.size() );
+
+   // accepted again once the queue is empty
+   BOOST_TEST( request( "/v1/test/slow" ).status_line == "HTTP/1.1 200 OK" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
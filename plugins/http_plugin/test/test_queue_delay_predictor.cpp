@@ -0,0 +1,54 @@
+#define BOOST_TEST_MODULE queue_delay_predictor
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/http_plugin/queue_delay_predictor.hpp>
+
+using eosio::detail::queue_delay_predictor;
+
+BOOST_AUTO_TEST_SUITE(queue_delay_predictor_tests)
+
+BOOST_AUTO_TEST_CASE(average_run_time) {
+   queue_delay_predictor p;
+   BOOST_TEST( p.average_run_time_us() == 0 );
+
+   // converges to a constant run time, also one below the weight of the average
+   for( int64_t run_time : { 5, 1000, 3 } ) {
+      for( int i = 0; i < 200; ++i )
+         p.record_run_time( run_time );
+      BOOST_TEST( p.average_run_time_us() >= run_time - 1 );
+      BOOST_TEST( p.average_run_time_us() <= run_time );
+   }
+
+   // each run time counts 1/8
+   queue_delay_predictor q;
+   q.record_run_time( 800 );
+   BOOST_TEST( q.average_run_time_us() == 100 );
+   q.record_run_time( 800 );
+   BOOST_TEST( q.average_run_time_us() == 187 );
+}
+
+BOOST_AUTO_TEST_CASE(predicted_delay) {
+   queue_delay_predictor p;
+   for( int i = 0; i < 200; ++i )
+      p.record_run_time( 1000 );
+   BOOST_TEST( p.predicted_delay_us() == 0 );
+
+   for( int i = 0; i < 10; ++i )
+      p.push();
+   BOOST_TEST( p.predicted_delay_us() >= 9990 );
+   BOOST_TEST( p.predicted_delay_us() <= 10000 );
+   p.pop();
+   BOOST_TEST( p.predicted_delay_us() >= 8990 );
+   BOOST_TEST( p.predicted_delay_us() <= 9000 );
+
+   // run times of a few microseconds add up over a long queue
+   queue_delay_predictor fast;
+   for( int i = 0; i < 200; ++i )
+      fast.record_run_time( 4 );
+   for( int i = 0; i < 1000; ++i )
+      fast.push();
+   BOOST_TEST( fast.predicted_delay_us() >= 3900 );
+   BOOST_TEST( fast.predicted_delay_us() <= 4000 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,7 @@
 #include <eosio/chain/block.hpp>
 #include <eosio/chain/plugin_interface.hpp>
 #include <eosio/chain/thread_utils.hpp>
+#include <eosio/chain/token_bucket_limiter.hpp>
 #include <eosio/producer_plugin/producer_plugin.hpp>
 #include <eosio/chain/contract_types.hpp>
 
@@ -253,6 +254,7 @@ namespace eosio {
       uint32_t                              max_nodes_per_host = 1;
       bool                                  p2p_accept_transactions = true;
       fc::microseconds                      p2p_dedup_cache_expire_time_us{};
+      chain::token_bucket_limiter<string>   p2p_trx_ip_limiter; // thread safe, keyed by remote endpoint ip
 
       /// Peer clock may be no more than 1 second skewed from our clock, including network latency.
       const std::chrono::system_clock::duration peer_authentication_interval{std::chrono::seconds{1}};
@@ -2680,6 +2682,10 @@ namespace eosio {
          my_impl->producer_plug->log_failed_transaction(ptr->id(), ptr, reason);
          return true;
       }
+      if( !my_impl->p2p_trx_ip_limiter.try_consume( log_remote_endpoint_ip, fc::time_point::now() ) ) {
+         my_impl->producer_plug->log_failed_transaction(ptr->id(), ptr, "Dropping trx, peer exceeded p2p-trx-rate-limit-per-ip");
+         return true;
+      }
       bool have_trx = my_impl->dispatcher->have_txn( ptr->id() );
       my_impl->dispatcher->add_peer_txn( ptr->id(), ptr->expiration(), connection_id );
 
@@ -3537,6 +3543,10 @@ namespace eosio {
          ( "connection-cleanup-period", bpo::value<int>()->default_value(def_conn_retry_wait), "number of seconds to wait before cleaning up dead connections")
          ( "max-cleanup-time-msec", bpo::value<int>()->default_value(10), "max connection cleanup time per cleanup call in milliseconds")
          ( "p2p-dedup-cache-expire-time-sec", bpo::value<uint32_t>()->default_value(10), "Maximum time to track transaction for duplicate optimization")
+         ( "p2p-trx-rate-limit-per-ip", bpo::value<uint32_t>()->default_value(0),
+           "Maximum sustained number of transactions per second accepted from all peer connections of a single remote IP address, 0 to disable. Transactions above the limit are dropped.")
+         ( "p2p-trx-rate-limit-burst-per-ip", bpo::value<uint32_t>()->default_value(0),
+           "Number of transactions a remote IP address may send in a burst above p2p-trx-rate-limit-per-ip. Defaults to the rate when 0.")
          ( "net-threads", bpo::value<uint16_t>()->default_value(my->thread_pool_size),
            "Number of worker threads in net_plugin thread pool" )
          ( "sync-fetch-span", bpo::value<uint32_t>()->default_value(def_sync_fetch_span), "number of blocks to retrieve in a chunk from any individual peer during synchronization")
@@ -3573,6 +3583,11 @@ namespace eosio {
          my->max_cleanup_time_ms = options.at("max-cleanup-time-msec").as<int>();
          my->txn_exp_period = def_txn_expire_wait;
          my->p2p_dedup_cache_expire_time_us = fc::seconds( options.at( "p2p-dedup-cache-expire-time-sec" ).as<uint32_t>() );
+         {
+            const auto rate = options.at( "p2p-trx-rate-limit-per-ip" ).as<uint32_t>();
+            const auto burst = options.at( "p2p-trx-rate-limit-burst-per-ip" ).as<uint32_t>();
+            my->p2p_trx_ip_limiter.configure( rate, burst > 0 ? burst : rate );
+         }
          my->resp_expected_period = def_resp_expected_wait;
          my->max_client_count = options.at( "max-clients" ).as<int>();
          my->max_nodes_per_host = options.at( "p2p-max-nodes-per-host" ).as<int>();
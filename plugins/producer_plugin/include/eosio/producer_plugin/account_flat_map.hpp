@@ -0,0 +1,185 @@
+#pragma once
+
+#include <eosio/chain/types.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace eosio {
+
+/**
+ * Open-addressed (linear probing) hash table keyed by account name.
+ *
+ * Slots are stored contiguously so lookups touch at most a couple of cache lines, and erase uses
+ * backward-shift deletion so no tombstones accumulate under heavy insert/erase churn. Capacity is
+ * always a power of two and the table is kept at most half full.
+ *
+ * Iteration is by slot index, which allows callers to walk the table incrementally with a cursor
+ * (see erase_if_from) and spread maintenance work over many calls.
+ */
+template<typename Value>
+class account_flat_map {
+public:
+   using key_type   = chain::account_name;
+   using value_type = Value;
+
+   explicit account_flat_map( size_t min_capacity = default_min_capacity )
+   : _min_capacity( round_up_pow2( std::max<size_t>( min_capacity, 2 ) ) ) {
+      _slots.resize( _min_capacity );
+   }
+
+   size_t size() const     { return _size; }
+   bool   empty() const    { return _size == 0; }
+   size_t capacity() const { return _slots.size(); }
+
+   const Value* find( const key_type& k ) const {
+      const size_t mask = _slots.size() - 1;
+      for( size_t i = slot_for( k ); ; i = (i + 1) & mask ) {
+         const slot& s = _slots[i];
+         if( !s.used ) return nullptr;
+         if( s.key == k ) return &s.value;
+      }
+   }
+
+   Value* find( const key_type& k ) {
+      return const_cast<Value*>( static_cast<const account_flat_map*>(this)->find( k ) );
+   }
+
+   bool contains( const key_type& k ) const { return find( k ) != nullptr; }
+
+   /// default constructs value if not present
+   Value& operator[]( const key_type& k ) {
+      if( (_size + 1) * 2 > _slots.size() ) rehash( _slots.size() * 2 );
+      const size_t mask = _slots.size() - 1;
+      size_t i = slot_for( k );
+      for( ; _slots[i].used; i = (i + 1) & mask ) {
+         if( _slots[i].key == k ) return _slots[i].value;
+      }
+      slot& s = _slots[i];
+      s.used = true;
+      s.key = k;
+      s.value = Value{};
+      ++_size;
+      return s.value;
+   }
+
+   /// @return true if k was present and removed
+   bool erase( const key_type& k ) {
+      const size_t mask = _slots.size() - 1;
+      for( size_t i = slot_for( k ); _slots[i].used; i = (i + 1) & mask ) {
+         if( _slots[i].key == k ) {
+            erase_slot( i );
+            maybe_shrink();
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /// releases memory beyond the minimum capacity
+   void clear() {
+      if( _slots.size() == _min_capacity ) {
+         if( _size > 0 ) std::fill( _slots.begin(), _slots.end(), slot{} );
+      } else {
+         std::vector<slot>( _min_capacity ).swap( _slots );
+      }
+      _size = 0;
+   }
+
+   /**
+    * Visits up to max_slots slots starting at cursor, calling f(key, value) for occupied slots. If f returns true the
+    * entry is erased. The table is not shrunk during the walk, so cursor stays meaningful; it is updated to the slot
+    * after the last one visited and wraps to 0 at the end of the table, where the walk stops.
+    * @param erased - incremented by the number of entries erased
+    * @return number of slots visited, less than max_slots if the walk reached the end of the table
+    */
+   template<typename F>
+   size_t erase_if_from( size_t& cursor, size_t max_slots, size_t& erased, F&& f ) {
+      const size_t erased_before = erased;
+      if( cursor >= _slots.size() ) cursor = 0;
+      size_t n = 0;
+      for( ; n < max_slots && cursor < _slots.size(); ++n ) {
+         slot& s = _slots[cursor];
+         if( s.used && f( s.key, s.value ) ) {
+            // backward shift may move an entry into this slot, revisit it
+            erase_slot( cursor );
+            ++erased;
+            continue;
+         }
+         ++cursor;
+      }
+      if( cursor >= _slots.size() ) cursor = 0;
+      if( erased > erased_before && maybe_shrink() ) cursor = 0;
+      return n;
+   }
+
+   template<typename F>
+   void for_each( F&& f ) const {
+      for( const slot& s : _slots ) {
+         if( s.used ) f( s.key, s.value );
+      }
+   }
+
+private:
+   static constexpr size_t default_min_capacity = 1024;
+
+   struct slot {
+      key_type key;
+      bool     used = false;
+      Value    value{};
+   };
+
+   static size_t round_up_pow2( size_t v ) {
+      size_t r = 1;
+      while( r < v ) r <<= 1;
+      return r;
+   }
+
+   size_t slot_for( const key_type& k ) const {
+      // fibonacci hashing, name values carry most of their entropy in the high bits
+      const uint64_t h = k.to_uint64_t() * 0x9E3779B97F4A7C15ull;
+      return (h ^ (h >> 32)) & (_slots.size() - 1);
+   }
+
+   void erase_slot( size_t i ) {
+      const size_t mask = _slots.size() - 1;
+      size_t hole = i;
+      for( size_t j = (i + 1) & mask; _slots[j].used; j = (j + 1) & mask ) {
+         const size_t home = slot_for( _slots[j].key );
+         // move j into the hole unless its home lies cyclically in (hole, j]
+         const bool stays = hole <= j ? ( hole < home && home <= j ) : ( hole < home || home <= j );
+         if( !stays ) {
+            _slots[hole] = std::move( _slots[j] );
+            hole = j;
+         }
+      }
+      _slots[hole] = slot{};
+      --_size;
+   }
+
+   bool maybe_shrink() {
+      if( _slots.size() > _min_capacity && _size * 8 < _slots.size() ) {
+         rehash( std::max( _min_capacity, round_up_pow2( _size * 4 ) ) );
+         return true;
+      }
+      return false;
+   }
+
+   void rehash( size_t new_capacity ) {
+      std::vector<slot> old( new_capacity );
+      old.swap( _slots );
+      const size_t mask = _slots.size() - 1;
+      for( slot& s : old ) {
+         if( !s.used ) continue;
+         size_t i = slot_for( s.key );
+         while( _slots[i].used ) i = (i + 1) & mask;
+         _slots[i] = std::move( s );
+      }
+   }
+
+   std::vector<slot> _slots;
+   size_t            _size = 0;
+   size_t            _min_capacity;
+};
+
+} //eosio
@@ -7,12 +7,15 @@
 #include <eosio/chain/resource_limits.hpp>
 #include <eosio/chain/resource_limits_private.hpp>
 #include <eosio/chain/config.hpp>
+#include <eosio/producer_plugin/account_flat_map.hpp>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 
+#include <mutex>
+
 namespace eosio {
 
 namespace bmi = boost::multi_index;
@@ -48,13 +51,13 @@ private:
       uint64_t              pending_cpu_us;        // tracked cpu us for transactions that may still succeed in a block
       decaying_accumulator  expired_accumulator;   // accumulator used to account for transactions that have expired
 
-      bool empty(uint32_t time_ordinal, uint32_t expired_accumulator_average_window) {
+      bool empty(uint32_t time_ordinal, uint32_t expired_accumulator_average_window) const {
          return pending_cpu_us == 0 && expired_accumulator.value_at(time_ordinal, expired_accumulator_average_window) == 0;
       }
    };
 
-   using account_subjective_bill_cache = std::map<account_name, subjective_billing_info>;
-   using block_subjective_bill_cache = std::map<account_name, uint64_t>;
+   using account_subjective_bill_cache = account_flat_map<subjective_billing_info>;
+   using block_subjective_bill_cache = account_flat_map<uint64_t>;
 
    bool                                      _disabled = false;
    trx_cache_index                           _trx_cache_index;
@@ -62,6 +65,9 @@ private:
    block_subjective_bill_cache               _block_subjective_bill_cache;
    std::set<chain::account_name>             _disabled_accounts;
    uint32_t                                  _expired_accumulator_average_window = config::account_cpu_usage_average_window_ms / subjective_time_interval_ms;
+   size_t                                    _account_sweep_cursor = 0;
+   // get_subjective_bill is called from API threads, the bills are only read and changed while holding it
+   mutable std::mutex                        _mtx;
 
 private:
    uint32_t time_ordinal_for( const fc::time_point& t ) const {
@@ -71,20 +77,35 @@ private:
    }
 
    void remove_subjective_billing( const trx_cache_entry& entry, uint32_t time_ordinal ) {
-      auto aitr = _account_subjective_bill_cache.find( entry.account );
-      if( aitr != _account_subjective_bill_cache.end() ) {
-         aitr->second.pending_cpu_us -= entry.subjective_cpu_bill;
-         EOS_ASSERT( aitr->second.pending_cpu_us >= 0, chain::tx_resource_exhaustion,
+      auto* info = _account_subjective_bill_cache.find( entry.account );
+      if( info ) {
+         info->pending_cpu_us -= entry.subjective_cpu_bill;
+         EOS_ASSERT( info->pending_cpu_us >= 0, chain::tx_resource_exhaustion,
                      "Logic error in subjective account billing ${a}", ("a", entry.account) );
-         if( aitr->second.empty(time_ordinal, _expired_accumulator_average_window) ) _account_subjective_bill_cache.erase( aitr );
+         if( info->empty(time_ordinal, _expired_accumulator_average_window) ) _account_subjective_bill_cache.erase( entry.account );
       }
    }
 
    void transition_to_expired( const trx_cache_entry& entry, uint32_t time_ordinal ) {
-      auto aitr = _account_subjective_bill_cache.find( entry.account );
-      if( aitr != _account_subjective_bill_cache.end() ) {
-         aitr->second.pending_cpu_us -= entry.subjective_cpu_bill;
-         aitr->second.expired_accumulator.add(entry.subjective_cpu_bill, time_ordinal, _expired_accumulator_average_window);
+      auto* info = _account_subjective_bill_cache.find( entry.account );
+      if( info ) {
+         info->pending_cpu_us -= entry.subjective_cpu_bill;
+         info->expired_accumulator.add(entry.subjective_cpu_bill, time_ordinal, _expired_accumulator_average_window);
+      }
+   }
+
+   /// incrementally drop accounts whose pending bill is gone and whose expired bill has fully decayed, a sweep cut
+   /// short by deadline resumes at the next call
+   void sweep_decayed_accounts( uint32_t time_ordinal, const fc::time_point& deadline, size_t& num_removed ) {
+      size_t remaining = std::min( _account_subjective_bill_cache.capacity(), account_sweep_max_slots );
+      while( remaining > 0 && deadline > fc::time_point::now() ) {
+         const size_t visited = _account_subjective_bill_cache.erase_if_from( _account_sweep_cursor,
+               std::min( remaining, account_sweep_batch_slots ), num_removed,
+               [&]( const account_name&, const subjective_billing_info& info ) {
+                  return info.empty( time_ordinal, _expired_accumulator_average_window );
+               } );
+         if( visited == 0 ) break;
+         remaining -= std::min( remaining, visited );
       }
    }
 
@@ -99,8 +120,10 @@ private:
       }
    }
 
-public: // public for tests
+public: // public for tests, callers other than tests hold _mtx
    static constexpr uint32_t subjective_time_interval_ms = 5'000;
+   static constexpr size_t   account_sweep_batch_slots = 256;      // slots visited between deadline checks
+   static constexpr size_t   account_sweep_max_slots = 64 * 1024;  // slots visited per remove_expired call
 
    void remove_subjective_billing( const transaction_id_type& trx_id, uint32_t time_ordinal ) {
       auto& idx = _trx_cache_index.get<by_id>();
@@ -120,6 +143,7 @@ public:
    void subjective_bill( const transaction_id_type& id, const fc::time_point& expire, const account_name& first_auth,
                          const fc::microseconds& elapsed, bool in_pending_block )
    {
+      std::lock_guard<std::mutex> g( _mtx );
       if( !_disabled && !_disabled_accounts.count( first_auth ) ) {
          uint32_t bill = std::max<int64_t>( 0, elapsed.count() );
          auto p = _trx_cache_index.emplace(
@@ -138,6 +162,7 @@ public:
 
    void subjective_bill_failure( const account_name& first_auth, const fc::microseconds& elapsed, const fc::time_point& now )
    {
+      std::lock_guard<std::mutex> g( _mtx );
       if( !_disabled && !_disabled_accounts.count( first_auth ) ) {
          uint32_t bill = std::max<int64_t>( 0, elapsed.count() );
          const auto time_ordinal = time_ordinal_for(now);
@@ -147,16 +172,12 @@ public:
 
    uint32_t get_subjective_bill( const account_name& first_auth, const fc::time_point& now ) const {
       if( _disabled || _disabled_accounts.count( first_auth ) ) return 0;
+      std::lock_guard<std::mutex> g( _mtx );
       const auto time_ordinal = time_ordinal_for(now);
-      const subjective_billing_info* sub_bill_info = nullptr;
-      auto aitr = _account_subjective_bill_cache.find( first_auth );
-      if( aitr != _account_subjective_bill_cache.end() ) {
-         sub_bill_info = &aitr->second;
-      }
+      const subjective_billing_info* sub_bill_info = _account_subjective_bill_cache.find( first_auth );
       uint64_t in_block_pending_cpu_us = 0;
-      auto bitr = _block_subjective_bill_cache.find( first_auth );
-      if( bitr != _block_subjective_bill_cache.end() ) {
-         in_block_pending_cpu_us = bitr->second;
+      if( const uint64_t* in_block = _block_subjective_bill_cache.find( first_auth ) ) {
+         in_block_pending_cpu_us = *in_block;
       }
 
       if (sub_bill_info) {
@@ -169,11 +190,13 @@ public:
    }
 
    void abort_block() {
+      std::lock_guard<std::mutex> g( _mtx );
       _block_subjective_bill_cache.clear();
    }
 
    void on_block( fc::logger& log, const block_state_ptr& bsp, const fc::time_point& now ) {
       if( bsp == nullptr || _disabled ) return;
+      std::lock_guard<std::mutex> g( _mtx );
       const auto time_ordinal = time_ordinal_for(now);
       const auto orig_count = _account_subjective_bill_cache.size();
       remove_subjective_billing( bsp, time_ordinal );
@@ -182,9 +205,10 @@ public:
 
    bool remove_expired( fc::logger& log, const fc::time_point& pending_block_time, const fc::time_point& now, const fc::time_point& deadline ) {
       bool exhausted = false;
+      const auto time_ordinal = time_ordinal_for(now);
+      std::lock_guard<std::mutex> g( _mtx );
       auto& idx = _trx_cache_index.get<by_expiry>();
       if( !idx.empty() ) {
-         const auto time_ordinal = time_ordinal_for(now);
          const auto orig_count = _trx_cache_index.size();
          uint32_t num_expired = 0;
 
@@ -203,14 +227,29 @@ public:
          fc_dlog( log, "Processed ${n} subjective billed transactions, Expired ${expired}",
                   ("n", orig_count)( "expired", num_expired ) );
       }
+      if( !exhausted && !_account_subjective_bill_cache.empty() ) {
+         const auto orig_count = _account_subjective_bill_cache.size();
+         size_t num_removed = 0;
+         // optional housekeeping, not reported as exhausted
+         sweep_decayed_accounts( time_ordinal, deadline, num_removed );
+         if( num_removed > 0 ) {
+            fc_dlog( log, "Subjective billed accounts ${n} decayed ${r}", ("n", orig_count)("r", num_removed) );
+         }
+      }
       return !exhausted;
    }
 
+   size_t get_num_subjective_billed_accounts() const {
+      std::lock_guard<std::mutex> g( _mtx );
+      return _account_subjective_bill_cache.size();
+   }
+
    uint32_t get_expired_accumulator_average_window() const {
       return _expired_accumulator_average_window;
    }
 
    void set_expired_accumulator_average_window( fc::microseconds subjective_account_decay_time ) {
+      std::lock_guard<std::mutex> g( _mtx );
       _expired_accumulator_average_window =
         subjective_account_decay_time.count() / 1000 / subjective_time_interval_ms;
    }
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <eosio/chain/types.hpp>
+#include <eosio/chain/exceptions.hpp>
+#include <eosio/chain/controller.hpp>
+#include <eosio/chain/block_header.hpp>
+#include <eosio/chain/block_summary_object.hpp>
+#include <eosio/chain/transaction_metadata.hpp>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+
+namespace eosio {
+
+using chain::account_name;
+using chain::block_id_type;
+using chain::transaction_id_type;
+using chain::transaction_metadata;
+
+/**
+ * Stateless pre-validation of incoming transactions, run on the producer thread pool after key recovery so that
+ * transactions which would be rejected for cheap reasons never reach the main thread's transaction_context.
+ *
+ * Main thread state is never read here. Instead the main thread publishes a snapshot at the start of each block,
+ * keeps a copy of the irreversible part of the TaPoS block summary, and republishes the actor white/black lists when
+ * they change. Checks only reject when the rejection is certain to be repeated by the full validation; anything
+ * ambiguous (reversible or soon-to-be-reused TaPoS slots, unknown block ids) is left for the main thread. The
+ * contract lists are not checked: execution only applies them to receivers with code or a native handler, which
+ * is chain state.
+ */
+class trx_prevalidator {
+public:
+   struct access_lists {
+      flat_set<account_name> actor_whitelist;
+      flat_set<account_name> actor_blacklist;
+   };
+
+   struct snapshot {
+      fc::time_point                      block_time;         // pending block time, or head block time if not building
+      uint32_t                            head_block_num = 0;
+      bool                                producing = false;  // white/black lists are only enforced when producing
+      bool                                skip_auth_check = false;
+      std::shared_ptr<const access_lists> lists;
+   };
+
+   /// TaPoS slots this close to being overwritten by a new block are not checked
+   static constexpr uint32_t tapos_reuse_margin_blocks = 1200;
+
+   void disable() { _disabled = true; }
+   bool disabled() const { return _disabled; }
+
+   /// main thread only
+   void update_access_lists( const chain::controller& chain ) {
+      auto lists = std::make_shared<access_lists>();
+      lists->actor_whitelist = chain.get_actor_whitelist();
+      lists->actor_blacklist = chain.get_actor_blacklist();
+      _lists = std::move( lists );
+   }
+
+   /// main thread only, call after a block is started
+   void update_snapshot( const chain::controller& chain, bool producing ) {
+      if( _disabled ) return;
+      snapshot s;
+      s.block_time = chain.is_building_block() ? chain.pending_block_time() : chain.head_block_time();
+      s.head_block_num = chain.head_block_num();
+      s.producing = producing;
+      s.skip_auth_check = chain.skip_auth_check();
+      s.lists = _lists;
+      set_snapshot( std::move( s ) );
+   }
+
+   /// main thread only, copies the irreversible entries of the block summary table
+   void init_tapos( const chain::controller& chain ) {
+      if( _disabled ) return;
+      const uint32_t lib_num = chain.last_irreversible_block_num();
+      const auto& idx = chain.db().get_index<chain::block_summary_multi_index, chain::by_id>();
+      for( const auto& summary : idx ) {
+         if( summary.block_id == block_id_type() ) continue;
+         const uint32_t block_num = chain::block_header::num_from_id( summary.block_id );
+         if( block_num <= lib_num ) on_irreversible_block( block_num, summary.block_id );
+      }
+   }
+
+   /// main thread only
+   void on_irreversible_block( uint32_t block_num, const block_id_type& id ) {
+      if( _disabled ) return;
+      const uint64_t entry = (uint64_t(block_num) << 32) | uint32_t(id._hash[1]);
+      _tapos[block_num & tapos_mask].store( entry, std::memory_order_relaxed );
+   }
+
+   void set_snapshot( snapshot s ) {
+      std::atomic_store( &_snapshot, std::make_shared<const snapshot>( std::move( s ) ) );
+   }
+
+   /**
+    * Thread safe. On success the transaction is tracked as in-flight until done() is called for it.
+    * @return exception the transaction would certainly be rejected with, nullptr if it should be processed
+    */
+   fc::exception_ptr prevalidate( const transaction_metadata& trx ) {
+      if( _disabled ) return {};
+      const auto s = std::atomic_load( &_snapshot );
+      if( !s ) return {};
+      try {
+         const auto& t = trx.packed_trx()->get_transaction();
+
+         EOS_ASSERT( fc::time_point( t.expiration ) >= s->block_time, chain::expired_tx_exception,
+                     "expired transaction ${id}, expiration ${e}, block time ${bt}",
+                     ("id", trx.id())("e", t.expiration)("bt", s->block_time) );
+
+         const uint64_t tapos = _tapos[t.ref_block_num].load( std::memory_order_relaxed );
+         const uint32_t tapos_block_num = tapos >> 32;
+         if( tapos_block_num != 0 && tapos_block_num + tapos_mask + 1 > s->head_block_num + tapos_reuse_margin_blocks ) {
+            EOS_ASSERT( t.ref_block_prefix == uint32_t( tapos ), chain::invalid_ref_block_exception,
+                        "Transaction's reference block did not match. Is this transaction from a different fork?" );
+         }
+
+         flat_set<account_name> actors;
+         for( const auto& a : t.actions ) {
+            for( const auto& auth : a.authorization ) {
+               actors.insert( auth.actor );
+            }
+         }
+         EOS_ASSERT( !actors.empty() || trx.read_only, chain::tx_no_auths, "transaction must have at least one authorization" );
+
+         // without keys nothing but a delay can satisfy an authority
+         EOS_ASSERT( actors.empty() || !trx.recovered_keys().empty() || t.delay_sec.value > 0 || trx.read_only || s->skip_auth_check,
+                     chain::unsatisfied_authorization, "transaction declares authority but provides no signatures" );
+
+         if( s->producing && s->lists ) {
+            chain::controller::check_actor_list( actors, s->lists->actor_whitelist, s->lists->actor_blacklist );
+         }
+
+         {
+            std::lock_guard<std::mutex> g( _in_flight_mtx );
+            EOS_ASSERT( _in_flight.insert( trx.id() ).second, chain::tx_duplicate,
+                        "duplicate transaction ${id}", ("id", trx.id()) );
+         }
+      } catch( const fc::exception& e ) {
+         return e.dynamic_copy_exception();
+      }
+      return {};
+   }
+
+   /// Thread safe. Call once a transaction accepted by prevalidate() has been processed.
+   void done( const transaction_id_type& id ) {
+      if( _disabled ) return;
+      std::lock_guard<std::mutex> g( _in_flight_mtx );
+      _in_flight.erase( id );
+   }
+
+private:
+   static constexpr uint32_t tapos_mask = 0xffff; // block_summary_object ids are block_num & 0xffff
+
+   struct trx_id_hash {
+      size_t operator()( const transaction_id_type& id ) const { return id._hash[0]; }
+   };
+
+   bool                                       _disabled = false;
+   std::shared_ptr<const access_lists>        _lists;     // main thread only
+   std::shared_ptr<const snapshot>            _snapshot;  // access only through std::atomic_load/store
+   std::array<std::atomic<uint64_t>, tapos_mask + 1> _tapos{}; // irreversible (block_num << 32 | ref_block_prefix)
+   std::mutex                                 _in_flight_mtx;
+   std::unordered_set<transaction_id_type, trx_id_hash> _in_flight;
+};
+
+} //eosio
@@ -1,12 +1,14 @@
 #include <eosio/producer_plugin/producer_plugin.hpp>
 #include <eosio/producer_plugin/pending_snapshot.hpp>
 #include <eosio/producer_plugin/subjective_billing.hpp>
+#include <eosio/producer_plugin/trx_prevalidator.hpp>
 #include <eosio/chain/plugin_interface.hpp>
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/generated_transaction_object.hpp>
 #include <eosio/chain/snapshot.hpp>
 #include <eosio/chain/transaction_object.hpp>
 #include <eosio/chain/thread_utils.hpp>
+#include <eosio/chain/token_bucket_limiter.hpp>
 #include <eosio/chain/unapplied_transaction_queue.hpp>
 #include <eosio/resource_monitor_plugin/resource_monitor_plugin.hpp>
 
@@ -296,6 +298,8 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
       pending_snapshot_index                                   _pending_snapshot_index;
       subjective_billing                                       _subjective_billing;
       account_failures                                         _account_fails{_subjective_billing};
+      trx_prevalidator                                         _trx_prevalidator;
+      token_bucket_limiter<account_name>                       _incoming_trx_account_limiter;
 
       std::optional<scoped_connection>                          _accepted_block_connection;
       std::optional<scoped_connection>                          _accepted_block_header_connection;
@@ -353,6 +357,8 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
          _irreversible_block_time = lib->timestamp.to_time_point();
          const chain::controller& chain = chain_plug->chain();
 
+         _trx_prevalidator.on_irreversible_block( lib->block_num(), lib->calculate_id() );
+
          // promote any pending snapshots
          auto& snapshots_by_height = _pending_snapshot_index.get<by_height>();
          uint32_t lib_height = lib->block_num();
@@ -479,6 +485,19 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
                                          bool return_failure_traces,
                                          next_function<transaction_trace_ptr> next) {
          chain::controller& chain = chain_plug->chain();
+
+         // the authorizer is not authenticated yet, only check its budget here, it is charged once the transaction applied
+         if( !read_only && _incoming_trx_account_limiter.enabled() ) {
+            const auto first_auth = trx->get_transaction().first_authorizer();
+            if( !_incoming_trx_account_limiter.has_tokens( first_auth, fc::time_point::now() ) ) {
+               fc_dlog( _trx_failed_trace_log, "[TRX_TRACE] Rate limit is REJECTING tx: ${txid}, auth: ${a}", ("txid", trx->id())("a", first_auth) );
+               next( std::static_pointer_cast<fc::exception>( std::make_shared<tx_resource_exhaustion>(
+                     FC_LOG_MESSAGE( error, "transaction ${id} exceeded incoming rate limit for account ${a}",
+                                     ("id", trx->id())("a", first_auth) ) ) ) );
+               return;
+            }
+         }
+
          const auto max_trx_time_ms = _max_transaction_time_ms.load();
          fc::microseconds max_trx_cpu_usage = max_trx_time_ms < 0 ? fc::microseconds::maximum() : fc::milliseconds( max_trx_time_ms );
 
@@ -487,11 +506,23 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
                                                                  read_only ? transaction_metadata::trx_type::read_only : transaction_metadata::trx_type::input,
                                                                  chain.configured_subjective_signature_length_limit() );
 
-         boost::asio::post(_thread_pool->get_executor(), [self = this, future{std::move(future)}, persist_until_expired, return_failure_traces,
+         boost::asio::post(_thread_pool->get_executor(), [self = this, future{future.share()}, persist_until_expired, return_failure_traces,
                                                           next{std::move(next)}, trx]() mutable {
             if( future.valid() ) {
                future.wait();
-               app().post( priority::low, [self, future{std::move(future)}, persist_until_expired, next{std::move( next )}, trx{std::move(trx)}, return_failure_traces]() mutable {
+               // reject cheaply rejectable transactions without setting up a transaction_context on the main thread,
+               // key recovery failures are reported by future.get() on the main thread
+               fc::exception_ptr rejected;
+               bool in_flight = false;
+               try {
+                  rejected = self->_trx_prevalidator.prevalidate( *future.get() );
+                  in_flight = !rejected;
+               } catch( ... ) {}
+               app().post( priority::low, [self, future{std::move(future)}, rejected{std::move(rejected)}, in_flight, persist_until_expired,
+                                           next{std::move( next )}, trx{std::move(trx)}, return_failure_traces]() mutable {
+                  auto done = fc::make_scoped_exit( [self, in_flight, id{trx->id()}]() {
+                     if( in_flight ) self->_trx_prevalidator.done( id );
+                  } );
                   auto exception_handler = [self, &next, trx{std::move(trx)}](fc::exception_ptr ex) {
                      fc_dlog(_trx_failed_trace_log, "[TRX_TRACE] Speculative execution is REJECTING tx: ${txid}, auth: ${a} : ${why} ",
                              ("txid", trx->id())("a",trx->get_transaction().first_authorizer())("why",ex->what()));
@@ -503,6 +534,10 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
                              ("trx", self->chain_plug->get_log_trx(trx->get_transaction())));
                   };
                   try {
+                     if( rejected ) {
+                        exception_handler( rejected );
+                        return;
+                     }
                      auto result = future.get();
                      if( !self->process_incoming_transaction_async( result, persist_until_expired, return_failure_traces, next) ) {
                         if( self->_pending_block_mode == pending_block_mode::producing ) {
@@ -709,6 +744,9 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
             } else {
                fc_dlog( _trx_successful_trace_log, "Subjective bill for success ${a}: ${b} elapsed ${t}us, time ${r}us",
                         ("a",first_auth)("b",sub_bill)("t",trace->elapsed)("r", fc::time_point::now() - start));
+               // signatures and authorization have been verified, first_auth is the account that sent it
+               if( !trx->read_only )
+                  _incoming_trx_account_limiter.try_consume( first_auth, fc::time_point::now() );
                if( persist_until_expired && !_disable_persist_until_expired ) {
                   // if this trx didnt fail/soft-fail and the persist flag is set, store its ID so that we can
                   // ensure its applied to all future speculative blocks as well.
@@ -857,6 +895,12 @@ void producer_plugin::set_program_options(
           "Maximum size (in MiB) of the incoming transaction queue. Exceeding this value will subjectively drop transaction with resource exhaustion.")
          ("disable-api-persisted-trx", bpo::bool_switch()->default_value(false),
           "Disable the re-apply of API transactions.")
+         ("disable-transaction-prevalidation", bpo::bool_switch()->default_value(false),
+          "Disable the stateless pre-validation (expiration, TaPoS, duplicates, white/black lists, missing signatures) of incoming transactions on the producer thread pool.")
+         ("incoming-trx-rate-limit-per-account", bpo::value<uint32_t>()->default_value(0),
+          "Maximum sustained number of incoming API/P2P transactions per second accepted per first authorizer, 0 to disable. Only transactions that applied successfully are counted.")
+         ("incoming-trx-rate-limit-burst-per-account", bpo::value<uint32_t>()->default_value(0),
+          "Number of incoming transactions a first authorizer may send in a burst above incoming-trx-rate-limit-per-account. Defaults to the rate when 0.")
          ("disable-subjective-billing", bpo::value<bool>()->default_value(true),
           "Disable subjective CPU billing for API/P2P transactions")
          ("disable-subjective-account-billing", boost::program_options::value<vector<string>>()->composing()->multitoken(),
@@ -1011,6 +1055,13 @@ void producer_plugin::plugin_initialize(const boost::program_options::variables_
    my->_incoming_defer_ratio = options.at("incoming-defer-ratio").as<double>();
 
    my->_disable_persist_until_expired = options.at("disable-api-persisted-trx").as<bool>();
+   if( options.at("disable-transaction-prevalidation").as<bool>() )
+      my->_trx_prevalidator.disable();
+   {
+      const auto rate = options.at("incoming-trx-rate-limit-per-account").as<uint32_t>();
+      const auto burst = options.at("incoming-trx-rate-limit-burst-per-account").as<uint32_t>();
+      my->_incoming_trx_account_limiter.configure( rate, burst > 0 ? burst : rate );
+   }
    bool disable_subjective_billing = options.at("disable-subjective-billing").as<bool>();
    my->_disable_subjective_p2p_billing = options.at("disable-subjective-p2p-billing").as<bool>();
    my->_disable_subjective_api_billing = options.at("disable-subjective-api-billing").as<bool>();
@@ -1123,6 +1174,9 @@ void producer_plugin::plugin_startup()
    my->_accepted_block_header_connection.emplace(chain.accepted_block_header.connect( [this]( const auto& bsp ){ my->on_block_header( bsp ); } ));
    my->_irreversible_block_connection.emplace(chain.irreversible_block.connect( [this]( const auto& bsp ){ my->on_irreversible_block( bsp->block ); } ));
 
+   my->_trx_prevalidator.update_access_lists( chain );
+   my->_trx_prevalidator.init_tapos( chain );
+
    const auto lib_num = chain.last_irreversible_block_num();
    const auto lib = chain.fetch_block_by_number(lib_num);
    if (lib) {
@@ -1154,6 +1208,8 @@ void producer_plugin::plugin_startup()
 void producer_plugin::plugin_shutdown() {
    try {
       my->_timer.cancel();
+      // its transactions are not applied again, readers on other threads see the state of the last block
+      my->abort_block();
    } catch ( const std::bad_alloc& ) {
      chain_plugin::handle_bad_alloc();
    } catch ( const boost::interprocess::bad_alloc& ) {
@@ -1306,6 +1362,7 @@ void producer_plugin::set_whitelist_blacklist(const producer_plugin::whitelist_b
    if(params.contract_blacklist) chain.set_contract_blacklist(*params.contract_blacklist);
    if(params.action_blacklist) chain.set_action_blacklist(*params.action_blacklist);
    if(params.key_blacklist) chain.set_key_blacklist(*params.key_blacklist);
+   my->_trx_prevalidator.update_access_lists( chain );
 }
 
 producer_plugin::integrity_hash_information producer_plugin::get_integrity_hash() const {
@@ -1772,6 +1829,8 @@ producer_plugin_impl::start_block_result producer_plugin_impl::start_block() {
          _pending_block_mode = pending_block_mode::speculating;
       }
 
+      _trx_prevalidator.update_snapshot( chain, _pending_block_mode == pending_block_mode::producing );
+
       try {
          if( !remove_expired_trxs( preprocess_deadline ) )
             return start_block_result::exhausted;
@@ -0,0 +1,91 @@
+#include <eosio/producer_plugin/subjective_billing.hpp>
+
+#include <fc/log/logger.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+// Drives subjective_billing with a spam-like workload: many distinct first authorizers each submitting a few
+// transactions, most of which fail or expire. Not run as part of ctest, invoke manually:
+//    bench_subjective_billing [num_accounts] [trxs_per_account]
+
+using namespace eosio;
+using namespace eosio::chain;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double elapsed_ms( clock_type::time_point start ) {
+   return std::chrono::duration<double, std::milli>( clock_type::now() - start ).count();
+}
+
+void report( const char* phase, uint64_t ops, clock_type::time_point start ) {
+   const auto ms = elapsed_ms( start );
+   std::cout << phase << ": " << ops << " ops in " << ms << " ms, " << (ms * 1'000'000 / std::max<uint64_t>(ops, 1)) << " ns/op" << std::endl;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv ) {
+   const uint64_t num_accounts = argc > 1 ? std::stoull( argv[1] ) : 1'000'000;
+   const uint64_t trxs_per_account = argc > 2 ? std::stoull( argv[2] ) : 2;
+
+   fc::logger log;
+   subjective_billing sub_bill;
+   const auto now = fc::time_point::now();
+   const auto window = fc::milliseconds( sub_bill.get_expired_accumulator_average_window() * subjective_billing::subjective_time_interval_ms );
+
+   std::vector<account_name> accounts;
+   accounts.reserve( num_accounts );
+   std::mt19937_64 rng( 42 );
+   for( uint64_t i = 0; i < num_accounts; ++i ) {
+      accounts.emplace_back( rng() & ~0xFull ); // low 4 bits are the 13th char, normally unused
+   }
+
+   auto start = clock_type::now();
+   uint64_t n = 0;
+   for( uint64_t t = 0; t < trxs_per_account; ++t ) {
+      for( const auto& a : accounts ) {
+         transaction_id_type id = fc::sha256::hash( reinterpret_cast<const char*>(&n), sizeof(n) );
+         if( n % 2 ) {
+            sub_bill.subjective_bill( id, now + fc::seconds( n % 60 ), a, fc::microseconds( 100 + n % 50 ), n % 3 == 0 );
+         } else {
+            sub_bill.subjective_bill_failure( a, fc::microseconds( 100 + n % 50 ), now );
+         }
+         ++n;
+      }
+   }
+   report( "bill", n, start );
+   std::cout << "accounts tracked: " << sub_bill.get_num_subjective_billed_accounts() << std::endl;
+
+   start = clock_type::now();
+   uint64_t total = 0;
+   for( uint64_t i = 0; i < num_accounts; ++i ) {
+      total += sub_bill.get_subjective_bill( accounts[rng() % num_accounts], now );
+   }
+   report( "get_subjective_bill", num_accounts, start );
+
+   start = clock_type::now();
+   sub_bill.on_block( log, {}, now );
+   sub_bill.abort_block();
+   report( "on_block+abort_block", 1, start );
+
+   // expire all transactions at the decay window, then sweep in deadline sized slices as the producer would
+   const auto later = now + window;
+   start = clock_type::now();
+   uint64_t calls = 0;
+   while( true ) {
+      ++calls;
+      if( sub_bill.remove_expired( log, later, later, fc::time_point::now() + fc::milliseconds( 10 ) )
+          && sub_bill.get_num_subjective_billed_accounts() == 0 )
+         break;
+      if( calls > 100'000 ) break;
+   }
+   report( "remove_expired calls", calls, start );
+   std::cout << "accounts tracked after decay: " << sub_bill.get_num_subjective_billed_accounts()
+             << " (checksum " << total << ")" << std::endl;
+
+   return 0;
+}
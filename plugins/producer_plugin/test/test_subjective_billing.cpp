@@ -161,6 +161,75 @@ BOOST_AUTO_TEST_CASE( subjective_bill_test ) {
 
 }
 
+BOOST_AUTO_TEST_CASE( subjective_bill_decayed_accounts_removed_test ) {
+
+   fc::logger log;
+   const auto now = time_point::now();
+
+   subjective_billing sub_bill;
+   const auto endtime = now + fc::milliseconds(sub_bill.get_expired_accumulator_average_window() * subjective_billing::subjective_time_interval_ms);
+
+   const uint64_t num_accounts = 10'000;
+   for( uint64_t i = 1; i <= num_accounts; ++i ) {
+      sub_bill.subjective_bill_failure( account_name(i << 4), fc::microseconds( 100 ), now );
+   }
+   transaction_id_type id1 = sha256::hash( "1" );
+   sub_bill.subjective_bill( id1, endtime + fc::seconds(1), "a"_n, fc::microseconds( 13 ), false );
+   BOOST_CHECK_EQUAL( num_accounts + 1, sub_bill.get_num_subjective_billed_accounts() );
+
+   // nothing has decayed yet
+   sub_bill.remove_expired( log, now, now, fc::time_point::maximum() );
+   BOOST_CHECK_EQUAL( num_accounts + 1, sub_bill.get_num_subjective_billed_accounts() );
+   BOOST_CHECK_EQUAL( 100, sub_bill.get_subjective_bill(account_name(1 << 4), now) );
+
+   // failures fully decayed, pending trx for "a" still billed
+   sub_bill.remove_expired( log, endtime, endtime, fc::time_point::maximum() );
+   BOOST_CHECK_EQUAL( 1, sub_bill.get_num_subjective_billed_accounts() );
+   BOOST_CHECK_EQUAL( 0, sub_bill.get_subjective_bill(account_name(1 << 4), endtime) );
+   BOOST_CHECK_EQUAL( 13, sub_bill.get_subjective_bill("a"_n, endtime) );
+
+   // an expired deadline leaves the expired transactions for a later call
+   sub_bill.subjective_bill_failure( "b"_n, fc::microseconds( 100 ), now );
+   BOOST_CHECK( !sub_bill.remove_expired( log, endtime, endtime, fc::time_point::now() - fc::seconds(1) ) );
+   BOOST_CHECK_EQUAL( 2, sub_bill.get_num_subjective_billed_accounts() );
+}
+
+BOOST_AUTO_TEST_CASE( sweep_not_exhausted ) {
+   fc::logger log;
+   subjective_billing sub_bill;
+   const auto now = time_point::now();
+   const auto endtime = now + fc::milliseconds(sub_bill.get_expired_accumulator_average_window() * subjective_billing::subjective_time_interval_ms);
+
+   for( uint64_t i = 1; i <= 100; ++i ) {
+      sub_bill.subjective_bill_failure( account_name(i << 4), fc::microseconds( 100 ), now );
+   }
+
+   // no expired transactions, a sweep cut short by the deadline does not exhaust the block and resumes later
+   BOOST_CHECK( sub_bill.remove_expired( log, endtime, endtime, fc::time_point::now() - fc::seconds(1) ) );
+   BOOST_CHECK_EQUAL( 100, sub_bill.get_num_subjective_billed_accounts() );
+   BOOST_CHECK( sub_bill.remove_expired( log, endtime, endtime, fc::time_point::maximum() ) );
+   BOOST_CHECK_EQUAL( 0, sub_bill.get_num_subjective_billed_accounts() );
+}
+
+BOOST_AUTO_TEST_CASE( erase_if_from_visited ) {
+   account_flat_map<int> m( 16 );
+   for( uint64_t i = 1; i <= 4; ++i )
+      m[account_name(i)] = int(i);
+   BOOST_REQUIRE_EQUAL( 16u, m.capacity() );
+
+   // the walk stops at the end of the table and reports the slots it actually visited
+   size_t cursor = 13;
+   size_t erased = 0;
+   BOOST_CHECK_EQUAL( 3u, m.erase_if_from( cursor, 256, erased, []( const account_name&, int ) { return false; } ) );
+   BOOST_CHECK_EQUAL( 0u, cursor );
+   BOOST_CHECK_EQUAL( 0u, erased );
+
+   // a slot is visited again after erasing from it, as an entry may have moved into it
+   BOOST_CHECK_EQUAL( 16u + 2u, m.erase_if_from( cursor, 256, erased, []( const account_name&, int v ) { return v % 2 == 0; } ) );
+   BOOST_CHECK_EQUAL( 2u, erased );
+   BOOST_CHECK_EQUAL( 2u, m.size() );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -0,0 +1,160 @@
+#define BOOST_TEST_MODULE trx_prevalidator
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/producer_plugin/trx_prevalidator.hpp>
+
+#include <eosio/testing/tester.hpp>
+
+#include <eosio/chain/thread_utils.hpp>
+
+namespace {
+
+using namespace eosio;
+using namespace eosio::chain;
+
+struct prevalidator_fixture {
+   named_thread_pool thread_pool{ "test", 1 };
+   chain_id_type     chain_id = fc::sha256::hash( "chain" );
+   fc::time_point    now = fc::time_point::now();
+   block_id_type     ref_block_id;
+
+   prevalidator_fixture() {
+      ref_block_id = fc::sha256::hash( "block" );
+      ref_block_id._hash[0] = fc::endian_reverse_u32( 1000 ); // block_num 1000
+   }
+
+   signed_transaction make_trx( std::vector<permission_level> auths, account_name code = "eosio"_n ) {
+      signed_transaction trx;
+      trx.expiration = now + fc::seconds( 60 );
+      trx.set_reference_block( ref_block_id );
+      trx.actions.emplace_back( std::move( auths ), code, "nonce"_n, fc::raw::pack( now.time_since_epoch().count() ) );
+      return trx;
+   }
+
+   transaction_metadata_ptr meta( signed_transaction trx, bool sign = true ) {
+      if( sign ) {
+         auto priv_key = private_key_type::regenerate<fc::ecc::private_key_shim>( fc::sha256::hash( std::string( "nathan" ) ) );
+         trx.sign( priv_key, chain_id );
+      }
+      auto ptrx = std::make_shared<packed_transaction>( std::move( trx ) );
+      return transaction_metadata::start_recover_keys( ptrx, thread_pool.get_executor(), chain_id, fc::microseconds::maximum(),
+                                                       transaction_metadata::trx_type::input ).get();
+   }
+
+   trx_prevalidator::snapshot make_snapshot( bool producing = false ) {
+      trx_prevalidator::snapshot s;
+      s.block_time = now;
+      s.head_block_num = 2000;
+      s.producing = producing;
+      return s;
+   }
+};
+
+BOOST_AUTO_TEST_SUITE( trx_prevalidator_test )
+
+BOOST_FIXTURE_TEST_CASE( prevalidate_test, prevalidator_fixture ) {
+   const std::vector<permission_level> auth{ {"alice"_n, config::active_name} };
+
+   trx_prevalidator pv;
+   // no snapshot yet, nothing is rejected
+   auto expired = make_trx( auth );
+   expired.expiration = now - fc::seconds( 1 );
+   BOOST_CHECK( !pv.prevalidate( *meta( expired ) ) );
+
+   pv.set_snapshot( make_snapshot() );
+
+   BOOST_CHECK_EQUAL( pv.prevalidate( *meta( expired ) )->code(), expired_tx_exception::code_value );
+   BOOST_CHECK_EQUAL( pv.prevalidate( *meta( make_trx( {} ) ) )->code(), tx_no_auths::code_value );
+   BOOST_CHECK_EQUAL( pv.prevalidate( *meta( make_trx( auth ), false ) )->code(), unsatisfied_authorization::code_value );
+
+   auto delayed = make_trx( auth );
+   delayed.delay_sec = 10;
+   auto m = meta( delayed, false );
+   BOOST_CHECK( !pv.prevalidate( *m ) );
+   pv.done( m->id() );
+
+   // in-flight duplicates
+   m = meta( make_trx( auth ) );
+   BOOST_CHECK( !pv.prevalidate( *m ) );
+   BOOST_CHECK_EQUAL( pv.prevalidate( *m )->code(), tx_duplicate::code_value );
+   pv.done( m->id() );
+   BOOST_CHECK( !pv.prevalidate( *m ) );
+   pv.done( m->id() );
+}
+
+BOOST_FIXTURE_TEST_CASE( tapos_test, prevalidator_fixture ) {
+   const std::vector<permission_level> auth{ {"alice"_n, config::active_name} };
+
+   trx_prevalidator pv;
+   pv.set_snapshot( make_snapshot() );
+
+   block_id_type other_id = fc::sha256::hash( "other" );
+   other_id._hash[0] = fc::endian_reverse_u32( 1000 );
+
+   // unknown slot is not checked
+   auto m = meta( make_trx( auth ) );
+   BOOST_CHECK( !pv.prevalidate( *m ) );
+   pv.done( m->id() );
+
+   pv.on_irreversible_block( 1000, other_id );
+   m = meta( make_trx( auth ) );
+   BOOST_CHECK_EQUAL( pv.prevalidate( *m )->code(), invalid_ref_block_exception::code_value );
+
+   pv.on_irreversible_block( 1000, ref_block_id );
+   BOOST_CHECK( !pv.prevalidate( *m ) );
+   pv.done( m->id() );
+
+   // slot about to be reused by a newer block is not checked
+   auto s = make_snapshot();
+   s.head_block_num = 1000 + 0x10000 - trx_prevalidator::tapos_reuse_margin_blocks;
+   pv.set_snapshot( s );
+   pv.on_irreversible_block( 1000, other_id );
+   m = meta( make_trx( auth ) );
+   BOOST_CHECK( !pv.prevalidate( *m ) );
+   pv.done( m->id() );
+}
+
+BOOST_FIXTURE_TEST_CASE( access_lists_test, prevalidator_fixture ) {
+   trx_prevalidator pv;
+   auto lists = std::make_shared<trx_prevalidator::access_lists>();
+   lists->actor_blacklist.insert( "bob"_n );
+   lists->actor_whitelist.insert( "alice"_n );
+   lists->actor_whitelist.insert( "bob"_n );
+
+   auto s = make_snapshot( false );
+   s.lists = lists;
+   pv.set_snapshot( s );
+
+   // lists only enforced when producing
+   auto m = meta( make_trx( { {"bob"_n, config::active_name} } ) );
+   BOOST_CHECK( !pv.prevalidate( *m ) );
+   pv.done( m->id() );
+
+   s.producing = true;
+   pv.set_snapshot( s );
+   BOOST_CHECK_EQUAL( pv.prevalidate( *m )->code(), actor_blacklist_exception::code_value );
+
+   m = meta( make_trx( { {"carol"_n, config::active_name} } ) );
+   BOOST_CHECK_EQUAL( pv.prevalidate( *m )->code(), actor_whitelist_exception::code_value );
+
+   m = meta( make_trx( { {"alice"_n, config::active_name} } ) );
+   BOOST_CHECK( !pv.prevalidate( *m ) );
+   pv.done( m->id() );
+}
+
+BOOST_FIXTURE_TEST_CASE( contract_lists_not_checked_test, prevalidator_fixture ) {
+   // execution skips the contract lists for a receiver without code or a native handler, so prevalidation
+   // cannot reject on them without reading which accounts have code
+   trx_prevalidator pv;
+   auto s = make_snapshot( true );
+   s.lists = std::make_shared<trx_prevalidator::access_lists>();
+   pv.set_snapshot( s );
+
+   auto m = meta( make_trx( { {"alice"_n, config::active_name} }, "nocode"_n ) );
+   BOOST_CHECK( !pv.prevalidate( *m ) );
+   pv.done( m->id() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
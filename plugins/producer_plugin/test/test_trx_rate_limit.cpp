@@ -0,0 +1,121 @@
+#define BOOST_TEST_MODULE trx_rate_limit
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/producer_plugin/producer_plugin.hpp>
+
+#include <eosio/testing/tester.hpp>
+
+#include <eosio/chain/genesis_state.hpp>
+#include <eosio/chain/transaction_metadata.hpp>
+#include <eosio/chain/trace.hpp>
+#include <eosio/chain/name.hpp>
+
+#include <appbase/application.hpp>
+
+namespace eosio::test::detail {
+using namespace eosio::chain::literals;
+struct testit {
+   uint64_t      id;
+
+   testit( uint64_t id = 0 )
+         :id(id){}
+
+   static account_name get_account() {
+      return chain::config::system_account_name;
+   }
+
+   static action_name get_name() {
+      return "testit"_n;
+   }
+};
+}
+FC_REFLECT( eosio::test::detail::testit, (id) )
+
+namespace {
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::test::detail;
+
+auto make_trx( const chain_id_type& chain_id, const std::string& key_seed ) {
+   static uint64_t nextid = 0;
+   ++nextid;
+
+   signed_transaction trx;
+   trx.expiration = fc::time_point::now() + fc::seconds( 60 );
+   trx.actions.emplace_back( vector<permission_level>{{config::system_account_name, config::active_name}},
+                             testit{nextid} );
+   auto priv_key = private_key_type::regenerate<fc::ecc::private_key_shim>( fc::sha256::hash( key_seed ) );
+   trx.sign( priv_key, chain_id );
+
+   return std::make_shared<packed_transaction>( std::move(trx) );
+}
+
+// @return the code of the exception the transaction was rejected with, 0 if it was accepted
+int64_t push_trx( const packed_transaction_ptr& ptrx ) {
+   std::promise<int64_t> result_promise;
+   std::future<int64_t> result_fut = result_promise.get_future();
+   app().post( priority::low, [ptrx, &result_promise]() {
+      app().get_method<plugin_interface::incoming::methods::transaction_async>()(ptrx,
+         false, // persist_until_expiried
+         false, // read_only
+         false, // return_failure_traces
+         [&result_promise](const std::variant<fc::exception_ptr, transaction_trace_ptr>& result) {
+            if( std::holds_alternative<fc::exception_ptr>( result ) ) {
+               result_promise.set_value( std::get<fc::exception_ptr>( result )->code() );
+            } else {
+               const auto& trace = std::get<transaction_trace_ptr>( result );
+               result_promise.set_value( trace->except ? trace->except->code() : 0 );
+            }
+      });
+   });
+   return result_fut.get();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(trx_rate_limit)
+
+// Transactions with a signature that does not satisfy the named authorizer must not use up its rate limit budget,
+// otherwise anyone could keep an account from transacting by sending junk in its name.
+BOOST_AUTO_TEST_CASE(bad_signature_not_charged) {
+   boost::filesystem::path temp = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+
+   try {
+      std::promise<chain_plugin*> plugin_promise;
+      std::future<chain_plugin*> plugin_fut = plugin_promise.get_future();
+      std::thread app_thread( [&]() {
+         std::vector<const char*> argv =
+               {"test", "--data-dir", temp.c_str(), "--config-dir", temp.c_str(),
+                "-p", "eosio", "-e", "--disable-subjective-billing=true",
+                "--incoming-trx-rate-limit-per-account", "1", "--incoming-trx-rate-limit-burst-per-account", "1" };
+         appbase::app().initialize<chain_plugin, producer_plugin>( argv.size(), (char**) &argv[0] );
+         appbase::app().startup();
+         plugin_promise.set_value( appbase::app().find_plugin<chain_plugin>() );
+         appbase::app().exec();
+      } );
+
+      auto chain_plug = plugin_fut.get();
+      auto chain_id = chain_plug->get_chain_id();
+
+      // eosio is authorized by the "nathan" key
+      for( int i = 0; i < 10; ++i ) {
+         BOOST_TEST( push_trx( make_trx( chain_id, "kevin" ) ) == unsatisfied_authorization::code_value );
+      }
+
+      // the budget of eosio is untouched by the rejected transactions
+      BOOST_TEST( push_trx( make_trx( chain_id, "nathan" ) ) == 0 );
+      // and used up by the accepted one, a second token takes a second to refill
+      BOOST_TEST( push_trx( make_trx( chain_id, "nathan" ) ) == tx_resource_exhaustion::code_value );
+
+      appbase::app().quit();
+      app_thread.join();
+
+   } catch ( ... ) {
+      bfs::remove_all( temp );
+      throw;
+   }
+   bfs::remove_all( temp );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
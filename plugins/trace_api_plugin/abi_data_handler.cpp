@@ -9,7 +9,8 @@ namespace eosio::trace_api {
             std::make_shared<chain::abi_serializer>(abi, chain::abi_serializer::create_yield_function(fc::microseconds::maximum())));
    }
 
-   std::tuple<fc::variant, std::optional<fc::variant>> abi_data_handler::serialize_to_variant(const std::variant<action_trace_v0, action_trace_v1> & action, const yield_function& yield ) {
+   template<typename Result, typename Decode>
+   std::tuple<Result, std::optional<Result>> abi_data_handler::serialize(const std::variant<action_trace_v0, action_trace_v1> & action, const yield_function& yield, Decode&& decode ) {
       auto account = std::visit([](auto &&action) -> auto { return action.account; }, action);
 
       if (abi_serializer_by_account.count(account) > 0) {
@@ -25,16 +26,16 @@ namespace eosio::trace_api {
                   EOS_ASSERT( recursion_depth < chain::abi_serializer::max_recursion_depth, chain::abi_recursion_depth_exception,
                               "exceeded max_recursion_depth ${r} ", ("r", chain::abi_serializer::max_recursion_depth) );
                };
-               return std::visit([&](auto &&action) -> std::tuple<fc::variant, std::optional<fc::variant>> {
+               return std::visit([&](auto &&action) -> std::tuple<Result, std::optional<Result>> {
                   using T = std::decay_t<decltype(action)>;
-                  std::optional<fc::variant> ret_data;
-                  auto params = serializer_p->binary_to_variant(type_name, action.data, abi_yield);
+                  std::optional<Result> ret_data;
+                  auto params = decode(*serializer_p, type_name, action.data, abi_yield);
                   if constexpr (std::is_same_v<T, action_trace_v1>) {
                      if(action.return_value.size() > 0) {
-                        ret_data = serializer_p->binary_to_variant(type_name, action.return_value, abi_yield);
+                        ret_data = decode(*serializer_p, type_name, action.return_value, abi_yield);
                      }
                   }
-                  return {params, ret_data};
+                  return {std::move(params), std::move(ret_data)};
                }, action);
             } catch (...) {
                except_handler(MAKE_EXCEPTION_WITH_CONTEXT(std::current_exception()));
@@ -44,4 +45,17 @@ namespace eosio::trace_api {
 
       return {};
    }
+
+   std::tuple<fc::variant, std::optional<fc::variant>> abi_data_handler::serialize_to_variant(const std::variant<action_trace_v0, action_trace_v1> & action, const yield_function& yield ) {
+      return serialize<fc::variant>(action, yield, [](const chain::abi_serializer& serializer, const std::string& type_name, const auto& data, const auto& abi_yield) {
+         return serializer.binary_to_variant(type_name, data, abi_yield);
+      });
+   }
+
+   std::tuple<std::string, std::optional<std::string>> abi_data_handler::serialize_to_json(const std::variant<action_trace_v0, action_trace_v1> & action, const yield_function& yield ) {
+      // results are complete strings, a failed decode leaves nothing behind in the response
+      return serialize<std::string>(action, yield, [](const chain::abi_serializer& serializer, const std::string& type_name, const auto& data, const auto& abi_yield) {
+         return serializer.binary_to_json(type_name, data, abi_yield);
+      });
+   }
 }
@@ -39,6 +39,13 @@ namespace eosio {
        */
       std::tuple<fc::variant, std::optional<fc::variant>> serialize_to_variant(const std::variant<action_trace_v0, action_trace_v1> & action, const yield_function& yield );
 
+      /**
+       * Same as serialize_to_variant, with the fields written directly as JSON
+       *
+       * @return tuple where the first element is the JSON of the `data` field of the action OR an empty string, and the second element the JSON of the `return_value` field of the trace.
+       */
+      std::tuple<std::string, std::optional<std::string>> serialize_to_json(const std::variant<action_trace_v0, action_trace_v1> & action, const yield_function& yield );
+
       /**
        * Utility class that allows mulitple request_handlers to share the same abi_data_handler
        */
@@ -52,10 +59,18 @@ namespace eosio {
             return handler->serialize_to_variant(action, yield);
          }
 
+         std::tuple<std::string, std::optional<std::string>> serialize_to_json( const std::variant<action_trace_v0, action_trace_v1> & action, const yield_function& yield ) {
+            return handler->serialize_to_json(action, yield);
+         }
+
          std::shared_ptr<abi_data_handler> handler;
       };
 
    private:
+      /// finds the ABI of action and decodes its fields with decode(serializer, type_name, bytes, abi_yield)
+      template<typename Result, typename Decode>
+      std::tuple<Result, std::optional<Result>> serialize(const std::variant<action_trace_v0, action_trace_v1> & action, const yield_function& yield, Decode&& decode );
+
       std::map<chain::name, std::shared_ptr<chain::abi_serializer>> abi_serializer_by_account;
       exception_handler except_handler;
    };
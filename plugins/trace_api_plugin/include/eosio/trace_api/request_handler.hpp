@@ -7,11 +7,41 @@
 
 namespace eosio::trace_api {
    using data_handler_function = std::function<std::tuple<fc::variant, std::optional<fc::variant>>( const std::variant<action_trace_v0, action_trace_v1> & action_trace_t, const yield_function&)>;
+   /// same as data_handler_function with the results already in JSON, an empty string for no params
+   using json_data_handler_function = std::function<std::tuple<std::string, std::optional<std::string>>( const std::variant<action_trace_v0, action_trace_v1> & action_trace_t, const yield_function&)>;
 
    namespace detail {
       class response_formatter {
       public:
          static fc::variant process_block( const data_log_entry& trace, bool irreversible, const data_handler_function& data_handler, const yield_function& yield );
+
+         /**
+          * Writes fc::json::to_string of process_block without building the variant, a piece of about piece_size
+          * at a time so that it can be sent while the rest is written
+          */
+         class block_json_writer {
+         public:
+            static constexpr size_t piece_size = 64*1024;
+
+            block_json_writer( data_log_entry trace, bool irreversible, json_data_handler_function data_handler, yield_function yield );
+
+            /// appends the next piece to `out`, returns false after the last one
+            bool next( std::string& out );
+
+            bool is_irreversible() const { return irreversible; }
+
+            /// approximate memory held by the trace being written
+            size_t held_bytes() const { return trace_size; }
+
+         private:
+            data_log_entry             trace;
+            size_t                     trace_size = 0;
+            bool                       irreversible = false;
+            json_data_handler_function data_handler;
+            yield_function             yield;
+            bool                       started = false;
+            size_t                     next_transaction = 0;
+         };
       };
    }
 
@@ -55,6 +85,53 @@ namespace eosio::trace_api {
          return detail::response_formatter::process_block(std::get<0>(*data), std::get<1>(*data), data_handler, yield);
       }
 
+      /**
+       * Same as get_block_trace, with the trace written directly as JSON
+       *
+       * @param block_height - the height of the block whose trace is requested
+       * @param yield - a yield function to allow cooperation during long running tasks
+       * @return the JSON of the trace for the given block height if it exists, an empty optional otherwise.
+       * @throws yield_exception if a call to `yield` throws.
+       * @throws bad_data_exception when there are issues with the underlying data preventing processing.
+       */
+      std::optional<std::string> get_block_trace_json( uint32_t block_height, const yield_function& yield = {}) {
+         auto writer = get_block_trace_stream(block_height, yield);
+         if (!writer)
+            return {};
+
+         std::string result;
+         while (writer->next(result)) {}
+         return result;
+      }
+
+      /**
+       * Same as get_block_trace_json, with the trace written a piece at a time by the returned writer. The writer
+       * calls `yield` and the data handler provider while writing, both must outlive it.
+       *
+       * @param block_height - the height of the block whose trace is requested
+       * @param yield - a yield function to allow cooperation during long running tasks
+       * @return writer of the JSON of the trace for the given block height if it exists, nullptr otherwise.
+       * @throws yield_exception if a call to `yield` throws.
+       * @throws bad_data_exception when there are issues with the underlying data preventing processing.
+       */
+      std::shared_ptr<detail::response_formatter::block_json_writer> get_block_trace_stream( uint32_t block_height, const yield_function& yield = {}) {
+         auto data = logfile_provider.get_block(block_height, yield);
+         if (!data) {
+            _log("No block found at block height " + std::to_string(block_height) );
+            return {};
+         }
+
+         yield();
+
+         auto data_handler = [this](const auto& action, const yield_function& yield) -> std::tuple<std::string, std::optional<std::string>> {
+            return std::visit([&](const auto& action_trace_t) {
+               return data_handler_provider.serialize_to_json(action_trace_t, yield);
+            }, action);
+         };
+
+         return std::make_shared<detail::response_formatter::block_json_writer>(std::move(std::get<0>(*data)), std::get<1>(*data), std::move(data_handler), yield);
+      }
+
       /**
        * Fetch the trace for a given transaction id and convert it to a fc::variant for conversion to a final format
        * (eg JSON)
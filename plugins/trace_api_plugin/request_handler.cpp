@@ -3,6 +3,8 @@
 #include <algorithm>
 
 #include <fc/variant_object.hpp>
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
 
 namespace {
    using namespace eosio::trace_api;
@@ -123,6 +125,198 @@ namespace {
 
       return result;
    }
+
+   // JSON writers matching fc::json::to_string of the variants built above, field for field
+
+   void append_json( std::string& out, const fc::variant& v ) {
+      out += fc::json::to_string( v, fc::time_point::maximum() );
+   }
+
+   // only for strings that never need escaping: hex, names and timestamps
+   void append_json_string( std::string& out, const std::string& s ) {
+      out += '"';
+      out += s;
+      out += '"';
+   }
+
+   void append_json_key( std::string& out, const char* key ) {
+      out += '"';
+      out += key;
+      out += "\":";
+   }
+
+   void write_authorizations(const std::vector<authorization_trace_v0>& authorizations, const yield_function& yield, std::string& out ) {
+      out += '[';
+      for ( const auto& a: authorizations) {
+         yield();
+
+         if (out.back() != '[') out += ',';
+         out += '{';
+         append_json_key(out, "account");
+         append_json_string(out, a.account.to_string());
+         out += ',';
+         append_json_key(out, "permission");
+         append_json_string(out, a.permission.to_string());
+         out += '}';
+      }
+      out += ']';
+   }
+
+   template<typename ActionTrace>
+   void write_actions(const std::vector<ActionTrace>& actions, const json_data_handler_function& data_handler, const yield_function& yield, std::string& out ) {
+      // create a vector of indices to sort based on actions to avoid copies
+      std::vector<int> indices(actions.size());
+      std::iota(indices.begin(), indices.end(), 0);
+      std::sort(indices.begin(), indices.end(), [&actions](const int& lhs, const int& rhs) -> bool {
+         return actions.at(lhs).global_sequence < actions.at(rhs).global_sequence;
+      });
+      out += '[';
+      for ( int index : indices) {
+         yield();
+
+         const auto& a = actions.at(index);
+         if (out.back() != '[') out += ',';
+         out += '{';
+         append_json_key(out, "global_sequence");
+         append_json(out, fc::variant(a.global_sequence));
+         out += ',';
+         append_json_key(out, "receiver");
+         append_json_string(out, a.receiver.to_string());
+         out += ',';
+         append_json_key(out, "account");
+         append_json_string(out, a.account.to_string());
+         out += ',';
+         append_json_key(out, "action");
+         append_json_string(out, a.action.to_string());
+         out += ',';
+         append_json_key(out, "authorization");
+         write_authorizations(a.authorization, yield, out);
+         out += ',';
+         append_json_key(out, "data");
+         append_json_string(out, fc::to_hex(a.data.data(), a.data.size()));
+         if constexpr(std::is_same_v<ActionTrace, action_trace_v1>){
+            out += ',';
+            append_json_key(out, "return_value");
+            append_json_string(out, fc::to_hex(a.return_value.data(), a.return_value.size()));
+         }
+         auto [params, return_data] = data_handler(a, yield);
+         if (!params.empty()) {
+            out += ',';
+            append_json_key(out, "params");
+            out += params;
+         }
+         if constexpr(std::is_same_v<ActionTrace, action_trace_v1>){
+            if(return_data.has_value()){
+               out += ',';
+               append_json_key(out, "return_data");
+               out += *return_data;
+            }
+         }
+         out += '}';
+      }
+      out += ']';
+   }
+
+   template<typename TransactionTrace>
+   void write_transaction(const TransactionTrace& t, const json_data_handler_function& data_handler, const yield_function& yield, std::string& out ) {
+      out += '{';
+      append_json_key(out, "id");
+      append_json_string(out, t.id.str());
+      if constexpr(std::is_same_v<TransactionTrace, transaction_trace_v3>){
+         out += ',';
+         append_json_key(out, "block_num");
+         append_json(out, fc::variant(t.block_num));
+         out += ',';
+         append_json_key(out, "block_time");
+         append_json(out, fc::variant(t.block_time));
+         out += ',';
+         append_json_key(out, "producer_block_id");
+         append_json(out, fc::variant(t.producer_block_id));
+      }
+      out += ',';
+      append_json_key(out, "actions");
+      if constexpr(std::is_same_v<TransactionTrace, transaction_trace_v0> || std::is_same_v<TransactionTrace, transaction_trace_v1>){
+         write_actions<action_trace_v0>(t.actions, data_handler, yield, out);
+      } else {
+         write_actions<action_trace_v1>(std::get<std::vector<action_trace_v1>>(t.actions), data_handler, yield, out);
+      }
+      if constexpr(!std::is_same_v<TransactionTrace, transaction_trace_v0>){
+         out += ',';
+         append_json_key(out, "status");
+         append_json(out, fc::variant(t.status));
+         out += ',';
+         append_json_key(out, "cpu_usage_us");
+         append_json(out, fc::variant(t.cpu_usage_us));
+         out += ',';
+         append_json_key(out, "net_usage_words");
+         append_json(out, fc::variant(t.net_usage_words));
+         out += ',';
+         append_json_key(out, "signatures");
+         append_json(out, fc::variant(t.signatures));
+         out += ',';
+         append_json_key(out, "transaction_header");
+         append_json(out, fc::variant(t.trx_header));
+      }
+      out += '}';
+   }
+
+   template<typename BlockTrace>
+   void write_block_header(const BlockTrace& block_trace, std::string& out ) {
+      out += ',';
+      append_json_key(out, "transaction_mroot");
+      append_json(out, fc::variant(block_trace.transaction_mroot));
+      out += ',';
+      append_json_key(out, "action_mroot");
+      append_json(out, fc::variant(block_trace.action_mroot));
+      out += ',';
+      append_json_key(out, "schedule_version");
+      append_json(out, fc::variant(block_trace.schedule_version));
+   }
+
+   /// writes the block up to and including the opening bracket of its transactions
+   void write_block_start( const data_log_entry& trace, bool irreversible, std::string& out ) {
+      std::visit([&](auto&& arg) {
+         out += '{';
+         append_json_key(out, "id");
+         append_json_string(out, arg.id.str());
+         out += ',';
+         append_json_key(out, "number");
+         append_json(out, fc::variant(arg.number));
+         out += ',';
+         append_json_key(out, "previous_id");
+         append_json_string(out, arg.previous_id.str());
+         out += ',';
+         append_json_key(out, "status");
+         append_json_string(out, irreversible ? "irreversible" : "pending");
+         out += ',';
+         append_json_key(out, "timestamp");
+         append_json_string(out, to_iso8601_datetime(arg.timestamp));
+         out += ',';
+         append_json_key(out, "producer");
+         append_json_string(out, arg.producer.to_string());
+         if constexpr(!std::is_same_v<std::decay_t<decltype(arg)>, block_trace_v0>) {
+            write_block_header(arg, out);
+         }
+      }, trace);
+      out += ',';
+      append_json_key(out, "transactions");
+      out += '[';
+   }
+
+   /// calls f with the transactions of trace
+   template<typename F>
+   auto with_transactions( const data_log_entry& trace, F&& f ) {
+      return std::visit([&](auto&& arg) {
+         using T = std::decay_t<decltype(arg)>;
+         if constexpr(std::is_same_v<T, block_trace_v0>) {
+            return f(arg.transactions);
+         } else if constexpr(std::is_same_v<T, block_trace_v1>) {
+            return f(arg.transactions_v1);
+         } else {
+            return std::visit(f, arg.transactions);
+         }
+      }, trace);
+   }
 }
 
 namespace eosio::trace_api::detail {
@@ -163,4 +357,33 @@ namespace eosio::trace_api::detail {
           return fc::mutable_variant_object();
        }
     }
+
+    response_formatter::block_json_writer::block_json_writer( data_log_entry trace, bool irreversible, json_data_handler_function data_handler, yield_function yield )
+    :trace(std::move(trace))
+    ,trace_size(fc::raw::pack_size(this->trace))
+    ,irreversible(irreversible)
+    ,data_handler(std::move(data_handler))
+    ,yield(std::move(yield))
+    {}
+
+    bool response_formatter::block_json_writer::next( std::string& out ) {
+       const size_t start = out.size();
+       if (!started) {
+          write_block_start(trace, irreversible, out);
+          started = true;
+       }
+       const bool done = with_transactions(trace, [&](const auto& transactions) {
+          for ( ; next_transaction < transactions.size() && out.size() - start < piece_size; ++next_transaction) {
+             yield();
+
+             if (next_transaction > 0) out += ',';
+             write_transaction(transactions[next_transaction], data_handler, yield, out);
+          }
+          return next_transaction == transactions.size();
+       });
+       if (!done)
+          return true;
+       out += "]}";
+       return false;
+    }
 }
@@ -2,6 +2,7 @@
 #include <boost/test/included/unit_test.hpp>
 
 #include <fc/variant_object.hpp>
+#include <fc/io/json.hpp>
 
 #include <eosio/trace_api/request_handler.hpp>
 #include <eosio/trace_api/test_common.hpp>
@@ -55,6 +56,16 @@ struct response_test_fixture {
          }
       }
 
+      template<typename ActionTrace>
+      std::tuple<std::string, std::optional<std::string>> serialize_to_json(const ActionTrace & action, const yield_function& yield) {
+         auto [params, return_data] = serialize_to_variant(action, yield);
+         std::optional<std::string> return_json;
+         if (return_data) {
+            return_json = fc::json::to_string(*return_data, fc::time_point::maximum());
+         }
+         return {params.is_null() ? std::string() : fc::json::to_string(params, fc::time_point::maximum()), return_json};
+      }
+
       response_test_fixture& fixture;
    };
 
@@ -73,6 +84,14 @@ struct response_test_fixture {
       return response_impl.get_block_trace( block_height, yield );
    }
 
+   std::optional<std::string> get_block_trace_json( uint32_t block_height, const yield_function& yield = {} ) {
+      return response_impl.get_block_trace_json( block_height, yield );
+   }
+
+   auto get_block_trace_stream( uint32_t block_height, const yield_function& yield = {} ) {
+      return response_impl.get_block_trace_stream( block_height, yield );
+   }
+
    // fixture data and methods
    std::function<get_block_t(uint32_t, const yield_function&)> mock_get_block;
    std::function<std::tuple<fc::variant, std::optional<fc::variant>>(const action_trace_v0&, const yield_function&)> mock_data_handler_v0 = default_mock_data_handler_v0;
@@ -1071,4 +1090,141 @@ BOOST_AUTO_TEST_SUITE(trace_responses)
       BOOST_REQUIRE_THROW(get_block_trace( 1, yield ), yield_exception);
    }
 
+   BOOST_FIXTURE_TEST_CASE(json_block_response, response_test_fixture)
+   {
+      auto action_trace_0 = action_trace_v0 {
+         1,
+         "receiver"_n, "contract"_n, "action"_n,
+         {{ "alice"_n, "active"_n }, { "bob"_n, "owner"_n }},
+         { 0x00, 0x01, 0x02, 0x03 }
+      };
+      auto action_trace_1 = action_trace_v1 { action_trace_0, { 0x04, 0x05, 0x06, 0x07 } };
+      action_trace_1.global_sequence = 0;
+
+      auto transaction_trace_1 = transaction_trace_v1 { {
+         "0000000000000000000000000000000000000000000000000000000000000001"_h,
+         { action_trace_0, action_trace_0 }},
+         fc::enum_type<uint8_t, chain::transaction_receipt_header::status_enum>{chain::transaction_receipt_header::status_enum::executed},
+         10,
+         5,
+         std::vector<chain::signature_type>{ chain::signature_type() },
+         { chain::time_point(), 1, 0, 100, 50, 0 }
+      };
+      auto transaction_trace_2 = transaction_trace_v2 {
+         "0000000000000000000000000000000000000000000000000000000000000002"_h,
+         std::vector<action_trace_v1> { action_trace_1, action_trace_0 },
+         fc::enum_type<uint8_t, chain::transaction_receipt_header::status_enum>{chain::transaction_receipt_header::status_enum::soft_fail},
+         10,
+         5,
+         std::vector<chain::signature_type>{},
+         { chain::time_point(), 1, 0, 100, 50, 0 }
+      };
+      auto transaction_trace_3 = transaction_trace_v3 {
+         transaction_trace_2,
+         5,
+         chain::block_timestamp_type(10),
+         "b000000000000000000000000000000000000000000000000000000000000005"_h
+      };
+
+      std::vector<data_log_entry> blocks = {
+         block_trace_v0 {
+            "b000000000000000000000000000000000000000000000000000000000000001"_h,
+            1,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            chain::block_timestamp_type(0),
+            "bp.one"_n,
+            { transaction_trace_v0 { "0000000000000000000000000000000000000000000000000000000000000001"_h, { action_trace_0 } } }
+         },
+         block_trace_v1 {
+            {
+               "b000000000000000000000000000000000000000000000000000000000000001"_h,
+               1,
+               "0000000000000000000000000000000000000000000000000000000000000000"_h,
+               chain::block_timestamp_type(0),
+               "bp.one"_n
+            },
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            0,
+            { transaction_trace_1 }
+         },
+         block_trace_v2 {
+            "b000000000000000000000000000000000000000000000000000000000000001"_h,
+            1,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            chain::block_timestamp_type(0),
+            "bp.one"_n,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            0,
+            std::vector<transaction_trace_v2> { transaction_trace_2, transaction_trace_2 }
+         },
+         block_trace_v2 {
+            "b000000000000000000000000000000000000000000000000000000000000001"_h,
+            1,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            chain::block_timestamp_type(0),
+            "bp.one"_n,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            0,
+            std::vector<transaction_trace_v3> { transaction_trace_3 }
+         }
+      };
+
+      for (const auto& block : blocks) {
+         for (bool irreversible : { false, true }) {
+            mock_get_block = [&block, irreversible]( uint32_t height, const yield_function& ) -> get_block_t {
+               BOOST_TEST(height == 1);
+               return std::make_tuple(block, irreversible);
+            };
+
+            fc::variant response = get_block_trace( 1 );
+            auto json_response = get_block_trace_json( 1 );
+            BOOST_REQUIRE(json_response);
+            BOOST_TEST(*json_response == fc::json::to_string(response, fc::time_point::maximum()));
+         }
+      }
+
+      // actions without params
+      mock_data_handler_v0 = [](const action_trace_v0&, const yield_function&) -> std::tuple<fc::variant, std::optional<fc::variant>> { return {}; };
+      mock_data_handler_v1 = [](const action_trace_v1&, const yield_function&) -> std::tuple<fc::variant, std::optional<fc::variant>> { return {}; };
+      BOOST_TEST(*get_block_trace_json( 1 ) == fc::json::to_string(get_block_trace( 1 ), fc::time_point::maximum()));
+
+      // a large block is written in several pieces
+      auto large_block = block_trace_v1 {
+         {
+            "b000000000000000000000000000000000000000000000000000000000000001"_h,
+            1,
+            "0000000000000000000000000000000000000000000000000000000000000000"_h,
+            chain::block_timestamp_type(0),
+            "bp.one"_n
+         },
+         "0000000000000000000000000000000000000000000000000000000000000000"_h,
+         "0000000000000000000000000000000000000000000000000000000000000000"_h,
+         0,
+         std::vector<transaction_trace_v1>( 1000, transaction_trace_1 )
+      };
+      mock_get_block = [&large_block]( uint32_t, const yield_function& ) -> get_block_t {
+         return std::make_tuple(data_log_entry(large_block), true);
+      };
+      auto writer = get_block_trace_stream( 1 );
+      BOOST_REQUIRE(writer);
+      std::string json;
+      size_t pieces = 0;
+      for (bool more = true; more; ++pieces) {
+         std::string piece;
+         more = writer->next(piece);
+         if (more)
+            BOOST_TEST(piece.size() >= detail::response_formatter::block_json_writer::piece_size);
+         json += piece;
+      }
+      BOOST_TEST(pieces > 1u);
+      BOOST_TEST(json == fc::json::to_string(get_block_trace( 1 ), fc::time_point::maximum()));
+
+      mock_get_block = []( uint32_t, const yield_function& ) -> get_block_t { return {}; };
+      BOOST_TEST(!get_block_trace_json( 1 ));
+      BOOST_TEST(!get_block_trace_stream( 1 ));
+   }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -247,6 +247,8 @@ struct trace_api_rpc_plugin_impl : public std::enable_shared_from_this<trace_api
       auto& http = app().get_plugin<http_plugin>();
       fc::microseconds max_response_time = http.get_max_response_time();
 
+      // traces of irreversible blocks never change
+      http.add_cached_url("/v1/trace_api/get_block");
       http.add_async_handler("/v1/trace_api/get_block",
             [wthis=weak_from_this(), max_response_time](std::string, std::string body, url_response_callback cb)
       {
@@ -280,13 +282,18 @@ struct trace_api_rpc_plugin_impl : public std::enable_shared_from_this<trace_api
 
          try {
 
-            const auto deadline = that->calc_deadline( max_response_time );
-            auto resp = that->req_handler->get_block_trace(*block_number, [deadline]() { FC_CHECK_DEADLINE(deadline); });
-            if (resp.is_null()) {
+            // each piece of the response gets max_response_time, the whole of a large block may take longer
+            auto deadline = std::make_shared<fc::time_point>( that->calc_deadline( max_response_time ) );
+            auto writer = that->req_handler->get_block_trace_stream(*block_number, [deadline]() { FC_CHECK_DEADLINE(*deadline); });
+            if (!writer) {
                error_results results{404, "Trace API: block trace missing"};
                cb( 404, fc::variant( results ));
             } else {
-               cb( 200, std::move(resp) );
+               const bool immutable = writer->is_irreversible();
+               cb( 200, chunked_body{ [that, writer, deadline, max_response_time](std::string& out) {
+                  *deadline = that->calc_deadline( max_response_time );
+                  return writer->next( out );
+               }, immutable, writer->held_bytes() } );
             }
          } catch (...) {
             http_plugin::handle_exception("trace_api", "get_block", body, cb);
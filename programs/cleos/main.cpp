@@ -3063,6 +3063,8 @@ int main( int argc, char** argv ) {
    string index_position;
    bool reverse = false;
    bool show_payer = false;
+   bool keys_only = false;
+   vector<string> fields;
    auto getTable = get->add_subcommand( "table", localized("Retrieve the contents of a database table"));
    getTable->add_option( "account", code, localized("The account who owns the table") )->required();
    getTable->add_option( "scope", scope, localized("The scope within the contract in which the table is found") )->required();
@@ -3083,6 +3085,8 @@ int main( int argc, char** argv ) {
    getTable->add_flag("-b,--binary", binary, localized("Return the value as BINARY rather than using abi to interpret as JSON"));
    getTable->add_flag("-r,--reverse", reverse, localized("Iterate in reverse order"));
    getTable->add_flag("--show-payer", show_payer, localized("Show RAM payer"));
+   getTable->add_flag("--keys-only", keys_only, localized("Return only the primary and secondary keys of the rows"));
+   getTable->add_option("--fields", fields, localized("Return only these fields of the rows"));
 
 
    getTable->callback([&] {
@@ -3099,6 +3103,8 @@ int main( int argc, char** argv ) {
                          ("encode_type", encode_type)
                          ("reverse", reverse)
                          ("show_payer", show_payer)
+                         ("keys_only", keys_only)
+                         ("fields", fields)
                          );
 
       std::cout << fc::json::to_pretty_string(result)
@@ -248,6 +248,26 @@ BOOST_FIXTURE_TEST_CASE( get_account, TESTER ) try {
          BOOST_REQUIRE_EQUAL(name("foo"_n), la.action.value());
       }
    }
+
+   // batch: same as get_account of each, in order
+   chain_apis::read_only::get_accounts_params batch{ { "bob"_n, "alice"_n, "cindy"_n } };
+   auto batch_result = plugin.read_only::get_accounts(batch);
+   BOOST_REQUIRE_EQUAL(3u, batch_result.accounts.size());
+   BOOST_REQUIRE(!batch_result.more);
+   for (size_t i = 0; i < batch.account_names.size(); ++i) {
+      BOOST_REQUIRE_EQUAL(fc::json::to_string(plugin.read_only::get_account({batch.account_names[i]}), fc::time_point::maximum()),
+                          fc::json::to_string(batch_result.accounts[i], fc::time_point::maximum()));
+   }
+
+   batch.account_names.push_back("nobody"_n);
+   BOOST_CHECK_THROW(plugin.read_only::get_accounts(batch), fc::exception);
+   batch.account_names.assign(chain_apis::read_only::default_max_batch_size + 1, "alice"_n);
+   BOOST_CHECK_THROW(plugin.read_only::get_accounts(batch), invalid_http_request);
+   plugin.set_max_batch_size(2);
+   batch.account_names.resize(2);
+   BOOST_REQUIRE_EQUAL(2u, plugin.read_only::get_accounts(batch).accounts.size());
+   batch.account_names.resize(3, "alice"_n);
+   BOOST_CHECK_THROW(plugin.read_only::get_accounts(batch), invalid_http_request);
 } FC_LOG_AND_RETHROW() /// get_account
 
 BOOST_AUTO_TEST_SUITE_END()
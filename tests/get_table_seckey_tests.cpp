@@ -95,4 +95,78 @@ BOOST_FIXTURE_TEST_CASE( get_table_next_key_test, TESTER ) try {
 
 } FC_LOG_AND_RETHROW() /// get_table_next_key_test
 
+BOOST_FIXTURE_TEST_CASE( get_table_keys_only_and_fields_test, TESTER ) try {
+   create_account("test"_n);
+
+   // setup contract and abi
+   set_code( "test"_n, contracts::get_table_seckey_test_wasm() );
+   set_abi( "test"_n, contracts::get_table_seckey_test_abi().data() );
+   produce_block();
+
+   push_action("test"_n, "addnumobj"_n, "test"_n, mutable_variant_object()("input", 2)("nm", "a"));
+   push_action("test"_n, "addnumobj"_n, "test"_n, mutable_variant_object()("input", 5)("nm", "b"));
+   push_action("test"_n, "addnumobj"_n, "test"_n, mutable_variant_object()("input", 7)("nm", "c"));
+
+   chain_apis::read_only plugin(*(this->control), {}, fc::microseconds::maximum(), {}, {});
+   chain_apis::read_only::get_table_rows_params params{};
+   params.json = true;
+   params.code = "test"_n;
+   params.scope = "test";
+   params.table = "numobjs"_n;
+   params.limit = 10;
+
+   auto rows_json = [&]() {
+      auto result = plugin.get_table_rows(params);
+      // the streamed JSON is the same as the JSON of the variant result
+      BOOST_REQUIRE_EQUAL( fc::json::to_string( result, fc::time_point::maximum() ), plugin.get_table_rows_json(params) );
+      return fc::json::to_string( result.rows, fc::time_point::maximum() );
+   };
+
+   // keys of the primary index
+   params.keys_only = true;
+   BOOST_REQUIRE_EQUAL( R"([{"primary_key":"0"},{"primary_key":"1"},{"primary_key":"2"}])", rows_json() );
+   params.show_payer = true;
+   BOOST_REQUIRE_EQUAL( R"([{"primary_key":"0","payer":"test"},{"primary_key":"1","payer":"test"},{"primary_key":"2","payer":"test"}])", rows_json() );
+   params.show_payer = false;
+
+   // keys of a secondary index, in reverse
+   params.index_position = "2";
+   params.key_type = "i64";
+   params.lower_bound = "3";
+   params.upper_bound = "7";
+   params.reverse = true;
+   BOOST_REQUIRE_EQUAL( R"([{"primary_key":"2","secondary_key":"7"},{"primary_key":"1","secondary_key":"5"}])", rows_json() );
+   params.limit = 1;
+   auto res = plugin.get_table_rows(params);
+   BOOST_REQUIRE_EQUAL( 1u, res.rows.size() );
+   BOOST_REQUIRE( res.more );
+   BOOST_REQUIRE_EQUAL( "5", res.next_key );
+   params.limit = 10;
+
+   // selected fields, in the order of the row
+   params.keys_only = false;
+   params.fields = { "nm", "key" };
+   BOOST_REQUIRE_EQUAL( R"([{"key":2,"nm":"c"},{"key":1,"nm":"b"}])", rows_json() );
+   params.show_payer = true;
+   BOOST_REQUIRE_EQUAL( R"([{"data":{"key":2,"nm":"c"},"payer":"test"},{"data":{"key":1,"nm":"b"},"payer":"test"}])", rows_json() );
+
+   params.show_payer = false;
+
+   // a field named twice is written once
+   params.fields = { "nm", "key", "nm" };
+   BOOST_REQUIRE_EQUAL( R"([{"key":2,"nm":"c"},{"key":1,"nm":"b"}])", rows_json() );
+   // a field the row does not have is an error
+   params.fields = { "nm", "nosuchfield" };
+   BOOST_CHECK_THROW( plugin.get_table_rows(params), contract_table_query_exception );
+   BOOST_CHECK_THROW( plugin.get_table_rows_json(params), contract_table_query_exception );
+   params.fields = { "nm", "key" };
+
+   params.keys_only = true;
+   BOOST_CHECK_THROW( plugin.get_table_rows(params), contract_table_query_exception );
+   params.keys_only = false;
+   params.json = false;
+   BOOST_CHECK_THROW( plugin.get_table_rows(params), contract_table_query_exception );
+
+} FC_LOG_AND_RETHROW() /// get_table_keys_only_and_fields_test
+
 BOOST_AUTO_TEST_SUITE_END()
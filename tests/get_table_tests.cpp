@@ -311,6 +311,52 @@ BOOST_FIXTURE_TEST_CASE( get_table_test, TESTER ) try {
       BOOST_REQUIRE_EQUAL("7777.0000 CCC", result.rows[0]["balance"].as_string());
    }
 
+   // get table as JSON: same as the JSON of the variant result
+   auto check_json = [&]() {
+      BOOST_REQUIRE_EQUAL( fc::json::to_string( plugin.read_only::get_table_rows(p), fc::time_point::maximum() ),
+                           plugin.read_only::get_table_rows_json(p) );
+   };
+   p.lower_bound = p.upper_bound = "";
+   p.limit = 10;
+   p.reverse = false;
+   check_json();
+   p.limit = 2;
+   check_json();
+   p.show_payer = true;
+   check_json();
+   p.json = false;
+   check_json();
+   p.scope = "initz";
+   check_json();
+
+   // get tables in one batch: the JSON of each query, in order
+   eosio::chain_apis::read_only::get_table_rows_batch_params batch;
+   BOOST_REQUIRE_EQUAL( "{\"results\":[]}", plugin.read_only::get_table_rows_batch_json(batch) );
+   p.json = true;
+   for( auto scope : { "inita", "initb", "initz" } ) {
+      p.scope = scope;
+      batch.queries.push_back( p );
+   }
+   p.json = false;
+   p.scope = "initc";
+   batch.queries.push_back( p );
+   std::string expected = "{\"results\":[";
+   for( const auto& q : batch.queries ) {
+      if( expected.back() != '[' ) expected += ',';
+      expected += plugin.read_only::get_table_rows_json(q);
+   }
+   expected += "]}";
+   BOOST_REQUIRE_EQUAL( expected, plugin.read_only::get_table_rows_batch_json(batch) );
+
+   batch.queries.assign( eosio::chain_apis::read_only::default_max_batch_size + 1, batch.queries[0] );
+   BOOST_CHECK_THROW( plugin.read_only::get_table_rows_batch_json(batch), invalid_http_request );
+   plugin.set_max_batch_size( 2 );
+   batch.queries.resize( 2 );
+   BOOST_CHECK_NO_THROW( plugin.read_only::get_table_rows_batch_json(batch) );
+   batch.queries.resize( 3, batch.queries[0] );
+   BOOST_CHECK_THROW( plugin.read_only::get_table_rows_batch_json(batch), invalid_http_request );
+   plugin.set_max_batch_size( eosio::chain_apis::read_only::default_max_batch_size );
+
 } FC_LOG_AND_RETHROW()
 
 BOOST_FIXTURE_TEST_CASE( get_table_by_seckey_test, TESTER ) try {
@@ -3041,4 +3041,151 @@ BOOST_AUTO_TEST_CASE(abi_to_variant__add_action__no_return_value)
    BOOST_CHECK_EQUAL(res, expected_json);
 }
 
+BOOST_AUTO_TEST_CASE(abi_serializer_copy)
+{
+   using eosio::testing::fc_exception_message_starts_with;
+
+   auto abi = R"({
+      "version": "eosio::abi/1.1",
+      "types": [
+         {"new_type_name": "node_ptr", "type": "node?"}
+      ],
+      "structs": [
+         {"name": "base", "base": "", "fields": [
+            {"name": "id", "type": "uint64"}
+         ]},
+         {"name": "node", "base": "base", "fields": [
+            {"name": "next", "type": "node_ptr"},
+            {"name": "value", "type": "v"},
+            {"name": "ext", "type": "string$"}
+         ]}
+      ],
+      "variants": [
+         {"name": "v", "types": ["uint8", "node[]"]}
+      ]
+   })";
+   auto var = fc::json::from_string(R"({"id": 1, "next": {"id": 2, "next": null, "value": ["uint8", 3], "ext": ""}, "value": ["node[]", []], "ext": "e"})");
+
+   std::optional<abi_serializer> copy;
+   {
+      abi_serializer abis(fc::json::from_string(abi).as<abi_def>(), abi_serializer::create_yield_function(max_serialization_time));
+      copy = abis;
+   }
+   verify_byte_round_trip_conversion(*copy, "node", var);
+
+   abi_serializer assigned;
+   assigned = *copy;
+   copy.reset();
+   verify_byte_round_trip_conversion(assigned, "node_ptr", var);
+
+   // types only reachable from outside the ABI
+   verify_byte_round_trip_conversion(assigned, "node_ptr[]", fc::json::from_string(R"([null, {"id": 1, "next": null, "value": ["uint8", 3], "ext": ""}])"));
+   verify_byte_round_trip_conversion(assigned, "uint16[]", fc::json::from_string("[1, 2]"));
+   BOOST_CHECK_EXCEPTION( assigned.binary_to_variant("none[]", bytes{1}, abi_serializer::create_yield_function(max_serialization_time)),
+                          invalid_type_inside_abi, fc_exception_message_starts_with("Unknown type none") );
+}
+
+BOOST_AUTO_TEST_CASE(binary_to_json)
+{
+   auto abi = R"({
+      "version": "eosio::abi/1.1",
+      "types": [
+         {"new_type_name": "account", "type": "name"}
+      ],
+      "structs": [
+         {"name": "base", "base": "", "fields": [
+            {"name": "id", "type": "uint64"},
+            {"name": "memo", "type": "string"}
+         ]},
+         {"name": "derived", "base": "base", "fields": [
+            {"name": "memo", "type": "string"}
+         ]},
+         {"name": "row", "base": "base", "fields": [
+            {"name": "flag", "type": "bool"},
+            {"name": "small", "type": "int8"},
+            {"name": "counts", "type": "uint16[]"},
+            {"name": "big", "type": "int64"},
+            {"name": "var", "type": "varint32"},
+            {"name": "uvar", "type": "varuint32"},
+            {"name": "owner", "type": "account"},
+            {"name": "owners", "type": "account[]"},
+            {"name": "balance", "type": "asset"},
+            {"name": "data", "type": "bytes"},
+            {"name": "hash", "type": "checksum256?"},
+            {"name": "value", "type": "v"},
+            {"name": "children", "type": "derived[]"},
+            {"name": "ext", "type": "uint32$"}
+         ]}
+      ],
+      "variants": [
+         {"name": "v", "types": ["uint32", "derived"]}
+      ]
+   })";
+   abi_serializer abis(fc::json::from_string(abi).as<abi_def>(), abi_serializer::create_yield_function(max_serialization_time));
+
+   auto check = [&](const type_name& type, const std::string& json) {
+      auto bin = abis.variant_to_binary(type, fc::json::from_string(json), abi_serializer::create_yield_function(max_serialization_time));
+      auto var = abis.binary_to_variant(type, bin, abi_serializer::create_yield_function(max_serialization_time));
+      BOOST_TEST( abis.binary_to_json(type, bin, abi_serializer::create_yield_function(max_serialization_time)) ==
+                  fc::json::to_string(var, fc::time_point::maximum()) );
+   };
+
+   check("row", R"({"id": "18446744073709551615", "memo": "quote \" and \\ and \n", "flag": 1, "small": -128, "counts": [1, 65535],
+                    "big": "-9223372036854775808", "var": -5, "uvar": 4294967295, "owner": "alice", "owners": ["bob", ""],
+                    "balance": "1.0000 SYS", "data": "00ff", "hash": null,
+                    "value": ["uint32", 7], "children": [{"id": 1, "memo": "a"}, {"id": 2, "memo": "b"}], "ext": 9})");
+   check("row", R"({"id": 0, "memo": "", "flag": 0, "small": 1, "counts": [], "big": 5, "var": 0, "uvar": 0, "owner": "",
+                    "owners": [], "balance": "0.0000 SYS", "data": "", "hash": "0000000000000000000000000000000000000000000000000000000000000001",
+                    "value": ["derived", {"id": 3, "memo": "c"}], "children": []})");
+   check("derived[]", R"([{"id": 1, "memo": "x"}])");
+   check("account", R"("eosio.token")");
+   check("uint8[]", "[1, 2, 3]");
+
+   // same errors as binary_to_variant
+   auto bin = abis.variant_to_binary("derived", fc::json::from_string(R"({"id": 1, "memo": "x"})"), abi_serializer::create_yield_function(max_serialization_time));
+   bin.resize(bin.size() - 1);
+   BOOST_CHECK_THROW( abis.binary_to_json("derived", bin, abi_serializer::create_yield_function(max_serialization_time)), unpack_exception );
+
+   // selected fields, in the order of the struct
+   auto select = [&](const std::string& json, const vector<string>& fields) {
+      auto bin = abis.variant_to_binary("row", fc::json::from_string(json), abi_serializer::create_yield_function(max_serialization_time));
+      fc::datastream<const char*> ds( bin.data(), bin.size() );
+      std::string out;
+      abis.binary_to_json("row", ds, out, fields, abi_serializer::create_yield_function(max_serialization_time));
+      return out;
+   };
+   const std::string row = R"({"id": 7, "memo": "m", "flag": 1, "small": 1, "counts": [2], "big": 5, "var": 0, "uvar": 0, "owner": "alice",
+                              "owners": [], "balance": "1.0000 SYS", "data": "", "hash": null, "value": ["uint32", 7], "children": []})";
+   BOOST_TEST( select(row, {"owner", "id"}) == R"({"id":7,"owner":"alice"})" );
+   BOOST_TEST( select(row, {"balance"}) == R"({"balance":"1.0000 SYS"})" );
+   BOOST_TEST( select(row, {"unknown"}) == "{}" );
+   BOOST_TEST( select(row, {}) == "{}" );
+   // the fields before the selected ones are read past without their JSON, whatever their type
+   const std::string full_row = R"({"id": 1, "memo": "quote", "flag": 1, "small": -128, "counts": [1, 65535], "big": 5, "var": -5,
+                                   "uvar": 4294967295, "owner": "alice", "owners": ["bob", ""], "balance": "1.0000 SYS", "data": "00ff",
+                                   "hash": "0000000000000000000000000000000000000000000000000000000000000001",
+                                   "value": ["derived", {"id": 3, "memo": "c"}], "children": [{"id": 2, "memo": "b"}], "ext": 9})";
+   BOOST_TEST( select(full_row, {"ext"}) == R"({"ext":9})" );
+   BOOST_TEST( select(full_row, {"children", "memo"}) == R"({"memo":"quote","children":[{"id":2,"memo":"b"}]})" );
+   BOOST_TEST( select(row, {"children"}) == R"({"children":[]})" );
+   // a truncated field is detected while reading past it
+   bin = abis.variant_to_binary("row", fc::json::from_string(row), abi_serializer::create_yield_function(max_serialization_time));
+   bin.resize(bin.size() - 3);
+   {
+      fc::datastream<const char*> ds( bin.data(), bin.size() );
+      std::string out;
+      BOOST_CHECK_THROW( abis.binary_to_json("row", ds, out, {"children"}, abi_serializer::create_yield_function(max_serialization_time)),
+                         unpack_exception );
+   }
+   // unpacking stops after the last selected field, the rest of the row is not read
+   bin = abis.variant_to_binary("base", fc::json::from_string(R"({"id": 7, "memo": "m"})"), abi_serializer::create_yield_function(max_serialization_time));
+   fc::datastream<const char*> ds( bin.data(), bin.size() );
+   std::string out;
+   abis.binary_to_json("row", ds, out, {"id"}, abi_serializer::create_yield_function(max_serialization_time));
+   BOOST_TEST( out == R"({"id":7})" );
+   ds = fc::datastream<const char*>( bin.data(), bin.size() );
+   out.clear();
+   BOOST_CHECK_THROW( abis.binary_to_json("account", ds, out, {"id"}, abi_serializer::create_yield_function(max_serialization_time)), abi_exception );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -333,6 +333,85 @@ BOOST_AUTO_TEST_CASE(link_then_update_auth) { try {
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE(check_cache_invalidation) { try {
+   TESTER chain;
+
+   chain.create_accounts({name("alice"),name("bob")});
+   chain.set_authority(name("alice"), name("first"), authority(permission_level{"bob"_n, config::active_name}), name("active"));
+   chain.produce_block();
+
+   const auto& authorization = chain.control->get_authorization_manager();
+   const action act( { permission_level{"alice"_n, name("first")} }, config::system_account_name, name("reqauth"), bytes() );
+   const flat_set<permission_level> provided = { permission_level{"bob"_n, config::active_name} };
+   authorization_manager::check_cache cache;
+   auto check = [&]() {
+      authorization.check_authorization( {act}, {}, provided, fc::microseconds(0), {}, false, false, {}, &cache );
+   };
+
+   // nothing cached for a failed check
+   BOOST_CHECK_THROW( check(), irrelevant_auth_exception );
+   BOOST_TEST( cache.relevant.empty() );
+   BOOST_TEST( cache.satisfied.empty() );
+
+   chain.link_authority(name("alice"), name("eosio"), name("first"), name("reqauth"));
+   check();
+   BOOST_TEST( cache.relevant.size() == 1u );
+   BOOST_TEST( cache.satisfied.size() == 1u );
+   check();
+
+   // unlinking drops the cached relevance
+   chain.unlink_authority(name("alice"), name("eosio"), name("reqauth"));
+   BOOST_CHECK_THROW( check(), irrelevant_auth_exception );
+
+   chain.link_authority(name("alice"), name("eosio"), name("first"), name("reqauth"));
+   check();
+
+   // updating the permission drops the cached satisfaction
+   chain.set_authority(name("alice"), name("first"), authority(chain.get_public_key(name("alice"), "first")), name("active"));
+   BOOST_CHECK_THROW( check(), unsatisfied_authorization );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE(minimum_permission_invalidation) { try {
+   TESTER chain;
+
+   chain.create_accounts({name("alice"),name("bob")});
+   chain.set_authority(name("alice"), name("first"), authority(permission_level{"bob"_n, config::active_name}), name("active"));
+   chain.produce_block();
+
+   const auto& authorization = chain.control->get_authorization_manager();
+   const action act( { permission_level{"alice"_n, name("first")} }, config::system_account_name, name("reqauth"), bytes() );
+   const flat_set<permission_level> provided = { permission_level{"bob"_n, config::active_name} };
+   auto check = [&]() {
+      authorization.check_authorization( {act}, {}, provided, fc::microseconds(0), {}, false );
+   };
+
+   // the minimum permission of reqauth is active, which "first" does not satisfy
+   BOOST_CHECK_THROW( check(), irrelevant_auth_exception );
+
+   chain.link_authority(name("alice"), name("eosio"), name("first"), name("reqauth"));
+   check();
+   // kept across blocks
+   chain.produce_block();
+   check();
+
+   chain.unlink_authority(name("alice"), name("eosio"), name("reqauth"));
+   BOOST_CHECK_THROW( check(), irrelevant_auth_exception );
+   chain.produce_block();
+   BOOST_CHECK_THROW( check(), irrelevant_auth_exception );
+
+   // a contract wide link of another account does not affect alice
+   chain.link_authority(name("bob"), name("eosio"), name("active"));
+   BOOST_CHECK_THROW( check(), irrelevant_auth_exception );
+
+   // the link is undone with the aborted block
+   chain.link_authority(name("alice"), name("eosio"), name("first"), name("reqauth"));
+   check();
+   chain.control->abort_block();
+   BOOST_CHECK_THROW( check(), irrelevant_auth_exception );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE(create_account) {
 try {
    TESTER chain;
@@ -776,6 +776,30 @@ static const char memory_growth_memset_test[] = R"=====(
 )
 )=====";
 
+// grows memory by ${PAGES} pages, asserts that memory reads as zero and dirties it, every 512 bytes so every OS page
+static const char memory_growth_dirty[] = R"=====(
+(module
+ (export "apply" (func $$apply))
+ (import "env" "eosio_assert" (func $$eosio_assert (param i32 i32)))
+ (memory $$0 1)
+ (func $$apply (param $$0 i64)(param $$1 i64)(param $$2 i64)
+   (local $$i i32)
+   (local $$end i32)
+   (drop (grow_memory (i32.const ${PAGES})))
+   (set_local $$end (i32.mul (current_memory) (i32.const 65536)))
+   (block $$done
+     (loop $$next
+       (br_if $$done (i32.ge_u (get_local $$i) (get_local $$end)))
+       (call $$eosio_assert (i32.eqz (i32.load (get_local $$i))) (i32.const 0))
+       (i32.store (get_local $$i) (i32.const -1))
+       (set_local $$i (i32.add (get_local $$i) (i32.const 512)))
+       (br $$next)
+     )
+   )
+ )
+)
+)=====";
+
 static const char large_maligned_host_ptr[] = R"=====(
 (module
  (export "apply" (func $$apply))
@@ -0,0 +1,134 @@
+#include <eosio/testing/tester.hpp>
+#include <eosio/chain/account_object.hpp>
+#include <eosio/chain/wasm_interface.hpp>
+
+#include <fc/variant_object.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <contracts.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+#ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
+
+namespace {
+
+// EOS VM OC tier-up on top of the interpreter, whatever runtime the suite was started with
+auto oc_tierup( const std::function<void(eosvmoc::config&)>& edit ) {
+   return [edit]( controller::config& cfg ) {
+      cfg.wasm_runtime = wasm_interface::vm_type::eos_vm;
+      cfg.eosvmoc_tierup = true;
+      edit( cfg.eosvmoc_config );
+   };
+}
+
+digest_type deploy_payloadless( tester& chain ) {
+   chain.create_accounts( {"payloadless"_n} );
+   chain.set_code( "payloadless"_n, contracts::payloadless_wasm() );
+   chain.set_abi( "payloadless"_n, contracts::payloadless_abi().data() );
+   chain.produce_block();
+   return chain.control->db().get<account_metadata_object,by_name>( "payloadless"_n ).code_hash;
+}
+
+void run_payloadless( tester& chain ) {
+   chain.push_action( "payloadless"_n, "doit"_n, "payloadless"_n, fc::mutable_variant_object() );
+   chain.produce_block();
+}
+
+// compiles finish asynchronously and are only picked up when a contract is executed
+bool run_payloadless_until_cached( tester& chain, const digest_type& code_hash ) {
+   for( int i = 0; i < 1000; ++i ) {
+      run_payloadless( chain );
+      if( chain.control->get_wasm_interface().eosvmoc_is_code_cached( code_hash, 0 ) )
+         return true;
+      std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+   }
+   return false;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(eosvmoc_tests)
+
+// contracts executed before a restart are compiled while the node starts, before they are executed again
+BOOST_AUTO_TEST_CASE( warmup_compiles_recently_used ) try {
+   fc::temp_directory tempdir;
+   digest_type code_hash;
+   {
+      // thresholds keep the contract from being compiled on use
+      tester chain( tempdir, oc_tierup( []( eosvmoc::config& oc ) { oc.tierup_executions = 1000; } ), true );
+      code_hash = deploy_payloadless( chain );
+      run_payloadless( chain );
+      BOOST_TEST( !chain.control->get_wasm_interface().eosvmoc_is_code_cached( code_hash, 0 ) );
+   }
+   {
+      tester chain( tempdir, oc_tierup( []( eosvmoc::config& oc ) { oc.tierup_executions = 1000; } ), false );
+      BOOST_TEST( !chain.control->get_wasm_interface().eosvmoc_is_code_cached( code_hash, 0 ) );
+   }
+   {
+      tester chain( tempdir, oc_tierup( []( eosvmoc::config& oc ) {
+         oc.tierup_executions = 1000;
+         oc.warmup_contracts = 1;
+      } ), false );
+      BOOST_TEST( chain.control->get_wasm_interface().eosvmoc_is_code_cached( code_hash, 0 ) );
+   }
+} FC_LOG_AND_RETHROW()
+
+// with eos-vm-oc-tierup-executions a contract is only compiled once it ran that many times on the base runtime
+BOOST_AUTO_TEST_CASE( tierup_executions_threshold ) try {
+   fc::temp_directory tempdir;
+   tester chain( tempdir, oc_tierup( []( eosvmoc::config& oc ) { oc.tierup_executions = 3; } ), true );
+   const digest_type code_hash = deploy_payloadless( chain );
+
+   // a compile started by the first execution would be done long before the second one picks up its result
+   run_payloadless( chain );
+   std::this_thread::sleep_for( std::chrono::seconds( 1 ) );
+   run_payloadless( chain );
+   BOOST_TEST( !chain.control->get_wasm_interface().eosvmoc_is_code_cached( code_hash, 0 ) );
+
+   // the third execution starts the compile
+   BOOST_TEST( run_payloadless_until_cached( chain, code_hash ) );
+} FC_LOG_AND_RETHROW()
+
+// code compiled by one node is exported to a shared directory and used by another node without compiling it again
+BOOST_AUTO_TEST_CASE( export_import ) try {
+   fc::temp_directory shared_dir;
+   fc::temp_directory exporter_dir;
+   digest_type code_hash;
+   auto exporter_config = oc_tierup( [&]( eosvmoc::config& oc ) { oc.export_dir = shared_dir.path(); } );
+   {
+      tester chain( exporter_dir, exporter_config, true );
+      code_hash = deploy_payloadless( chain );
+      BOOST_REQUIRE( run_payloadless_until_cached( chain, code_hash ) );
+   }
+   {
+      // compiles are exported from a background thread, what is cached at startup is exported before it returns
+      tester chain( exporter_dir, exporter_config, false );
+   }
+   size_t exported = 0;
+   for( const auto& de : boost::filesystem::recursive_directory_iterator( shared_dir.path() ) )
+      if( de.path().extension() == ".eosvmoc" )
+         ++exported;
+   BOOST_TEST( exported == 1u );
+
+   fc::temp_directory importer_dir;
+   tester chain( importer_dir, oc_tierup( [&]( eosvmoc::config& oc ) {
+      oc.import_dir = shared_dir.path();
+      oc.tierup_executions = 1000;
+   } ), true );
+   BOOST_TEST( deploy_payloadless( chain ) == code_hash );
+   BOOST_TEST( chain.control->get_wasm_interface().eosvmoc_is_code_cached( code_hash, 0 ) );
+   // and runs from the imported code
+   auto trace = chain.push_action( "payloadless"_n, "doit"_n, "payloadless"_n, fc::mutable_variant_object() );
+   BOOST_TEST( trace->action_traces.front().console == "Im a payloadless action" );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
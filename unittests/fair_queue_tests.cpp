@@ -0,0 +1,72 @@
+#include <eosio/chain/fair_queue.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eosio;
+using namespace chain;
+
+BOOST_AUTO_TEST_SUITE(fair_queue_tests)
+
+BOOST_AUTO_TEST_CASE(empty_test) {
+   fair_queue<std::string, int> q;
+   BOOST_TEST( !q.pop() );
+   BOOST_TEST( q.size() == 0u );
+   BOOST_TEST( q.keys() == 0u );
+}
+
+BOOST_AUTO_TEST_CASE(takes_turns_test) {
+   fair_queue<std::string, int> q;
+   // a floods the queue before b and c arrive
+   for( int i = 0; i < 5; ++i )
+      q.push( "a", i );
+   q.push( "b", 10 );
+   q.push( "c", 20 );
+   q.push( "b", 11 );
+   BOOST_TEST( q.size() == 8u );
+   BOOST_TEST( q.keys() == 3u );
+
+   std::vector<int> order;
+   while( auto item = q.pop() )
+      order.push_back( *item );
+   const std::vector<int> expected{ 0, 10, 20, 1, 11, 2, 3, 4 };
+   BOOST_TEST( order == expected, boost::test_tools::per_element() );
+   BOOST_TEST( q.size() == 0u );
+   BOOST_TEST( q.keys() == 0u );
+}
+
+BOOST_AUTO_TEST_CASE(key_returns_test) {
+   fair_queue<std::string, int> q;
+   q.push( "a", 1 );
+   q.push( "b", 2 );
+   BOOST_TEST( *q.pop() == 1 );
+   // a was dropped when empty, it queues behind b again
+   q.push( "a", 3 );
+   BOOST_TEST( *q.pop() == 2 );
+   BOOST_TEST( *q.pop() == 3 );
+   BOOST_TEST( !q.pop() );
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_test) {
+   fair_queue<int, int> q;
+   std::atomic<int> popped = 0;
+   std::vector<std::thread> threads;
+   for( int t = 0; t < 4; ++t ) {
+      threads.emplace_back( [&q, &popped, t]() {
+         for( int i = 0; i < 10000; ++i ) {
+            q.push( t, i );
+            if( q.pop() ) ++popped;
+         }
+      } );
+   }
+   for( auto& t : threads )
+      t.join();
+   BOOST_TEST( popped == 40000 );
+   BOOST_TEST( q.size() == 0u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+#include <eosio/chain/lru_cache.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eosio;
+using namespace chain;
+
+BOOST_AUTO_TEST_SUITE(lru_cache_tests)
+
+BOOST_AUTO_TEST_CASE(disabled_test) {
+   lru_cache<std::string, std::string> cache;
+   BOOST_TEST( !cache.enabled() );
+   cache.put( "a", "1", 1 );
+   BOOST_TEST( !cache.get( "a" ) );
+   BOOST_TEST( cache.get_stats().entries == 0u );
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used_test) {
+   lru_cache<std::string, std::string> cache( 30 );
+   cache.put( "a", "1", 10 );
+   cache.put( "b", "2", 10 );
+   cache.put( "c", "3", 10 );
+   BOOST_TEST( cache.get_stats().bytes == 30u );
+
+   // a becomes the most recently used, b is evicted first
+   BOOST_REQUIRE( cache.get( "a" ) );
+   cache.put( "d", "4", 10 );
+   BOOST_TEST( !cache.get( "b" ) );
+   BOOST_TEST( *cache.get( "a" ) == "1" );
+   BOOST_TEST( *cache.get( "c" ) == "3" );
+   BOOST_TEST( *cache.get( "d" ) == "4" );
+
+   // evicts as many as needed to fit
+   cache.put( "e", "5", 25 );
+   BOOST_TEST( cache.get_stats().entries == 1u );
+   BOOST_TEST( cache.get_stats().bytes == 25u );
+   BOOST_TEST( *cache.get( "e" ) == "5" );
+
+   // larger than the budget is not cached
+   cache.put( "f", "6", 31 );
+   BOOST_TEST( !cache.get( "f" ) );
+   BOOST_TEST( *cache.get( "e" ) == "5" );
+}
+
+BOOST_AUTO_TEST_CASE(replace_test) {
+   lru_cache<std::string, std::string> cache( 30 );
+   cache.put( "a", "1", 10 );
+   cache.put( "a", "2", 20 );
+   const auto stats = cache.get_stats();
+   BOOST_TEST( stats.entries == 1u );
+   BOOST_TEST( stats.bytes == 20u );
+   BOOST_TEST( *cache.get( "a" ) == "2" );
+
+   cache.clear();
+   BOOST_TEST( !cache.get( "a" ) );
+   BOOST_TEST( cache.get_stats().bytes == 0u );
+}
+
+BOOST_AUTO_TEST_CASE(stats_test) {
+   lru_cache<std::string, std::string> cache( 100 );
+   cache.put( "a", "1", 1 );
+   cache.get( "a" );
+   cache.get( "a" );
+   cache.get( "b" );
+   const auto stats = cache.get_stats();
+   BOOST_TEST( stats.hits == 2u );
+   BOOST_TEST( stats.misses == 1u );
+   BOOST_TEST( stats.entries == 1u );
+   BOOST_TEST( stats.bytes == 1u );
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_test) {
+   lru_cache<int, int> cache( 64 );
+   std::atomic<bool> wrong_value = false;
+   std::vector<std::thread> threads;
+   for( int t = 0; t < 4; ++t ) {
+      threads.emplace_back( [&cache, &wrong_value, t]() {
+         for( int i = 0; i < 10000; ++i ) {
+            const int key = ( i * 7 + t ) % 100;
+            if( auto v = cache.get( key ) ) {
+               if( *v != key ) wrong_value = true;
+            } else {
+               cache.put( key, key, 1 );
+            }
+         }
+      } );
+   }
+   for( auto& t : threads )
+      t.join();
+   BOOST_TEST( !wrong_value );
+   const auto stats = cache.get_stats();
+   BOOST_TEST( stats.hits + stats.misses == 40000u );
+   BOOST_TEST( stats.bytes <= 64u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
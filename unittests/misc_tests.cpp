@@ -1,6 +1,8 @@
 #include <eosio/chain/asset.hpp>
 #include <eosio/chain/authority.hpp>
 #include <eosio/chain/authority_checker.hpp>
+#include <eosio/chain/merkle.hpp>
+#include <eosio/chain/sha256_batch.hpp>
 #include <eosio/chain/types.hpp>
 #include <eosio/chain/thread_utils.hpp>
 #include <eosio/testing/tester.hpp>
@@ -934,6 +936,25 @@ BOOST_AUTO_TEST_CASE(transaction_metadata_test) { try {
       BOOST_CHECK_EQUAL(1u, keys3.size());
       BOOST_CHECK_EQUAL(public_key, *keys3.begin());
 
+      // batch, more transactions than tasks; a transaction failing recovery only fails its own future
+      signed_transaction bad_trx = trx;
+      bad_trx.signatures.push_back( bad_trx.signatures.front() ); // duplicate signature
+      packed_transaction_ptr bad_ptrx = std::make_shared<packed_transaction>( bad_trx, packed_transaction::compression_type::none );
+      std::vector<packed_transaction_ptr> batch{ ptrx, ptrx2, bad_ptrx, ptrx, ptrx2 };
+      auto futs = transaction_metadata::start_recover_keys( batch, thread_pool.get_executor(), 2, test.control->get_chain_id(), fc::microseconds::maximum(), transaction_metadata::trx_type::input );
+      BOOST_REQUIRE_EQUAL(batch.size(), futs.size());
+      for( size_t i = 0; i < futs.size(); ++i ) {
+         if( i == 2 ) {
+            BOOST_CHECK_THROW( futs[i].get(), tx_duplicate_sig );
+            continue;
+         }
+         auto m = futs[i].get();
+         BOOST_CHECK_EQUAL(batch[i]->id(), m->id());
+         BOOST_CHECK_EQUAL(1u, m->recovered_keys().size());
+         BOOST_CHECK_EQUAL(public_key, *m->recovered_keys().begin());
+      }
+      BOOST_CHECK(transaction_metadata::start_recover_keys( std::vector<packed_transaction_ptr>{}, thread_pool.get_executor(), 2, test.control->get_chain_id(), fc::microseconds::maximum(), transaction_metadata::trx_type::input ).empty());
+
       thread_pool.stop();
 
 } FC_LOG_AND_RETHROW() }
@@ -1188,6 +1209,61 @@ BOOST_AUTO_TEST_CASE(stable_priority_queue_test) {
   } FC_LOG_AND_RETHROW()
 }
 
+// merkle_builder must produce the same root as merkle() for every size, including after truncation
+BOOST_AUTO_TEST_CASE(merkle_builder_test) {
+  try {
+     deque<digest_type> ids;
+     merkle_builder builder;
+     BOOST_CHECK_EQUAL( merkle( ids ), builder.root() );
+     for( uint32_t i = 0; i < 70; ++i ) {
+        ids.push_back( digest_type::hash( i ) );
+        builder.append( ids.back() );
+        BOOST_CHECK_EQUAL( builder.size(), ids.size() );
+        BOOST_CHECK_EQUAL( merkle( ids ), builder.root() );
+     }
+
+     for( size_t n : { 65, 64, 33, 7, 1, 0 } ) {
+        builder.truncate( n );
+        ids.resize( n );
+        BOOST_CHECK_EQUAL( builder.size(), n );
+        BOOST_CHECK_EQUAL( merkle( ids ), builder.root() );
+        for( uint32_t i = 0; i < 5; ++i ) {
+           ids.push_back( digest_type::hash( 1000 + i ) );
+           builder.append( ids.back() );
+           BOOST_CHECK_EQUAL( merkle( ids ), builder.root() );
+        }
+        builder.truncate( n );
+        ids.resize( n );
+     }
+
+  } FC_LOG_AND_RETHROW()
+}
+
+// every supported sha256_batch implementation must match fc::sha256, across padding boundaries
+BOOST_AUTO_TEST_CASE(sha256_batch_test) {
+  try {
+     vector<string> msgs;
+     for( size_t len = 0; len < 200; ++len ) {
+        string m( len, '\0' );
+        for( size_t i = 0; i < len; ++i ) m[i] = char( i * 31 + len );
+        msgs.push_back( std::move( m ) );
+     }
+     vector<sha256_batch_input> inputs;
+     for( const auto& m : msgs ) inputs.push_back( { m.data(), m.size() } );
+
+     for( auto impl : { sha256_batch_impl::scalar, sha256_batch_impl::avx2, sha256_batch_impl::sha_ni } ) {
+        if( !sha256_batch_supported( impl ) ) continue;
+        BOOST_TEST_MESSAGE( "testing " << to_string( impl ) );
+        vector<fc::sha256> out( inputs.size() );
+        sha256_batch( inputs.data(), inputs.size(), out.data(), impl );
+        for( size_t i = 0; i < msgs.size(); ++i ) {
+           BOOST_CHECK_EQUAL( fc::sha256::hash( msgs[i].data(), msgs[i].size() ), out[i] );
+        }
+     }
+
+  } FC_LOG_AND_RETHROW()
+}
+
 // test that std::bad_alloc is being thrown
 BOOST_AUTO_TEST_CASE(bad_alloc_test) {
    tester t; // force a controller to be constructed and set the new_handler
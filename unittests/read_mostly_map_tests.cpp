@@ -0,0 +1,101 @@
+#include <eosio/chain/read_mostly_map.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eosio;
+using namespace chain;
+
+BOOST_AUTO_TEST_SUITE(read_mostly_map_tests)
+
+BOOST_AUTO_TEST_CASE(insert_find_erase_test) {
+   read_mostly_map<std::string, std::string> m;
+   BOOST_TEST( !m.find( "a" ) );
+   BOOST_TEST( m.emplace( "a", "1" ) == "1" );
+   m.emplace( "b", "2" );
+   BOOST_TEST( m.size() == 2u );
+   BOOST_TEST( *m.find( "a" ) == "1" );
+   BOOST_TEST( *m.find( "b" ) == "2" );
+
+   // replace
+   m.emplace( "a", "3" );
+   BOOST_TEST( m.size() == 2u );
+   BOOST_TEST( *m.find( "a" ) == "3" );
+
+   BOOST_TEST( m.erase( "a" ) );
+   BOOST_TEST( !m.erase( "a" ) );
+   BOOST_TEST( !m.find( "a" ) );
+   BOOST_TEST( *m.find( "b" ) == "2" );
+   BOOST_TEST( m.size() == 1u );
+
+   std::string found;
+   BOOST_TEST( m.find( "b", [&]( const std::string& v ) { found = v; } ) );
+   BOOST_TEST( found == "2" );
+}
+
+BOOST_AUTO_TEST_CASE(values_do_not_move_test) {
+   // same hash for every key, so erase copies the nodes in front of the erased one
+   struct same_hash {
+      size_t operator()( int ) const { return 0; }
+   };
+   read_mostly_map<int, int, same_hash> m;
+   std::vector<const int*> values;
+   for( int i = 0; i < 10; ++i )
+      values.push_back( &m.emplace( i, i ) );
+   BOOST_TEST( m.erase( 3 ) );
+   for( int i = 0; i < 10; ++i ) {
+      if( i == 3 ) continue;
+      BOOST_TEST( m.find( i ) == values[i] );
+   }
+
+   // growing keeps the values too
+   read_mostly_map<int, int> grown;
+   const int* first = &grown.emplace( 0, 0 );
+   for( int i = 1; i < 1000; ++i )
+      grown.emplace( i, i );
+   BOOST_TEST( grown.find( 0 ) == first );
+   size_t count = 0;
+   grown.for_each( [&]( int k, int v ) { if( k == v ) ++count; } );
+   BOOST_TEST( count == 1000u );
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_test) {
+   read_mostly_map<int, int> m;
+   for( int i = 0; i < 100; i += 2 )
+      m.emplace( i, i );
+
+   // even keys are never erased, odd keys come and go
+   std::atomic<bool> done = false;
+   std::atomic<bool> wrong_value = false;
+   std::vector<std::thread> readers;
+   for( int t = 0; t < 4; ++t ) {
+      readers.emplace_back( [&]() {
+         while( !done ) {
+            for( int i = 0; i < 100; ++i ) {
+               const int* v = m.find( i, [&]( const int& v ) { if( v != i ) wrong_value = true; } );
+               if( i % 2 == 0 && !v ) wrong_value = true;
+            }
+         }
+      } );
+   }
+   for( int round = 0; round < 200; ++round ) {
+      for( int i = 1; i < 100; i += 2 )
+         m.emplace( i, i );
+      for( int i = 1; i < 100; i += 2 )
+         m.erase( i );
+      for( int i = 100; i < 100 + round; ++i ) // grows
+         m.emplace( i * 2, i * 2 );
+   }
+   done = true;
+   for( auto& t : readers )
+      t.join();
+   m.reclaim();
+   BOOST_TEST( !wrong_value );
+   BOOST_TEST( m.size() == 50u + 199u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,56 @@
+#include <eosio/chain/recovered_key_cache.hpp>
+
+#include <fc/crypto/private_key.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace eosio;
+using namespace chain;
+
+BOOST_AUTO_TEST_SUITE(recovered_key_cache_tests)
+
+BOOST_AUTO_TEST_CASE(recover_test) {
+   recovered_key_cache cache( 1024 );
+   const private_key_type priv = private_key_type::generate();
+   const digest_type digest = digest_type::hash( std::string( "message" ) );
+   const signature_type sig = priv.sign( digest );
+
+   BOOST_TEST( !cache.find( sig, digest ) );
+   BOOST_TEST( cache.recover( sig, digest ) == priv.get_public_key() );
+   BOOST_TEST( cache.size() == 1u );
+   BOOST_TEST( cache.find( sig, digest ).value() == priv.get_public_key() );
+   BOOST_TEST( cache.recover( sig, digest ) == priv.get_public_key() );
+   BOOST_TEST( cache.size() == 1u );
+
+   // a different digest recovers a different key
+   const digest_type other = digest_type::hash( std::string( "other" ) );
+   BOOST_TEST( !cache.find( sig, other ) );
+   BOOST_TEST( cache.recover( sig, other ) == public_key_type( sig, other ) );
+
+   // cached separately from the canonical check
+   BOOST_TEST( !cache.find( sig, digest, false ) );
+   BOOST_TEST( cache.recover( sig, digest, false ) == priv.get_public_key() );
+   BOOST_TEST( cache.size() == 3u );
+}
+
+BOOST_AUTO_TEST_CASE(bounded_test) {
+   recovered_key_cache cache( 64 );
+   const private_key_type priv = private_key_type::generate();
+   for( int i = 0; i < 500; ++i ) {
+      const digest_type digest = digest_type::hash( i );
+      BOOST_TEST( cache.recover( priv.sign( digest ), digest ) == priv.get_public_key() );
+      BOOST_TEST( cache.size() <= 64u );
+   }
+}
+
+BOOST_AUTO_TEST_CASE(disabled_test) {
+   recovered_key_cache cache( 0 );
+   const private_key_type priv = private_key_type::generate();
+   const digest_type digest = digest_type::hash( std::string( "message" ) );
+   const signature_type sig = priv.sign( digest );
+   BOOST_TEST( cache.recover( sig, digest ) == priv.get_public_key() );
+   BOOST_TEST( !cache.find( sig, digest ) );
+   BOOST_TEST( cache.size() == 0u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,82 @@
+#include <eosio/chain/token_bucket_limiter.hpp>
+#include <eosio/chain/name.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+using namespace eosio;
+using namespace chain;
+
+BOOST_AUTO_TEST_SUITE(token_bucket_limiter_tests)
+
+BOOST_AUTO_TEST_CASE(disabled_test) {
+   token_bucket_limiter<name> limiter;
+   BOOST_TEST( !limiter.enabled() );
+   const fc::time_point now = fc::time_point::now();
+   for( int i = 0; i < 1000; ++i ) {
+      BOOST_TEST( limiter.try_consume( "alice"_n, now ) );
+   }
+   BOOST_TEST( limiter.size() == 0u );
+}
+
+BOOST_AUTO_TEST_CASE(burst_and_refill_test) {
+   token_bucket_limiter<name> limiter( 10, 5 );
+   const fc::time_point now = fc::time_point::now();
+
+   for( int i = 0; i < 5; ++i ) {
+      BOOST_TEST( limiter.try_consume( "alice"_n, now ) );
+   }
+   BOOST_TEST( !limiter.try_consume( "alice"_n, now ) );
+   // other keys have their own bucket
+   BOOST_TEST( limiter.try_consume( "bob"_n, now ) );
+
+   // 10 per second, 100ms refills one token
+   BOOST_TEST( limiter.try_consume( "alice"_n, now + fc::milliseconds( 100 ) ) );
+   BOOST_TEST( !limiter.try_consume( "alice"_n, now + fc::milliseconds( 100 ) ) );
+
+   // refill is capped at burst
+   const fc::time_point later = now + fc::seconds( 10 );
+   for( int i = 0; i < 5; ++i ) {
+      BOOST_TEST( limiter.try_consume( "alice"_n, later ) );
+   }
+   BOOST_TEST( !limiter.try_consume( "alice"_n, later ) );
+
+   BOOST_TEST( !limiter.try_consume( "carol"_n, now, 6 ) );
+   BOOST_TEST( limiter.try_consume( "carol"_n, now, 5 ) );
+}
+
+BOOST_AUTO_TEST_CASE(has_tokens_test) {
+   token_bucket_limiter<name> limiter( 10, 2 );
+   const fc::time_point now = fc::time_point::now();
+
+   // checking does not consume
+   for( int i = 0; i < 5; ++i ) {
+      BOOST_TEST( limiter.has_tokens( "alice"_n, now ) );
+   }
+   BOOST_TEST( limiter.size() == 0u );
+   BOOST_TEST( !limiter.has_tokens( "alice"_n, now, 3 ) );
+
+   BOOST_TEST( limiter.try_consume( "alice"_n, now ) );
+   BOOST_TEST( limiter.has_tokens( "alice"_n, now ) );
+   BOOST_TEST( limiter.try_consume( "alice"_n, now ) );
+   BOOST_TEST( !limiter.has_tokens( "alice"_n, now ) );
+   BOOST_TEST( limiter.has_tokens( "alice"_n, now + fc::milliseconds( 100 ) ) );
+}
+
+BOOST_AUTO_TEST_CASE(prune_test) {
+   token_bucket_limiter<std::string> limiter( 100, 100 );
+   const fc::time_point now = fc::time_point::now();
+   for( int i = 0; i < 5000; ++i ) {
+      BOOST_TEST( limiter.try_consume( std::to_string( i ), now ) );
+   }
+   BOOST_TEST( limiter.size() == 5000u );
+
+   // a single token takes 10ms to refill, afterwards the buckets are full and carry no state
+   limiter.prune( now + fc::milliseconds( 5 ) );
+   BOOST_TEST( limiter.size() == 5000u );
+   limiter.prune( now + fc::milliseconds( 20 ) );
+   BOOST_TEST( limiter.size() == 0u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
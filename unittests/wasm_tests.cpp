@@ -1483,6 +1483,34 @@ BOOST_FIXTURE_TEST_CASE( mem_growth_memset, TESTER ) try {
    }
 } FC_LOG_AND_RETHROW()
 
+// memory grown and dirtied by one execution must read as zero in the next one, whichever way it is reset
+BOOST_FIXTURE_TEST_CASE( mem_growth_reset, TESTER ) try {
+   produce_blocks(2);
+
+   // below and above the footprint eos-vm-oc clears with memset
+   const std::vector<std::pair<name, uint32_t>> growers = { {"growsmall"_n, 2}, {"growlarge"_n, 40} };
+   for( const auto& [account, pages] : growers ) {
+      create_accounts( {account} );
+      set_code( account, fc::format_string(memory_growth_dirty, fc::mutable_variant_object()("PAGES", pages)).c_str() );
+   }
+   produce_block();
+
+   for( int i = 0; i < 3; ++i ) {
+      for( const auto& [account, pages] : growers ) {
+         signed_transaction trx;
+         action act;
+         act.account = account;
+         act.name = ""_n;
+         act.authorization = vector<permission_level>{{account,config::active_name}};
+         trx.actions.push_back(act);
+         set_transaction_headers(trx);
+         trx.sign(get_private_key( account, "active" ), control->get_chain_id());
+         push_transaction(trx);
+         produce_block();
+      }
+   }
+} FC_LOG_AND_RETHROW()
+
 INCBIN(fuzz1, "fuzz1.wasm");
 INCBIN(fuzz2, "fuzz2.wasm");
 INCBIN(fuzz3, "fuzz3.wasm");
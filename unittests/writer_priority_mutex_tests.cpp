@@ -0,0 +1,170 @@
+#include <eosio/chain/writer_priority_mutex.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+using namespace eosio::chain;
+
+BOOST_AUTO_TEST_SUITE(writer_priority_mutex_tests)
+
+BOOST_AUTO_TEST_CASE(reentrant_writer) {
+   writer_priority_mutex m;
+   std::unique_lock<writer_priority_mutex> w( m );
+   {
+      // the writer thread may lock again, both ways
+      std::lock_guard<writer_priority_mutex> w2( m );
+      std::shared_lock<writer_priority_mutex> r( m );
+   }
+
+   std::thread t( [&]() {
+      BOOST_CHECK( !m.try_lock_shared() );
+      BOOST_CHECK( !m.try_lock() );
+   } );
+   t.join();
+
+   w.unlock();
+   std::thread t2( [&]() {
+      BOOST_CHECK( m.try_lock_shared() );
+      m.unlock_shared();
+      BOOST_CHECK( m.try_lock() );
+      m.unlock();
+   } );
+   t2.join();
+}
+
+BOOST_AUTO_TEST_CASE(shared_readers) {
+   writer_priority_mutex m;
+   std::shared_lock<writer_priority_mutex> r( m );
+   std::thread t( [&]() {
+      BOOST_CHECK( m.try_lock_shared() );
+      m.unlock_shared();
+      BOOST_CHECK( !m.try_lock() );
+   } );
+   t.join();
+}
+
+BOOST_AUTO_TEST_CASE(waiting_writer_blocks_new_readers) {
+   writer_priority_mutex m;
+   std::shared_lock<writer_priority_mutex> r( m );
+
+   std::atomic<bool> written = false;
+   std::thread writer( [&]() {
+      std::lock_guard<writer_priority_mutex> w( m );
+      written = true;
+   } );
+   // wait for the writer to queue up behind the reader
+   while( true ) {
+      bool blocked = false;
+      std::thread probe( [&]() {
+         blocked = !m.try_lock_shared();
+         if( !blocked ) m.unlock_shared();
+      } );
+      probe.join();
+      if( blocked ) break;
+      std::this_thread::yield();
+   }
+   BOOST_CHECK( !written );
+   r.unlock();
+   writer.join();
+   BOOST_CHECK( written );
+}
+
+BOOST_AUTO_TEST_CASE(readers_hold_while_writer_waits) {
+   writer_priority_mutex m;
+   std::atomic<uint32_t> sequence = 0;
+   std::atomic<uint32_t> first_writer = 0, second_writer = 0, readers_in = 0, last_reader = 0;
+   std::atomic<bool> release_first_writer = false, release_readers = false;
+   // lets the threads started before it block in the mutex, the order checked below does not depend on it otherwise
+   auto settle = []() { std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) ); };
+
+   // readers hold the lock, a writer waits for them and keeps new readers out
+   std::shared_lock<writer_priority_mutex> r1( m );
+   std::thread writer1( [&]() {
+      std::lock_guard<writer_priority_mutex> w( m );
+      first_writer = ++sequence;
+      while( !release_first_writer ) std::this_thread::yield();
+   } );
+   settle();
+   std::shared_lock<writer_priority_mutex> r2( m, std::try_to_lock );
+   BOOST_CHECK( !r2.owns_lock() );
+   BOOST_CHECK( first_writer == 0u );
+   r1.unlock();
+   while( first_writer == 0 ) std::this_thread::yield();
+
+   // readers and a second writer queue up behind the first writer
+   const uint32_t reader_count = 32;
+   std::vector<std::thread> readers;
+   for( uint32_t i = 0; i < reader_count; ++i ) {
+      readers.emplace_back( [&]() {
+         std::shared_lock<writer_priority_mutex> r( m );
+         last_reader = ++sequence;
+         ++readers_in;
+         while( !release_readers ) std::this_thread::yield();
+      } );
+   }
+   settle();
+   std::thread writer2( [&]() {
+      std::lock_guard<writer_priority_mutex> w( m );
+      second_writer = ++sequence;
+   } );
+   settle();
+
+   // the waiting readers go before the second writer, and readers arriving meanwhile do not take their places
+   release_first_writer = true;
+   bool new_reader_in = false;
+   while( readers_in < reader_count ) {
+      if( m.try_lock_shared() ) {
+         new_reader_in = true;
+         m.unlock_shared();
+      }
+   }
+   BOOST_CHECK( !new_reader_in );
+   BOOST_CHECK( second_writer == 0u );
+   release_readers = true;
+
+   writer1.join();
+   for( auto& t : readers )
+      t.join();
+   writer2.join();
+   BOOST_CHECK( first_writer == 1u );
+   BOOST_CHECK( last_reader == 1u + reader_count );
+   BOOST_CHECK( second_writer == 2u + reader_count );
+}
+
+BOOST_AUTO_TEST_CASE(no_starvation) {
+   writer_priority_mutex m;
+   std::atomic<bool> done = false;
+   std::atomic<uint32_t> reads = 0;
+   std::atomic<bool> torn = false;
+   uint64_t value = 0;
+
+   std::vector<std::thread> readers;
+   for( int i = 0; i < 4; ++i ) {
+      readers.emplace_back( [&]() {
+         while( !done ) {
+            std::shared_lock<writer_priority_mutex> r( m );
+            if( value % 2 != 0 ) torn = true;
+            ++reads;
+         }
+      } );
+   }
+
+   // a writer locking back to back still lets the readers in, and the readers do not keep it out
+   for( int i = 0; i < 10000 || reads < 100; ++i ) {
+      std::lock_guard<writer_priority_mutex> w( m );
+      ++value;
+      ++value;
+   }
+   done = true;
+   for( auto& t : readers )
+      t.join();
+   BOOST_CHECK( !torn );
+   BOOST_CHECK( reads >= 100u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()